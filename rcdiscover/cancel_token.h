@@ -0,0 +1,80 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef RCDISCOVER_CANCEL_TOKEN_H
+#define RCDISCOVER_CANCEL_TOKEN_H
+
+#include <atomic>
+
+namespace rcdiscover
+{
+
+/**
+ * @brief Flag for cancelling a long running operation from another thread.
+ *
+ * The token is shared between the thread that cancels and the objects that
+ * check it, e.g. via Discover::setCancelToken() and
+ * Pinger::setCancelToken(). Once cancelled, it cannot be reset.
+ */
+class CancelToken
+{
+  public:
+    CancelToken() : cancelled_(false) { }
+
+    CancelToken(const CancelToken &) = delete;
+    CancelToken &operator=(const CancelToken &) = delete;
+
+    /**
+     * @brief Requests cancellation.
+     */
+    void cancel() { cancelled_.store(true, std::memory_order_release); }
+
+    /**
+     * @brief Returns whether cancellation has been requested.
+     * @return true if cancelled
+     */
+    bool isCancelled() const
+    {
+      return cancelled_.load(std::memory_order_acquire);
+    }
+
+  private:
+    std::atomic<bool> cancelled_;
+};
+
+}
+
+#endif // RCDISCOVER_CANCEL_TOKEN_H
@@ -0,0 +1,231 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "continuous_discover.h"
+
+#include "discover.h"
+#include "device_filter.h"
+#include "iface_affinity.h"
+#include "socket_exception.h"
+#include "metrics.h"
+#include "trace.h"
+
+#include <algorithm>
+
+namespace rcdiscover
+{
+
+ContinuousDiscover::ContinuousDiscover(const InterfaceSelection &selection) :
+  selection_(selection),
+  discover_(new Discover(selection_)),
+  opened_(std::chrono::steady_clock::now()),
+  interval_(1000),
+  timeout_(100),
+  reopen_interval_(60),
+  reprobe_(true),
+  stop_(false)
+{ }
+
+ContinuousDiscover::~ContinuousDiscover()
+{ }
+
+void ContinuousDiscover::setInterval(std::chrono::milliseconds interval)
+{
+  interval_ = interval;
+}
+
+void ContinuousDiscover::setResponseTimeout(int timeout_per_socket)
+{
+  timeout_ = timeout_per_socket;
+}
+
+void ContinuousDiscover::setReopenInterval(std::chrono::seconds interval)
+{
+  reopen_interval_ = interval;
+}
+
+void ContinuousDiscover::setReprobe(bool reprobe)
+{
+  reprobe_ = reprobe;
+}
+
+void ContinuousDiscover::setKnownDevices(const std::vector<DeviceInfo> &devices)
+{
+  known_ = devices;
+}
+
+void ContinuousDiscover::setFilter(std::shared_ptr<const DeviceFilter> filter)
+{
+  filter_ = std::move(filter);
+  discover_->setFilter(filter_);
+}
+
+std::vector<DeviceInfo> ContinuousDiscover::scan()
+{
+  const auto start = std::chrono::steady_clock::now();
+
+  std::vector<DeviceInfo> infos;
+
+  try
+  {
+    infos = scanRound();
+  }
+  catch(...)
+  {
+    Metrics::recordScan(std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start), false);
+    throw;
+  }
+
+  Metrics::recordScan(std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now() - start), true);
+  Metrics::recordInterfaces(discover_->getStatistics(), infos);
+
+  return infos;
+}
+
+std::vector<DeviceInfo> ContinuousDiscover::scanRound()
+{
+  const auto now = std::chrono::steady_clock::now();
+  if (now - opened_ >= reopen_interval_)
+  {
+    discover_.reset();
+    discover_.reset(new Discover(selection_));
+    discover_->setFilter(filter_);
+    opened_ = now;
+  }
+
+  std::vector<DeviceInfo> infos;
+
+  discover_->resetStatistics();
+
+  // a failing interface must not prevent discovery on the others
+
+  if (discover_->tryBroadcastRequest(&status_) == 0)
+  {
+    for (const auto &st : status_)
+    {
+      if (st.error && st.error != std::errc::network_unreachable)
+      {
+        throw SocketException("Error while sending data", st.error.value());
+      }
+    }
+  }
+
+  // second chance for devices whose acknowledge has been lost: they are
+  // re-probed when the burst of broadcast responses has ended, and both
+  // are received within the same response timeout
+
+  if (reprobe_ && !known_.empty())
+  {
+    const int burst_timeout = std::max(timeout_/4, 1);
+
+    while (discover_->getResponse(infos, burst_timeout)) { }
+
+    discover_->reprobeMissing(known_, infos);
+
+    while (discover_->getResponse(infos, std::max(timeout_-burst_timeout, 1)))
+    { }
+  }
+  else
+  {
+    while (discover_->getResponse(infos, timeout_)) { }
+  }
+
+  {
+    RCDISCOVER_TRACE_SCOPE("dedup", infos.size());
+
+    infos.erase(std::remove_if(infos.begin(), infos.end(),
+                               [](const DeviceInfo &info)
+                               { return !info.isValid(); }),
+                infos.end());
+
+    std::sort(infos.begin(), infos.end());
+    infos.erase(std::unique(infos.begin(), infos.end()), infos.end());
+  }
+
+  known_ = infos;
+  IfaceAffinity::update(infos);
+
+  return infos;
+}
+
+const std::vector<IfaceStatus> &ContinuousDiscover::getInterfaceStatus() const
+{
+  return status_;
+}
+
+const std::vector<IfaceStats> &ContinuousDiscover::getStatistics() const
+{
+  return discover_->getStatistics();
+}
+
+void ContinuousDiscover::run(const Callback &callback)
+{
+  while (true)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      if (stop_)
+      {
+        break;
+      }
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    const auto infos = scan();
+
+    if (callback)
+    {
+      callback(infos);
+    }
+
+    std::unique_lock<std::mutex> lock(mtx_);
+    if (cv_.wait_until(lock, start + interval_, [this] { return stop_; }))
+    {
+      break;
+    }
+  }
+}
+
+void ContinuousDiscover::stop()
+{
+  std::lock_guard<std::mutex> lock(mtx_);
+  stop_ = true;
+  cv_.notify_all();
+}
+
+}
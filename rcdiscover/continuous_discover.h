@@ -0,0 +1,197 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RCDISCOVER_CONTINUOUS_DISCOVER_H
+#define RCDISCOVER_CONTINUOUS_DISCOVER_H
+
+#include "deviceinfo.h"
+#include "iface_status.h"
+#include "iface_stats.h"
+#include "iface_selection.h"
+
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+
+namespace rcdiscover
+{
+
+class Discover;
+class DeviceFilter;
+
+/**
+ * @brief Repeated discovery rounds that keep the sockets open between rounds.
+ *
+ * The sockets are recreated periodically, so that interfaces that come up
+ * later are used as well.
+ */
+class ContinuousDiscover
+{
+  public:
+    /**
+     * @brief Callback that receives the deduplicated, valid responses of one
+     * round, sorted by MAC address.
+     */
+    typedef std::function<void(const std::vector<DeviceInfo> &)> Callback;
+
+  public:
+    /**
+     * @brief Constructor. Opens the sockets.
+     *
+     * NOTE: Exceptions are thrown in case of severe network errors.
+     *
+     * @param selection interfaces that are used, by default all interfaces
+     */
+    explicit ContinuousDiscover(
+      const InterfaceSelection &selection = InterfaceSelection());
+    ~ContinuousDiscover();
+
+    ContinuousDiscover(const ContinuousDiscover &) = delete;
+    ContinuousDiscover &operator=(const ContinuousDiscover &) = delete;
+
+    /**
+     * @brief Sets the time between the start of two rounds in run(). The
+     * default is 1 s.
+     * @param interval scan interval
+     */
+    void setInterval(std::chrono::milliseconds interval);
+
+    /**
+     * @brief Sets the time for waiting for further responses on each socket.
+     * A round ends if no socket received a response within this time. The
+     * default is 100 ms.
+     * @param timeout_per_socket timeout in milliseconds
+     */
+    void setResponseTimeout(int timeout_per_socket);
+
+    /**
+     * @brief Sets the time after which the sockets are recreated. The
+     * default is 60 s.
+     * @param interval reopen interval
+     */
+    void setReopenInterval(std::chrono::seconds interval);
+
+    /**
+     * @brief Enables or disables unicast requests to devices of the previous
+     * round that did not answer the broadcast (see
+     * Discover::reprobeMissing()). They are sent as soon as no response has
+     * arrived for a quarter of the response timeout, so that their answers
+     * are received within the same response timeout as the broadcast. It is
+     * enabled by default.
+     * @param reprobe true for enabling
+     */
+    void setReprobe(bool reprobe);
+
+    /**
+     * @brief Sets the devices that are expected in the next round, e.g. from
+     * a cache. Afterwards, the result of each round is used.
+     * @param devices expected devices
+     */
+    void setKnownDevices(const std::vector<DeviceInfo> &devices);
+
+    /**
+     * @brief Sets a filter that is applied to all responses before decoding
+     * (see Discover::setFilter()). Only matching devices are returned.
+     * @param filter filter, or null pointer for all devices
+     */
+    void setFilter(std::shared_ptr<const DeviceFilter> filter);
+
+    /**
+     * @brief Performs one discovery round. Interfaces on which the request
+     * cannot be sent are skipped and reported by getInterfaceStatus(). The
+     * duration and the counters of the round are recorded in Metrics.
+     *
+     * NOTE: An exception is thrown if the request could not be sent on any
+     * interface due to other reasons than an unreachable network.
+     *
+     * @return deduplicated, valid responses sorted by MAC address
+     */
+    std::vector<DeviceInfo> scan();
+
+    /**
+     * @brief Returns the send result of each interface of the last round.
+     * @return status of each interface
+     */
+    const std::vector<IfaceStatus> &getInterfaceStatus() const;
+
+    /**
+     * @brief Returns the counters of each interface of the last round.
+     * @return counters of each interface
+     */
+    const std::vector<IfaceStats> &getStatistics() const;
+
+    /**
+     * @brief Performs discovery rounds until stop() is called.
+     * @param callback callback for the result of each round
+     */
+    void run(const Callback &callback);
+
+    /**
+     * @brief Lets run() return after the current round, or immediately if it
+     * is called later. May be called from any thread.
+     */
+    void stop();
+
+  private:
+    /**
+     * @brief Performs one discovery round without recording metrics.
+     * @return deduplicated, valid responses sorted by MAC address
+     */
+    std::vector<DeviceInfo> scanRound();
+
+  private:
+    const InterfaceSelection selection_;
+    std::unique_ptr<Discover> discover_;
+    std::chrono::steady_clock::time_point opened_;
+
+    std::chrono::milliseconds interval_;
+    int timeout_;
+    std::chrono::seconds reopen_interval_;
+    bool reprobe_;
+    std::vector<DeviceInfo> known_;
+    std::shared_ptr<const DeviceFilter> filter_;
+    std::vector<IfaceStatus> status_;
+
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    bool stop_;
+};
+
+}
+
+#endif // RCDISCOVER_CONTINUOUS_DISCOVER_H
@@ -0,0 +1,531 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "daemon_protocol.h"
+
+#include "socket_exception.h"
+#include "utils.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+
+#include <sstream>
+#include <stdexcept>
+#include <cstdlib>
+
+namespace rcdiscover
+{
+
+const char * const DAEMON_SYSTEM_SOCKET = "/run/rcdiscoverd/rcdiscoverd.sock";
+
+namespace
+{
+
+/*
+  Connects to the UNIX domain socket. Returns -1 and leaves errno set if
+  there is no daemon listening.
+*/
+
+int connectSocket(const std::string &path)
+{
+  sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+
+  if (path.size() >= sizeof(addr.sun_path))
+  {
+    throw std::invalid_argument("Socket path too long: " + path);
+  }
+
+  strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path)-1);
+
+  const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd == -1)
+  {
+    throw SocketException("Error while creating socket", errno);
+  }
+
+  if (::connect(fd, reinterpret_cast<const sockaddr *>(&addr),
+                sizeof(addr)) == -1)
+  {
+    const int err = errno;
+    ::close(fd);
+    errno = err;
+    return -1;
+  }
+
+  return fd;
+}
+
+std::string escape(const std::string &s)
+{
+  std::string ret;
+  ret.reserve(s.size());
+
+  for (const char c : s)
+  {
+    switch (c)
+    {
+      case '\\': ret += "\\\\"; break;
+      case '\t': ret += "\\t"; break;
+      case '\n': ret += "\\n"; break;
+      case '\r': ret += "\\r"; break;
+      default: ret += c; break;
+    }
+  }
+
+  return ret;
+}
+
+std::string unescape(const std::string &s)
+{
+  std::string ret;
+  ret.reserve(s.size());
+
+  for (size_t i = 0; i < s.size(); ++i)
+  {
+    if (s[i] == '\\' && i+1 < s.size())
+    {
+      ++i;
+      switch (s[i])
+      {
+        case 't': ret += '\t'; break;
+        case 'n': ret += '\n'; break;
+        case 'r': ret += '\r'; break;
+        default: ret += s[i]; break;
+      }
+    }
+    else
+    {
+      ret += s[i];
+    }
+  }
+
+  return ret;
+}
+
+bool parseIP(const std::string &s, uint32_t &ip)
+{
+  try
+  {
+    const auto b = string2ip(s);
+
+    ip = 0;
+    for (const uint8_t v : b)
+    {
+      ip = (ip << 8) | v;
+    }
+  }
+  catch(const std::exception &)
+  {
+    return false;
+  }
+
+  return true;
+}
+
+struct EventField
+{
+  FleetEvent::Field field;
+  const char *name;
+};
+
+const EventField EVENT_FIELDS[] =
+{
+  { FleetEvent::IP, "ip" },
+  { FleetEvent::SUBNET, "subnet" },
+  { FleetEvent::GATEWAY, "gateway" },
+  { FleetEvent::USER_NAME, "name" }
+};
+
+}
+
+std::string formatDeviceRecord(const DeviceInfo &info)
+{
+  std::ostringstream out;
+
+  out << mac2string(info.getMAC()) << '\t'
+      << ip2string(info.getIP()) << '\t'
+      << ip2string(info.getSubnetMask()) << '\t'
+      << ip2string(info.getGateway()) << '\t'
+      << escape(info.getSerialNumber()) << '\t'
+      << escape(info.getUserName()) << '\t'
+      << escape(info.getModelName()) << '\t'
+      << escape(info.getManufacturerName()) << '\t'
+      << escape(info.getDeviceVersion()) << '\t'
+      << escape(info.getManufacturerInfo()) << '\t'
+      << info.getMajorVersion() << '.' << info.getMinorVersion() << '\t'
+      << escape(info.getIfaceName());
+
+  return out.str();
+}
+
+bool parseDeviceRecord(const std::string &line, DeviceInfo &info)
+{
+  std::vector<std::string> fields;
+
+  size_t start = 0;
+  while (true)
+  {
+    const size_t end = line.find('\t', start);
+    fields.push_back(line.substr(start, end == std::string::npos ?
+                                        std::string::npos : end - start));
+
+    if (end == std::string::npos)
+    {
+      break;
+    }
+
+    start = end + 1;
+  }
+
+  if (fields.size() != 12)
+  {
+    return false;
+  }
+
+  info.clear();
+
+  try
+  {
+    const auto mac = string2mac(fields[0]);
+
+    uint64_t m = 0;
+    for (const uint8_t v : mac)
+    {
+      m = (m << 8) | v;
+    }
+    info.setMAC(m);
+
+    const size_t dot = fields[10].find('.');
+    if (dot == std::string::npos)
+    {
+      return false;
+    }
+    info.setVersion(std::stoi(fields[10].substr(0, dot)),
+                    std::stoi(fields[10].substr(dot+1)));
+  }
+  catch(const std::exception &)
+  {
+    return false;
+  }
+
+  uint32_t ip, subnet, gateway;
+  if (!parseIP(fields[1], ip) || !parseIP(fields[2], subnet) ||
+      !parseIP(fields[3], gateway))
+  {
+    return false;
+  }
+
+  info.setIP(ip);
+  info.setSubnetMask(subnet);
+  info.setGateway(gateway);
+  info.setSerialNumber(unescape(fields[4]));
+  info.setUserName(unescape(fields[5]));
+  info.setModelName(unescape(fields[6]));
+  info.setManufacturerName(unescape(fields[7]));
+  info.setDeviceVersion(unescape(fields[8]));
+  info.setManufacturerInfo(unescape(fields[9]));
+  info.setIfaceName(unescape(fields[11]));
+
+  return info.isValid();
+}
+
+std::string formatEventRecord(const FleetEvent &event)
+{
+  std::ostringstream out;
+
+  out << event.seq << '\t' << event.epoch << '\t';
+
+  switch (event.type)
+  {
+    case FleetEvent::APPEARED: out << "appeared"; break;
+    case FleetEvent::DISAPPEARED: out << "disappeared"; break;
+    case FleetEvent::CHANGED: out << "changed"; break;
+  }
+
+  out << '\t';
+
+  const char *sep = "";
+  for (const auto &f : EVENT_FIELDS)
+  {
+    if (event.changed & f.field)
+    {
+      out << sep << f.name;
+      sep = ",";
+    }
+  }
+
+  out << '\t' << formatDeviceRecord(event.info);
+
+  return out.str();
+}
+
+bool parseEventRecord(const std::string &line, FleetEvent &event)
+{
+  const size_t t0 = line.find('\t');
+  const size_t t1 = (t0 == std::string::npos) ? t0 : line.find('\t', t0+1);
+  const size_t t2 = (t1 == std::string::npos) ? t1 : line.find('\t', t1+1);
+  const size_t t3 = (t2 == std::string::npos) ? t2 : line.find('\t', t2+1);
+
+  if (t3 == std::string::npos)
+  {
+    return false;
+  }
+
+  try
+  {
+    event.seq = std::stoull(line.substr(0, t0));
+    event.epoch = std::stoull(line.substr(t0+1, t1-t0-1));
+  }
+  catch(const std::exception &)
+  {
+    return false;
+  }
+
+  const std::string type = line.substr(t1+1, t2-t1-1);
+  if (type == "appeared")
+  {
+    event.type = FleetEvent::APPEARED;
+  }
+  else if (type == "disappeared")
+  {
+    event.type = FleetEvent::DISAPPEARED;
+  }
+  else if (type == "changed")
+  {
+    event.type = FleetEvent::CHANGED;
+  }
+  else
+  {
+    return false;
+  }
+
+  event.changed = 0;
+
+  std::istringstream in(line.substr(t2+1, t3-t2-1));
+  std::string name;
+  while (std::getline(in, name, ','))
+  {
+    for (const auto &f : EVENT_FIELDS)
+    {
+      if (name == f.name)
+      {
+        event.changed |= f.field;
+      }
+    }
+  }
+
+  return parseDeviceRecord(line.substr(t3+1), event.info);
+}
+
+std::string getDaemonDefaultSocket()
+{
+  const char *dir = std::getenv("XDG_RUNTIME_DIR");
+
+  if (::geteuid() != 0 && dir != nullptr && dir[0] != '\0')
+  {
+    return std::string(dir) + "/rcdiscoverd.sock";
+  }
+
+  return DAEMON_SYSTEM_SOCKET;
+}
+
+DaemonClient::DaemonClient(const std::string &path) :
+  fd_(-1)
+{
+  std::string p = path.empty() ? getDaemonDefaultSocket() : path;
+  fd_ = connectSocket(p);
+
+  // without daemon of the user, the one of the system is asked
+
+  if (fd_ == -1 && path.empty() && errno == ENOENT &&
+      p != DAEMON_SYSTEM_SOCKET)
+  {
+    p = DAEMON_SYSTEM_SOCKET;
+    fd_ = connectSocket(p);
+  }
+
+  if (fd_ == -1)
+  {
+    throw SocketException("Cannot connect to rcdiscoverd at " + p, errno);
+  }
+}
+
+DaemonClient::~DaemonClient()
+{
+  if (fd_ != -1)
+  {
+    ::close(fd_);
+  }
+}
+
+std::vector<DeviceInfo> DaemonClient::query(const std::string &request)
+{
+  writeLine(request);
+
+  std::vector<DeviceInfo> ret;
+  std::string line;
+
+  while (true)
+  {
+    if (!readLine(line))
+    {
+      throw std::runtime_error("Connection to rcdiscoverd closed");
+    }
+
+    if (line.empty())
+    {
+      break;
+    }
+
+    if (line.compare(0, 6, "ERROR ") == 0)
+    {
+      std::string empty;
+      readLine(empty);
+      throw std::runtime_error(line.substr(6));
+    }
+
+    DeviceInfo info;
+    if (parseDeviceRecord(line, info))
+    {
+      ret.push_back(info);
+    }
+  }
+
+  return ret;
+}
+
+void DaemonClient::subscribe(
+    const std::function<bool(const FleetEvent &)> &callback, bool resume,
+    uint64_t seq, uint64_t epoch)
+{
+  if (resume && epoch != 0)
+  {
+    writeLine("subscribe " + std::to_string(seq) + " " +
+              std::to_string(epoch));
+  }
+  else if (resume)
+  {
+    writeLine("subscribe " + std::to_string(seq));
+  }
+  else
+  {
+    writeLine("subscribe");
+  }
+
+  std::string line;
+  while (true)
+  {
+    if (!readLine(line))
+    {
+      throw std::runtime_error("Connection to rcdiscoverd closed");
+    }
+
+    if (line.compare(0, 6, "ERROR ") == 0)
+    {
+      std::string empty;
+      readLine(empty);
+      throw std::runtime_error(line.substr(6));
+    }
+
+    FleetEvent event;
+    if (parseEventRecord(line, event) && !callback(event))
+    {
+      return;
+    }
+  }
+}
+
+void DaemonClient::writeLine(const std::string &line)
+{
+  const std::string data = line + "\n";
+
+  size_t sent = 0;
+  while (sent < data.size())
+  {
+    const ssize_t n = ::send(fd_, data.data() + sent, data.size() - sent,
+                             MSG_NOSIGNAL);
+    if (n == -1)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+
+      throw SocketException("Error while sending data", errno);
+    }
+
+    sent += static_cast<size_t>(n);
+  }
+}
+
+bool DaemonClient::readLine(std::string &line)
+{
+  while (true)
+  {
+    const size_t pos = buffer_.find('\n');
+    if (pos != std::string::npos)
+    {
+      line = buffer_.substr(0, pos);
+      buffer_.erase(0, pos+1);
+      return true;
+    }
+
+    char p[4096];
+    const ssize_t n = ::recv(fd_, p, sizeof(p), 0);
+    if (n == -1)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+
+      throw SocketException("Error while receiving data", errno);
+    }
+
+    if (n == 0)
+    {
+      return false;
+    }
+
+    buffer_.append(p, static_cast<size_t>(n));
+  }
+}
+
+}
@@ -0,0 +1,189 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RCDISCOVER_DAEMON_PROTOCOL_H
+#define RCDISCOVER_DAEMON_PROTOCOL_H
+
+#include "deviceinfo.h"
+#include "fleet.h"
+
+#include <string>
+#include <vector>
+#include <functional>
+
+namespace rcdiscover
+{
+
+/**
+ * @brief Path of the query socket of an rcdiscoverd that runs as root, e.g.
+ * as system service.
+ */
+extern const char * const DAEMON_SYSTEM_SOCKET;
+
+/**
+ * @brief Returns the default path of the query socket of rcdiscoverd.
+ *
+ * For other users than root, this is rcdiscoverd.sock in $XDG_RUNTIME_DIR,
+ * which is only accessible by the user. Otherwise, or if the variable is not
+ * set, it is DAEMON_SYSTEM_SOCKET.
+ * @return path
+ */
+std::string getDaemonDefaultSocket();
+
+/**
+ * @brief Converts a device into one line of the rcdiscoverd protocol
+ * (without newline).
+ *
+ * The tab separated fields are MAC, IP, subnet mask, gateway, serial number,
+ * user name, model name, manufacturer name, device version, manufacturer
+ * info, version (major.minor) and interface name. Tabs, newlines and
+ * backslashes in strings are escaped with a backslash.
+ * @param info device
+ * @return record
+ */
+std::string formatDeviceRecord(const DeviceInfo &info);
+
+/**
+ * @brief Converts one line of the rcdiscoverd protocol into a device.
+ * @param line record (without newline)
+ * @param info device that is filled
+ * @return false if the line is not a valid record
+ */
+bool parseDeviceRecord(const std::string &line, DeviceInfo &info);
+
+/**
+ * @brief Converts an event into one line of the rcdiscoverd protocol
+ * (without newline).
+ *
+ * The tab separated fields are the sequence number, the epoch of the event
+ * stream (see Fleet::getEpoch()), the type ("appeared",
+ * "disappeared" or "changed"), the comma separated list of changed fields
+ * ("ip", "subnet", "gateway", "name"; empty if not "changed"), followed by
+ * the fields of formatDeviceRecord().
+ * @param event event
+ * @return record
+ */
+std::string formatEventRecord(const FleetEvent &event);
+
+/**
+ * @brief Converts one line of the rcdiscoverd protocol into an event.
+ * @param line record (without newline)
+ * @param event event that is filled
+ * @return false if the line is not a valid record
+ */
+bool parseEventRecord(const std::string &line, FleetEvent &event);
+
+/**
+ * @brief Client for the query socket of rcdiscoverd.
+ *
+ * Requests are single lines: "list", "mac <xx:xx:xx:xx:xx:xx>",
+ * "serial <serial number>" or "name <user name>". The answer consists of one
+ * record per device, terminated by an empty line. "scan [<max age in ms>]"
+ * is answered like "list", but with the result of a discovery round that
+ * started at most the given time ago, which is the round in progress or a
+ * new one by default. In case of an error, the
+ * answer is a line starting with "ERROR ", also followed by an empty line.
+ *
+ * The request "subscribe [<seq> [<epoch>]]" turns the connection into an
+ * event stream with one event record per line (see formatEventRecord()).
+ * Without sequence number, only new events are sent. Otherwise, all events
+ * after the given sequence number are sent first. If these are not available
+ * anymore, the epoch differs from the one of the daemon (i.e. it has been
+ * restarted), or the client cannot keep up, the stream ends with an error
+ * and the client has to resynchronize with "list".
+ */
+class DaemonClient
+{
+  public:
+    /**
+     * @brief Constructor. Connects to the daemon.
+     * @param path path of the UNIX domain socket. If empty, the socket of
+     * getDaemonDefaultSocket() is used, or DAEMON_SYSTEM_SOCKET if the former
+     * does not exist.
+     * @throws SocketException if the daemon cannot be reached
+     */
+    explicit DaemonClient(const std::string &path = std::string());
+    ~DaemonClient();
+
+    DaemonClient(const DaemonClient &) = delete;
+    DaemonClient &operator=(const DaemonClient &) = delete;
+
+    /**
+     * @brief Sends a request and returns the devices of the answer.
+     * @param request request line (without newline)
+     * @return devices
+     * @throws std::runtime_error if the daemon reports an error or closes
+     * the connection
+     */
+    std::vector<DeviceInfo> query(const std::string &request);
+
+    /**
+     * @brief Subscribes to change events and calls the callback for every
+     * event until the callback returns false. Afterwards, the connection
+     * cannot be used for other requests.
+     * @param callback callback
+     * @param resume true for resuming after seq, false for new events only
+     * @param seq sequence number of the last event known to the caller
+     * @param epoch epoch of the last event known to the caller, 0 if
+     * unknown
+     * @throws std::runtime_error if events have been lost or the daemon
+     * closes the connection
+     */
+    void subscribe(const std::function<bool(const FleetEvent &)> &callback,
+                   bool resume = false, uint64_t seq = 0,
+                   uint64_t epoch = 0);
+
+  protected:
+    /**
+     * @brief Sends one line.
+     * @param line line without newline
+     */
+    void writeLine(const std::string &line);
+
+    /**
+     * @brief Reads one line.
+     * @param line line without newline
+     * @return false if the connection has been closed
+     */
+    bool readLine(std::string &line);
+
+  private:
+    int fd_;
+    std::string buffer_;
+};
+
+}
+
+#endif // RCDISCOVER_DAEMON_PROTOCOL_H
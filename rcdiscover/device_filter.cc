@@ -0,0 +1,264 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "device_filter.h"
+#include "utils.h"
+
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+
+namespace rcdiscover
+{
+
+namespace
+{
+
+/*
+  Offsets and lengths of the fields in the discovery acknowledge, as decoded
+  by DeviceInfo::set().
+*/
+
+const size_t MAC_OFFSET = 10;
+const size_t IP_OFFSET = 36;
+const size_t MODEL_OFFSET = 104;
+const size_t MODEL_LEN = 32;
+const size_t SERIAL_OFFSET = 216;
+const size_t SERIAL_LEN = 16;
+const size_t NAME_OFFSET = 232;
+const size_t NAME_LEN = 16;
+const size_t ACK_LEN = 248;
+
+/*
+  Parses a number of the given base that consists of 1 to max_digits digits.
+*/
+
+bool parseNumber(const std::string &s, int base, size_t max_digits,
+                 unsigned long max_value, unsigned long &value)
+{
+  const char *digits = base == 16 ? "0123456789abcdefABCDEF" : "0123456789";
+
+  if (s.empty() || s.size() > max_digits ||
+      s.find_first_not_of(digits) != std::string::npos)
+  {
+    return false;
+  }
+
+  value = std::stoul(s, nullptr, base);
+  return value <= max_value;
+}
+
+/*
+  Copies a string into a zero padded field of the acknowledge.
+*/
+
+void putString(uint8_t *raw, size_t offset, size_t field_len,
+               const std::string &s)
+{
+  std::memcpy(raw+offset, s.data(), std::min(s.size(), field_len));
+}
+
+}
+
+void DeviceFilter::addSerialNumber(const std::string &serial)
+{
+  addString(SERIAL, SERIAL_OFFSET, SERIAL_LEN, serial);
+}
+
+void DeviceFilter::addMACPrefix(const std::string &prefix)
+{
+  Term term;
+  term.offset = MAC_OFFSET;
+
+  std::istringstream in(prefix);
+  std::string b;
+  while (std::getline(in, b, ':'))
+  {
+    unsigned long v;
+    if (term.value.size() >= 6 || !parseNumber(b, 16, 2, 0xff, v))
+    {
+      throw std::invalid_argument("Invalid MAC prefix: " + prefix);
+    }
+
+    term.value.push_back(static_cast<uint8_t>(v));
+  }
+
+  if (term.value.empty() || prefix.back() == ':')
+  {
+    throw std::invalid_argument("Invalid MAC prefix: " + prefix);
+  }
+
+  term.mask.assign(term.value.size(), 0xff);
+
+  groups_[MAC].active = true;
+  groups_[MAC].terms.push_back(term);
+}
+
+void DeviceFilter::addModelName(const std::string &model)
+{
+  addString(MODEL, MODEL_OFFSET, MODEL_LEN, model);
+}
+
+void DeviceFilter::addUserName(const std::string &name)
+{
+  addString(NAME, NAME_OFFSET, NAME_LEN, name);
+}
+
+void DeviceFilter::addSubnet(const std::string &subnet)
+{
+  uint32_t net, mask;
+  if (!string2subnet(subnet, net, mask))
+  {
+    throw std::invalid_argument("Invalid subnet: " + subnet);
+  }
+
+  Term term;
+  term.offset = IP_OFFSET;
+
+  for (int i = 3; i >= 0; i--)
+  {
+    term.value.push_back(static_cast<uint8_t>(net >> (8*i)));
+    term.mask.push_back(static_cast<uint8_t>(mask >> (8*i)));
+  }
+
+  groups_[SUBNET].active = true;
+  groups_[SUBNET].terms.push_back(term);
+}
+
+bool DeviceFilter::empty() const
+{
+  for (const Group &group : groups_)
+  {
+    if (group.active)
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool DeviceFilter::matches(const uint8_t *raw, size_t len) const
+{
+  for (const Group &group : groups_)
+  {
+    if (!group.active)
+    {
+      continue;
+    }
+
+    bool found = false;
+    for (size_t t = 0; t < group.terms.size() && !found; t++)
+    {
+      const Term &term = group.terms[t];
+
+      if (term.offset+term.value.size() > len)
+      {
+        continue;
+      }
+
+      const uint8_t *p = raw+term.offset;
+
+      found = true;
+      for (size_t i = 0; i < term.value.size() && found; i++)
+      {
+        found = (p[i] & term.mask[i]) == term.value[i];
+      }
+    }
+
+    if (!found)
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool DeviceFilter::matches(const DeviceInfo &info) const
+{
+  // encode the fields that can be compared into an acknowledge
+
+  uint8_t raw[ACK_LEN];
+  std::memset(raw, 0, sizeof(raw));
+
+  for (int i = 0; i < 6; i++)
+  {
+    raw[MAC_OFFSET+i] = static_cast<uint8_t>(info.getMAC() >> (8*(5-i)));
+  }
+
+  for (int i = 0; i < 4; i++)
+  {
+    raw[IP_OFFSET+i] = static_cast<uint8_t>(info.getIP() >> (8*(3-i)));
+  }
+
+  putString(raw, MODEL_OFFSET, MODEL_LEN, info.getModelName());
+  putString(raw, SERIAL_OFFSET, SERIAL_LEN, info.getSerialNumber());
+  putString(raw, NAME_OFFSET, NAME_LEN, info.getUserName());
+
+  return matches(raw, sizeof(raw));
+}
+
+void DeviceFilter::addString(int group, size_t offset, size_t field_len,
+                             const std::string &s)
+{
+  groups_[group].active = true;
+
+  // a string that does not fit into the field can never match
+
+  if (s.size() > field_len || s.find('\0') != std::string::npos)
+  {
+    return;
+  }
+
+  // compare including the terminating null byte, unless the field is full
+
+  Term term;
+  term.offset = offset;
+  term.value.assign(s.begin(), s.end());
+
+  if (s.size() < field_len)
+  {
+    term.value.push_back(0);
+  }
+
+  term.mask.assign(term.value.size(), 0xff);
+
+  groups_[group].terms.push_back(term);
+}
+
+}
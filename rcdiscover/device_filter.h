@@ -0,0 +1,152 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef RCDISCOVER_DEVICE_FILTER_H
+#define RCDISCOVER_DEVICE_FILTER_H
+
+#include "deviceinfo.h"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace rcdiscover
+{
+
+/**
+ * @brief Selection of devices by serial number, MAC prefix, model name, user
+ * name and subnet.
+ *
+ * Each criterion is compiled into byte comparisons at fixed offsets of the
+ * discovery acknowledge, so that acknowledges of other devices can be
+ * rejected before a DeviceInfo is built. A device matches if it fulfills at
+ * least one value of each type of criterion that has been added. A filter
+ * without criteria matches all devices.
+ */
+class DeviceFilter
+{
+  public:
+    /**
+     * @brief Adds a serial number, which must match exactly.
+     * @param serial serial number
+     */
+    void addSerialNumber(const std::string &serial);
+
+    /**
+     * @brief Adds a prefix of the MAC address.
+     * @param prefix one to six hex bytes separated by colon, e.g. 00:14:2d
+     * @throws std::invalid_argument if the prefix cannot be parsed
+     */
+    void addMACPrefix(const std::string &prefix);
+
+    /**
+     * @brief Adds a model name, which must match exactly.
+     * @param model model name, e.g. rc_visard
+     */
+    void addModelName(const std::string &model);
+
+    /**
+     * @brief Adds a user name, which must match exactly.
+     * @param name user name
+     */
+    void addUserName(const std::string &name);
+
+    /**
+     * @brief Adds a subnet that must contain the IP address of the device.
+     * @param subnet subnet in CIDR notation, e.g. 10.0.2.0/24, or single
+     * IP address
+     * @throws std::invalid_argument if the subnet cannot be parsed
+     */
+    void addSubnet(const std::string &subnet);
+
+    /**
+     * @brief Checks if criteria have been added.
+     * @return true if the filter matches all devices
+     */
+    bool empty() const;
+
+    /**
+     * @brief Checks if the acknowledge of a device matches.
+     * @param raw content of discovery acknowledge without header
+     * @param len length of content
+     * @return true if the device matches
+     */
+    bool matches(const uint8_t *raw, size_t len) const;
+
+    /**
+     * @brief Checks if a device matches.
+     * @param info device information
+     * @return true if the device matches
+     */
+    bool matches(const DeviceInfo &info) const;
+
+  private:
+    /*
+      Comparison of the masked bytes of the acknowledge at the given offset.
+    */
+
+    struct Term
+    {
+      size_t offset;
+      std::vector<uint8_t> value;
+      std::vector<uint8_t> mask;
+    };
+
+    /*
+      Alternative terms of one type of criterion. An active group without
+      terms matches nothing.
+    */
+
+    struct Group
+    {
+      Group() : active(false) { }
+
+      bool active;
+      std::vector<Term> terms;
+    };
+
+    enum { SERIAL, MAC, MODEL, NAME, SUBNET, GROUP_COUNT };
+
+    void addString(int group, size_t offset, size_t field_len,
+                   const std::string &s);
+
+    Group groups_[GROUP_COUNT];
+};
+
+}
+
+#endif // RCDISCOVER_DEVICE_FILTER_H
@@ -75,6 +75,12 @@ DeviceInfo::DeviceInfo()
   clear();
 }
 
+DeviceInfo::DeviceInfo(const std::string &_iface_name) :
+  iface_name(_iface_name)
+{
+  clear();
+}
+
 void DeviceInfo::set(const uint8_t *raw, size_t len)
 {
   // clear stored information
@@ -48,6 +48,14 @@ class DeviceInfo
 
     DeviceInfo();
 
+    /**
+      Creates an empty object for a response received on the given interface.
+
+      @param iface_name Name of the interface.
+    */
+
+    explicit DeviceInfo(const std::string &iface_name);
+
     /**
       Extracts the RAW GigE Vision information according to the given
       DISCOVERY_ACK package.
@@ -59,7 +67,8 @@ class DeviceInfo
     void set(const uint8_t *raw, size_t len);
 
     /**
-      Clears all information.
+      Clears all information that was received from the device. The interface
+      name is kept.
     */
 
     void clear();
@@ -166,6 +175,32 @@ class DeviceInfo
 
     const std::string &getUserName() const { return user_name; }
 
+    /**
+      Returns the name of the interface on which the device was discovered.
+
+      @return Interface name. Empty if unknown.
+    */
+
+    const std::string &getIfaceName() const { return iface_name; }
+
+    /**
+      Sets individual fields, e.g. for restoring information that has been
+      stored or transmitted in another format than a DISCOVERY_ACK package.
+    */
+
+    void setVersion(int _major, int _minor) { major=_major; minor=_minor; }
+    void setMAC(uint64_t _mac) { mac=_mac; }
+    void setIP(uint32_t _ip) { ip=_ip; }
+    void setSubnetMask(uint32_t _subnet) { subnet=_subnet; }
+    void setGateway(uint32_t _gateway) { gateway=_gateway; }
+    void setManufacturerName(const std::string &s) { manufacturer_name=s; }
+    void setModelName(const std::string &s) { model_name=s; }
+    void setDeviceVersion(const std::string &s) { device_version=s; }
+    void setManufacturerInfo(const std::string &s) { manufacturer_info=s; }
+    void setSerialNumber(const std::string &s) { serial_number=s; }
+    void setUserName(const std::string &s) { user_name=s; }
+    void setIfaceName(const std::string &s) { iface_name=s; }
+
     /**
       Returns true if the MAC addresses conicide.
     */
@@ -194,6 +229,8 @@ class DeviceInfo
     std::string manufacturer_info;
     std::string serial_number;
     std::string user_name;
+
+    std::string iface_name;
 };
 
 }
@@ -35,7 +35,17 @@
 
 #include "discover.h"
 
+#include "device_filter.h"
+#include "cancel_token.h"
+
 #include "socket_exception.h"
+#include "iface_affinity.h"
+#include "profile.h"
+#include "trace.h"
+
+#ifdef HAVE_PCAP
+#include "pcap.h"
+#endif
 
 #include <exception>
 #include <ios>
@@ -55,6 +65,8 @@
 
 #include <vector>
 #include <future>
+#include <algorithm>
+#include <unordered_set>
 #include <string.h>
 #include <errno.h>
 
@@ -67,14 +79,89 @@ typedef SocketWindows SocketImpl;
 typedef SocketLinux SocketImpl;
 #endif
 
-Discover::Discover() :
-  sockets_(SocketType::createAndBindForAllInterfaces(3956))
+namespace
+{
+
+const std::vector<uint8_t> discovery_cmd{0x42, 0x11, 0, 0x02, 0, 0, 0, 1};
+
+/*
+  Returns the local address to which the given socket is bound in host byte
+  order.
+*/
+
+template<typename S>
+sockaddr_in getLocalAddr(const S &socket)
 {
+  struct sockaddr_in addr;
+#ifdef WIN32
+  int naddr = sizeof(addr);
+#else
+  socklen_t naddr = sizeof(addr);
+#endif
+  memset(&addr, 0, sizeof(addr));
+
+  getsockname(socket.template getHandle<typename S::SocketType>(),
+              reinterpret_cast<struct sockaddr *>(&addr), &naddr);
+
+  return addr;
+}
+
+/*
+  Checks the header of a discovery acknowledge and returns the length of its
+  content, or 0 if the package is no discovery acknowledge.
+*/
+
+size_t getAckLength(const uint8_t *p, size_t n)
+{
+  if (n >= 8)
+  {
+    if (p[0] == 0 && p[1] == 0 && p[2] == 0 &&
+        p[3] == 0x03 && p[6] == 0 && p[7] == 1)
+    {
+      size_t len=(static_cast<size_t>(p[4])<<8)|p[5];
+
+      if (n >= len+8)
+      {
+        return len;
+      }
+    }
+  }
+
+  return 0;
+}
+
+}
+
+Discover::Discover(const InterfaceSelection &selection) :
+  sockets_(selection.empty() ?
+           SocketType::createAndBindForAllInterfaces(3956) :
+           SocketType::createAndBindForInterfaces(3956, selection))
+{
+  ScopedTimer timer("set socket options");
+
   for (auto &socket : sockets_)
   {
     socket.enableBroadcast();
     socket.enableNonBlocking();
+
+#ifdef SO_RXQ_OVFL
+    // counting of dropped packages is optional
+
+    const int yes = 1;
+    setsockopt(socket.getHandle<SocketType::SocketType>(), SOL_SOCKET,
+               SO_RXQ_OVFL, &yes, sizeof(yes));
+#endif
+  }
+
+  stats_.resize(sockets_.size());
+  for (size_t i = 0; i < sockets_.size(); ++i)
+  {
+    stats_[i].iface_name = sockets_[i].getIfaceName();
   }
+
+  sent_.resize(sockets_.size());
+  answered_.resize(sockets_.size());
+  drops_.resize(sockets_.size(), 0);
 }
 
 Discover::~Discover()
@@ -82,19 +169,126 @@ Discover::~Discover()
 
 void Discover::broadcastRequest()
 {
-  const std::vector<uint8_t> discovery_cmd{0x42, 0x11, 0, 0x02, 0, 0, 0, 1};
+  std::vector<IfaceStatus> status;
+  tryBroadcastRequest(&status);
 
-  for (auto &socket : sockets_)
+  // down interfaces are expected
+
+  for (const auto &st : status)
+  {
+    if (st.error && st.error != std::errc::network_unreachable)
+    {
+      throw SocketException("Error while sending data", st.error.value());
+    }
+  }
+}
+
+size_t Discover::tryBroadcastRequest(std::vector<IfaceStatus> *status) noexcept
+{
+  ScopedTimer timer("broadcast");
+
+  if (status != nullptr)
+  {
+    status->resize(sockets_.size());
+  }
+
+  size_t ret = 0;
+
+  for (size_t i = 0; i < sockets_.size(); ++i)
   {
-    try
+    SocketType &socket = sockets_[i];
+    const std::error_code ec = socket.trySend(discovery_cmd);
+
+    if (status != nullptr)
     {
-      socket.send(discovery_cmd);
+      (*status)[i].iface_name = socket.getIfaceName();
+      (*status)[i].error = ec;
     }
-    catch(const NetworkUnreachableException &)
+
+    if (ec)
     {
+      stats_[i].send_errors++;
+      stats_[i].last_error = ec;
       continue;
     }
+
+    stats_[i].broadcasts_sent++;
+    sent_[i] = std::chrono::steady_clock::now();
+    answered_[i].clear();
+
+    ret++;
+
+#ifdef HAVE_PCAP
+    if (recorder_)
+    {
+      const sockaddr_in &dst = socket.getDestSockAddr();
+      record(socket, ntohl(dst.sin_addr.s_addr), ntohs(dst.sin_port));
+    }
+#endif
+  }
+
+  return ret;
+}
+
+size_t Discover::reprobeMissing(const std::vector<DeviceInfo> &known,
+                                const std::vector<DeviceInfo> &responses)
+{
+  ScopedTimer timer("reprobe");
+
+  std::unordered_set<uint64_t> answered;
+  for (const auto &info : responses)
+  {
+    if (info.isValid())
+    {
+      answered.insert(info.getMAC());
+    }
+  }
+
+  size_t ret = 0;
+
+  for (const auto &info : known)
+  {
+    if (!info.isValid() || info.getIP() == 0 ||
+        answered.count(info.getMAC()) > 0)
+    {
+      continue;
+    }
+
+    std::string iface = info.getIfaceName();
+    if (iface.empty())
+    {
+      iface = IfaceAffinity::lookup(info.getMAC());
+    }
+
+    const bool known_iface = std::any_of(sockets_.begin(), sockets_.end(),
+      [&iface](const SocketType &s) { return s.getIfaceName() == iface; });
+
+    for (auto &socket : sockets_)
+    {
+      if (known_iface && socket.getIfaceName() != iface)
+      {
+        continue;
+      }
+
+      // probing is best effort, e.g. the address may not be routable
+      // anymore
+
+      if (!socket.trySendTo(discovery_cmd, info.getIP()))
+      {
+#ifdef HAVE_PCAP
+        if (recorder_)
+        {
+          record(socket, info.getIP(), 3956);
+        }
+#endif
+      }
+    }
+
+    answered.insert(info.getMAC());
+    ret++;
   }
+
+  return ret;
 }
 
 bool Discover::getResponse(std::vector<DeviceInfo> &info,
@@ -108,13 +302,35 @@ bool Discover::getResponse(std::vector<DeviceInfo> &info,
 
   // try to get a valid package (repeat if an invalid package is received)
 
+  std::shared_ptr<PcapWriter> recorder = recorder_;
+  std::shared_ptr<const DeviceFilter> filter = filter_;
+  std::shared_ptr<const CancelToken> cancel = cancel_;
+
+  if (cancel && cancel->isCancelled())
+  {
+    return false;
+  }
+
+  std::vector<char> filtered(sockets_.size(), 0);
+
   std::vector<std::future<DeviceInfo>> futures;
-  for (auto &socket : sockets_)
+  for (size_t i = 0; i < sockets_.size(); ++i)
   {
-    futures.push_back(std::async(std::launch::async, [&socket, &tv]
+    // each task only touches the counters of its own socket
+
+    SocketType &socket = sockets_[i];
+    IfaceStats &stats = stats_[i];
+    const auto sent = sent_[i];
+    std::vector<uint64_t> &answered = answered_[i];
+    uint32_t &drops = drops_[i];
+    char &skipped = filtered[i];
+
+    futures.push_back(std::async(std::launch::async,
+                                 [&socket, &tv, recorder, filter, cancel,
+                                  &stats, sent, &answered, &drops, &skipped,
+                                  timeout_per_socket]
     {
-      DeviceInfo device_info;
-      device_info.clear();
+      DeviceInfo device_info(socket.getIfaceName());
 
       int count = 10;
 
@@ -124,11 +340,37 @@ bool Discover::getResponse(std::vector<DeviceInfo> &info,
       FD_ZERO(&fds);
       FD_SET(sock, &fds);
 
-      while (!device_info.isValid() && count > 0)
+      while (!device_info.isValid() && !skipped && count > 0)
       {
         count--;
 
-        if (select(sock+1, &fds, NULL, NULL, &tv) > 0)
+        bool readable = false;
+
+        if (cancel)
+        {
+          // wait in short slices to notice cancellation
+
+          int remaining = timeout_per_socket;
+          while (!readable && remaining > 0 && !cancel->isCancelled())
+          {
+            const int slice = std::min(remaining, 50);
+
+            struct timeval stv;
+            stv.tv_sec = 0;
+            stv.tv_usec = slice*1000;
+
+            FD_ZERO(&fds);
+            FD_SET(sock, &fds);
+            readable = (select(sock+1, &fds, NULL, NULL, &stv) > 0);
+            remaining -= slice;
+          }
+        }
+        else
+        {
+          readable = (select(sock+1, &fds, NULL, NULL, &tv) > 0);
+        }
+
+        if (readable)
         {
           // get package
 
@@ -142,27 +384,106 @@ bool Discover::getResponse(std::vector<DeviceInfo> &info,
 #endif
           memset(&addr, 0, naddr);
 
+#ifdef SO_RXQ_OVFL
+          // receive with the number of packages that the kernel dropped
+          // so far due to a full receive buffer
+
+          struct iovec iov;
+          iov.iov_base = p;
+          iov.iov_len = sizeof(p);
+
+          char control[CMSG_SPACE(sizeof(uint32_t))];
+
+          struct msghdr msg;
+          memset(&msg, 0, sizeof(msg));
+          msg.msg_name = &addr;
+          msg.msg_namelen = naddr;
+          msg.msg_iov = &iov;
+          msg.msg_iovlen = 1;
+          msg.msg_control = control;
+          msg.msg_controllen = sizeof(control);
+
+          long n = recvmsg(sock, &msg, 0);
+
+          for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); n >= 0 &&
+               cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg))
+          {
+            if (cmsg->cmsg_level == SOL_SOCKET &&
+                cmsg->cmsg_type == SO_RXQ_OVFL)
+            {
+              uint32_t total;
+              memcpy(&total, CMSG_DATA(cmsg), sizeof(total));
+              stats.kernel_drops += total - drops;
+              drops = total;
+            }
+          }
+#else
           long n = recvfrom(sock,
                             reinterpret_cast<char *>(p), sizeof(p), 0,
                             reinterpret_cast<struct sockaddr *>(&addr), &naddr);
+#endif
+
+          const auto latency =
+            std::chrono::duration_cast<std::chrono::microseconds>(
+              std::chrono::steady_clock::now() - sent);
+
+          RCDISCOVER_TRACE_INSTANT("receive", static_cast<uint64_t>(n));
+
+#ifdef HAVE_PCAP
+          if (recorder && n > 0)
+          {
+            const sockaddr_in dst = getLocalAddr(socket);
+            recorder->write(ntohl(addr.sin_addr.s_addr), ntohs(addr.sin_port),
+                            ntohl(dst.sin_addr.s_addr), ntohs(dst.sin_port),
+                            p, static_cast<size_t>(n));
+          }
+#endif
 
           // check if received package is a valid discovery acknowledge
 
-          if (n >= 8)
+          if (n > 0)
           {
-            if (p[0] == 0 && p[1] == 0 && p[2] == 0 &&
-                p[3] == 0x03 && p[6] == 0 && p[7] == 1)
-            {
-              size_t len=(static_cast<size_t>(p[4])<<8)|p[5];
+            stats.acks_received++;
+          }
 
-              if (static_cast<size_t>(n) >= len+8)
-              {
-                // extract information and store in list
+          // acknowledges of devices that do not match the filter are
+          // rejected on the raw content without decoding
 
-                device_info.set(p+8, len);
+          size_t len = 0;
+          if (n > 0 && filter &&
+              (len = getAckLength(p, static_cast<size_t>(n))) > 0 &&
+              !filter->matches(p+8, len))
+          {
+            stats.acks_filtered++;
+            skipped = 1;
+          }
+          else if (n > 0 &&
+                   decodeResponse(p, static_cast<size_t>(n), device_info))
+          {
+            stats.acks_valid++;
+            if (stats.broadcasts_sent > 0)
+            {
+              if (stats.first_response.count() < 0)
+              {
+                stats.first_response = latency;
               }
+              stats.last_response = latency;
+            }
+
+            if (std::find(answered.begin(), answered.end(),
+                          device_info.getMAC()) != answered.end())
+            {
+              stats.duplicates++;
+            }
+            else
+            {
+              answered.push_back(device_info.getMAC());
             }
           }
+          else if (n > 0)
+          {
+            stats.acks_invalid++;
+          }
         }
         else
         {
@@ -176,13 +497,78 @@ bool Discover::getResponse(std::vector<DeviceInfo> &info,
   }
 
   bool ret = false;
-  for (auto &f : futures)
+  for (size_t i = 0; i < futures.size(); ++i)
   {
-    info.push_back(f.get());
-    ret |= info.back().isValid();
+    info.push_back(futures[i].get());
+    ret |= info.back().isValid() || filtered[i];
   }
 
   return ret;
 }
 
+const std::vector<IfaceStats> &Discover::getStatistics() const
+{
+  return stats_;
+}
+
+void Discover::resetStatistics()
+{
+  for (auto &stats : stats_)
+  {
+    IfaceStats empty;
+    empty.iface_name = std::move(stats.iface_name);
+    stats = std::move(empty);
+  }
+}
+
+void Discover::setFilter(std::shared_ptr<const DeviceFilter> filter)
+{
+  filter_ = std::move(filter);
+}
+
+void Discover::setCancelToken(std::shared_ptr<const CancelToken> cancel)
+{
+  cancel_ = std::move(cancel);
+}
+
+#ifdef HAVE_PCAP
+void Discover::setRecorder(std::shared_ptr<PcapWriter> recorder)
+{
+  recorder_ = std::move(recorder);
+}
+
+void Discover::record(const SocketType &socket, uint32_t dst_ip,
+                      uint16_t dst_port) noexcept
+{
+  // recording must not disturb discovery
+
+  try
+  {
+    const sockaddr_in src = getLocalAddr(socket);
+    recorder_->write(ntohl(src.sin_addr.s_addr), ntohs(src.sin_port),
+                     dst_ip, dst_port, discovery_cmd.data(),
+                     discovery_cmd.size());
+  }
+  catch(const std::exception &)
+  { }
+}
+#endif
+
+bool Discover::decodeResponse(const uint8_t *p, size_t n, DeviceInfo &info)
+{
+  RCDISCOVER_TRACE_SCOPE("parse", n);
+
+  const size_t len=getAckLength(p, n);
+
+  if (len > 0)
+  {
+    // extract information
+
+    info.set(p+8, len);
+    return info.isValid();
+  }
+
+  return false;
+}
+
 }
\ No newline at end of file
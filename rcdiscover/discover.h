@@ -37,6 +37,13 @@
 #define RCDISCOVER_DISCOVER
 
 #include "deviceinfo.h"
+#include "iface_status.h"
+#include "iface_stats.h"
+#include "iface_selection.h"
+
+#include <memory>
+#include <vector>
+#include <chrono>
 
 #ifdef WIN32
 #include "socket_windows.h"
@@ -47,6 +54,10 @@
 namespace rcdiscover
 {
 
+class PcapWriter;
+class DeviceFilter;
+class CancelToken;
+
 class Discover
 {
   public:
@@ -62,17 +73,47 @@ class Discover
       Initializes a socket ready for broadcasting requests.
 
       NOTE: Exceptions are thrown in case of severe network errors.
+
+      @param selection Interfaces that are used. By default, all interfaces.
     */
 
-    Discover();
+    explicit Discover(const InterfaceSelection &selection=InterfaceSelection());
     ~Discover();
 
     /**
-      Broadcasts a discovery command request.
+      Broadcasts a discovery command request. Interfaces on which the network
+      is unreachable are skipped.
+
+      NOTE: Exceptions are thrown in case of other network errors.
     */
 
     void broadcastRequest();
 
+    /**
+      Broadcasts a discovery command request without throwing exceptions.
+
+      @param status If not null, it is set to the result for each interface.
+                    Passing the same vector again avoids memory allocation.
+      @return       Number of interfaces on which the request has been sent.
+    */
+
+    size_t tryBroadcastRequest(std::vector<IfaceStatus> *status=nullptr) noexcept;
+
+    /**
+      Sends unicast discovery command requests to the last known IP addresses
+      of all known devices that are missing in the responses, e.g. because
+      their acknowledge of the broadcast has been lost. The request is only
+      sent via the interface on which the device answered before, if known.
+      Further responses are received with getResponse().
+
+      @param known     Previously discovered devices, e.g. of the last round.
+      @param responses Responses that have been received so far.
+      @return          Number of devices that have been probed.
+    */
+
+    size_t reprobeMissing(const std::vector<DeviceInfo> &known,
+                          const std::vector<DeviceInfo> &responses);
+
     /**
       Returns a discovery response. This method should be called until there is
       no further response.
@@ -81,14 +122,93 @@ class Discover
                      response.
       @param timeout Timeout in Milliseconds.
       @return        True if there was a valid response. In this case, the info
-                     object contains valid information. False in case of a
-                     timeout.
+                     object contains valid information. If a filter is set,
+                     true is also returned if an acknowledge of a device that
+                     does not match the filter has been received. False in
+                     case of a timeout or if the cancel token is cancelled.
     */
 
     bool getResponse(std::vector<DeviceInfo> &info, int timeout_per_socket=1000);
 
+    /**
+      Returns the counters of each interface, which are accumulated since
+      construction or the last call of resetStatistics(). Must not be called
+      concurrently with the other methods.
+
+      @return Counters of each interface.
+    */
+
+    const std::vector<IfaceStats> &getStatistics() const;
+
+    /**
+      Sets all counters to zero.
+    */
+
+    void resetStatistics();
+
+    /**
+      Sets a filter that is applied to the content of discovery acknowledges
+      before they are decoded. Acknowledges of devices that do not match are
+      counted as filtered and not returned by getResponse(). The filter is
+      removed by passing a null pointer.
+
+      @param filter Filter for devices.
+    */
+
+    void setFilter(std::shared_ptr<const DeviceFilter> filter);
+
+    /**
+      Sets a token that stops getResponse() within a few milliseconds after
+      it has been cancelled from another thread. The token is removed by
+      passing a null pointer.
+
+      @param cancel Cancel token.
+    */
+
+    void setCancelToken(std::shared_ptr<const CancelToken> cancel);
+
+#ifdef HAVE_PCAP
+    /**
+      Records all sent discovery requests and all received packages to the
+      given pcap writer. Recording is disabled by passing a null pointer.
+
+      @param recorder Pcap writer.
+    */
+
+    void setRecorder(std::shared_ptr<PcapWriter> recorder);
+#endif
+
+    /**
+      Checks if the given package is a valid discovery acknowledge and extracts
+      the device information.
+
+      @param p    Pointer to package including header.
+      @param n    Length of package.
+      @param info Info object that will be filled.
+      @return     True if the package is a valid discovery acknowledge.
+    */
+
+    static bool decodeResponse(const uint8_t *p, size_t n, DeviceInfo &info);
+
   private:
+#ifdef HAVE_PCAP
+    /**
+      Records a sent discovery command request.
+    */
+
+    void record(const SocketType &socket, uint32_t dst_ip,
+                uint16_t dst_port) noexcept;
+#endif
+
     std::vector<SocketType> sockets_;
+    std::shared_ptr<PcapWriter> recorder_;
+    std::shared_ptr<const DeviceFilter> filter_;
+    std::shared_ptr<const CancelToken> cancel_;
+
+    std::vector<IfaceStats> stats_;
+    std::vector<std::chrono::steady_clock::time_point> sent_;
+    std::vector<std::vector<uint64_t>> answered_;
+    std::vector<uint32_t> drops_;
 };
 
 }
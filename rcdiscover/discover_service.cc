@@ -0,0 +1,146 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "discover_service.h"
+
+namespace rcdiscover
+{
+
+DiscoverService::DiscoverService(const InterfaceSelection &selection) :
+  discover_(new ContinuousDiscover(selection)),
+  timeout_(100),
+  running_(false),
+  rounds_(0),
+  has_result_(false)
+{
+  ContinuousDiscover *discover = discover_.get();
+  scan_ = [discover] { return discover->scan(); };
+}
+
+DiscoverService::DiscoverService(ScanFunction scan) :
+  scan_(std::move(scan)),
+  timeout_(100),
+  running_(false),
+  rounds_(0),
+  has_result_(false)
+{ }
+
+void DiscoverService::setResponseTimeout(int timeout_per_socket)
+{
+  std::lock_guard<std::mutex> lock(mtx_);
+  timeout_ = timeout_per_socket;
+}
+
+std::vector<DeviceInfo> DiscoverService::discover(
+    std::chrono::milliseconds max_age)
+{
+  std::unique_lock<std::mutex> lock(mtx_);
+
+  const auto now = std::chrono::steady_clock::now();
+
+  if (has_result_ && now - result_time_ <= max_age)
+  {
+    return result_;
+  }
+
+  // join the round in progress
+
+  if (running_)
+  {
+    const uint64_t rounds = rounds_;
+    cv_.wait(lock, [this, rounds] { return rounds_ != rounds; });
+
+    if (error_)
+    {
+      std::rethrow_exception(error_);
+    }
+
+    return result_;
+  }
+
+  // perform a new round without holding the lock, so that other threads
+  // can join it
+
+  running_ = true;
+
+  if (discover_)
+  {
+    discover_->setResponseTimeout(timeout_);
+  }
+
+  lock.unlock();
+
+  std::vector<DeviceInfo> result;
+  std::exception_ptr error;
+
+  try
+  {
+    result = scan_();
+  }
+  catch(...)
+  {
+    error = std::current_exception();
+  }
+
+  lock.lock();
+
+  running_ = false;
+  rounds_++;
+  error_ = error;
+
+  if (!error)
+  {
+    has_result_ = true;
+    result_time_ = now;
+    result_ = result;
+  }
+
+  cv_.notify_all();
+
+  if (error)
+  {
+    std::rethrow_exception(error);
+  }
+
+  return result;
+}
+
+uint64_t DiscoverService::getRounds() const
+{
+  std::lock_guard<std::mutex> lock(mtx_);
+  return rounds_;
+}
+
+}
@@ -0,0 +1,136 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RCDISCOVER_DISCOVER_SERVICE_H
+#define RCDISCOVER_DISCOVER_SERVICE_H
+
+#include "continuous_discover.h"
+#include "deviceinfo.h"
+
+#include <vector>
+#include <chrono>
+#include <memory>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <cstdint>
+
+namespace rcdiscover
+{
+
+/**
+ * @brief Discovery that can be shared by several threads.
+ *
+ * Only one discovery round is performed at a time. Threads that request a
+ * round while another one is in progress wait for it and share its result.
+ * Results of previous rounds are returned if they are fresh enough for the
+ * caller.
+ */
+class DiscoverService
+{
+  public:
+    /**
+     * @brief Function that performs one discovery round.
+     */
+    typedef std::function<std::vector<DeviceInfo>()> ScanFunction;
+
+  public:
+    /**
+     * @brief Constructor. Opens the sockets.
+     *
+     * NOTE: Exceptions are thrown in case of severe network errors.
+     *
+     * @param selection interfaces that are used, by default all interfaces
+     */
+    explicit DiscoverService(
+      const InterfaceSelection &selection = InterfaceSelection());
+
+    /**
+     * @brief Constructor for rounds that are performed by the given
+     * function instead of ContinuousDiscover::scan(), e.g. for testing.
+     * @param scan function that performs one round
+     */
+    explicit DiscoverService(ScanFunction scan);
+
+    DiscoverService(const DiscoverService &) = delete;
+    DiscoverService &operator=(const DiscoverService &) = delete;
+
+    /**
+     * @brief Sets the time for waiting for further responses on each socket
+     * (see ContinuousDiscover::setResponseTimeout()). It has no effect if
+     * a scan function is given.
+     * @param timeout_per_socket timeout in milliseconds
+     */
+    void setResponseTimeout(int timeout_per_socket);
+
+    /**
+     * @brief Returns the devices of a discovery round.
+     *
+     * If the last round started at most max_age ago, its result is returned
+     * immediately. If a round is in progress, its result is awaited.
+     * Otherwise, a new round is performed by the calling thread.
+     * @param max_age maximum age of the result
+     * @return deduplicated, valid responses sorted by MAC address
+     * @throws the exception of the round in case of network errors
+     */
+    std::vector<DeviceInfo> discover(
+        std::chrono::milliseconds max_age = std::chrono::milliseconds(0));
+
+    /**
+     * @brief Returns the number of rounds that have been performed.
+     * @return number of rounds
+     */
+    uint64_t getRounds() const;
+
+  private:
+    std::unique_ptr<ContinuousDiscover> discover_;
+    ScanFunction scan_;
+
+    mutable std::mutex mtx_;
+    std::condition_variable cv_;
+    int timeout_;
+    bool running_;
+    uint64_t rounds_;
+
+    bool has_result_;
+    std::chrono::steady_clock::time_point result_time_;
+    std::vector<DeviceInfo> result_;
+    std::exception_ptr error_;
+};
+
+}
+
+#endif // RCDISCOVER_DISCOVER_SERVICE_H
@@ -0,0 +1,338 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "fleet.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace rcdiscover
+{
+
+Fleet::Fleet(int max_missing_rounds, size_t max_events) :
+  max_missing_rounds_(std::max(max_missing_rounds, 1)),
+  max_events_(std::max(max_events, static_cast<size_t>(1))),
+  epoch_(static_cast<uint64_t>(
+    std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count())),
+  rounds_(0),
+  last_seq_(0),
+  next_cb_id_(0)
+{ }
+
+void Fleet::update(const std::vector<DeviceInfo> &round)
+{
+  std::unique_lock<std::mutex> lock(mtx_);
+  std::vector<FleetEvent> pending;
+
+  rounds_++;
+
+  for (auto &d : devices_)
+  {
+    d.second.missing++;
+  }
+
+  for (const auto &info : round)
+  {
+    if (!info.isValid())
+    {
+      continue;
+    }
+
+    const uint64_t mac = info.getMAC();
+    auto it = devices_.find(mac);
+
+    if (it == devices_.end())
+    {
+      Entry entry;
+      entry.info = info;
+      it = devices_.insert(std::make_pair(mac, entry)).first;
+
+      addEvent(FleetEvent::APPEARED, 0, info, pending);
+    }
+    else
+    {
+      const DeviceInfo &old = it->second.info;
+
+      unsigned int changed = 0;
+      if (old.getIP() != info.getIP())
+      {
+        changed |= FleetEvent::IP;
+      }
+      if (old.getSubnetMask() != info.getSubnetMask())
+      {
+        changed |= FleetEvent::SUBNET;
+      }
+      if (old.getGateway() != info.getGateway())
+      {
+        changed |= FleetEvent::GATEWAY;
+      }
+      if (old.getUserName() != info.getUserName())
+      {
+        changed |= FleetEvent::USER_NAME;
+      }
+
+      if (changed != 0)
+      {
+        addEvent(FleetEvent::CHANGED, changed, info, pending);
+      }
+
+      removeIndex(mac, old);
+      it->second.info = info;
+    }
+
+    it->second.missing = 0;
+
+    serials_[info.getSerialNumber()] = mac;
+    names_.insert(std::make_pair(getName(info), mac));
+  }
+
+  // remove devices that did not answer for too long
+
+  for (auto it = devices_.begin(); it != devices_.end();)
+  {
+    if (it->second.missing >= max_missing_rounds_)
+    {
+      addEvent(FleetEvent::DISAPPEARED, 0, it->second.info, pending);
+
+      removeIndex(it->first, it->second.info);
+      it = devices_.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+
+  if (pending.empty())
+  {
+    return;
+  }
+
+  // hand over to the callback lock before releasing the table, so that
+  // events of concurrent updates are delivered in order
+
+  std::lock_guard<std::mutex> cb_lock(cb_mtx_);
+  lock.unlock();
+
+  for (const auto &event : pending)
+  {
+    for (const auto &cb : callbacks_)
+    {
+      cb.second(event);
+    }
+  }
+}
+
+std::vector<DeviceInfo> Fleet::getDevices() const
+{
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  std::vector<DeviceInfo> ret;
+  ret.reserve(devices_.size());
+
+  for (const auto &d : devices_)
+  {
+    ret.push_back(d.second.info);
+  }
+
+  return ret;
+}
+
+bool Fleet::findByMAC(uint64_t mac, DeviceInfo &info) const
+{
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  const auto it = devices_.find(mac);
+  if (it == devices_.end())
+  {
+    return false;
+  }
+
+  info = it->second.info;
+  return true;
+}
+
+bool Fleet::findBySerial(const std::string &serial, DeviceInfo &info) const
+{
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  const auto s = serials_.find(serial);
+  if (s == serials_.end())
+  {
+    return false;
+  }
+
+  info = devices_.at(s->second).info;
+  return true;
+}
+
+std::vector<DeviceInfo> Fleet::findByName(const std::string &name) const
+{
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  std::vector<DeviceInfo> ret;
+
+  const auto range = names_.equal_range(name);
+  for (auto n = range.first; n != range.second; ++n)
+  {
+    ret.push_back(devices_.at(n->second).info);
+  }
+
+  std::sort(ret.begin(), ret.end());
+
+  return ret;
+}
+
+size_t Fleet::size() const
+{
+  std::lock_guard<std::mutex> lock(mtx_);
+  return devices_.size();
+}
+
+uint64_t Fleet::getRounds() const
+{
+  std::lock_guard<std::mutex> lock(mtx_);
+  return rounds_;
+}
+
+int Fleet::subscribe(EventCallback callback)
+{
+  std::lock_guard<std::mutex> lock(cb_mtx_);
+
+  const int id = next_cb_id_++;
+  callbacks_[id] = std::move(callback);
+
+  return id;
+}
+
+void Fleet::unsubscribe(int id)
+{
+  std::lock_guard<std::mutex> lock(cb_mtx_);
+  callbacks_.erase(id);
+}
+
+uint64_t Fleet::getLastSequence() const
+{
+  std::lock_guard<std::mutex> lock(mtx_);
+  return last_seq_;
+}
+
+uint64_t Fleet::getEpoch() const
+{
+  return epoch_;
+}
+
+bool Fleet::getEventsSince(uint64_t seq, std::vector<FleetEvent> &events) const
+{
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  events.clear();
+
+  if (seq == last_seq_)
+  {
+    return true;
+  }
+
+  // a newer sequence number than the latest event cannot be resumed from
+
+  if (seq > last_seq_)
+  {
+    return false;
+  }
+
+  // sequence numbers in the history are contiguous
+
+  const uint64_t first = last_seq_ - events_.size() + 1;
+  if (seq+1 < first)
+  {
+    return false;
+  }
+
+  events.assign(events_.begin() + static_cast<std::ptrdiff_t>(seq+1-first),
+                events_.end());
+
+  return true;
+}
+
+const std::string &Fleet::getName(const DeviceInfo &info)
+{
+  if (info.getUserName().size() > 0)
+  {
+    return info.getUserName();
+  }
+
+  return info.getModelName();
+}
+
+void Fleet::removeIndex(uint64_t mac, const DeviceInfo &info)
+{
+  const auto s = serials_.find(info.getSerialNumber());
+  if (s != serials_.end() && s->second == mac)
+  {
+    serials_.erase(s);
+  }
+
+  auto range = names_.equal_range(getName(info));
+  for (auto n = range.first; n != range.second; ++n)
+  {
+    if (n->second == mac)
+    {
+      names_.erase(n);
+      break;
+    }
+  }
+}
+
+void Fleet::addEvent(FleetEvent::Type type, unsigned int changed,
+                     const DeviceInfo &info, std::vector<FleetEvent> &pending)
+{
+  FleetEvent event;
+  event.seq = ++last_seq_;
+  event.epoch = epoch_;
+  event.type = type;
+  event.changed = changed;
+  event.info = info;
+
+  events_.push_back(event);
+  if (events_.size() > max_events_)
+  {
+    events_.pop_front();
+  }
+
+  pending.push_back(event);
+}
+
+}
@@ -0,0 +1,237 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RCDISCOVER_FLEET_H
+#define RCDISCOVER_FLEET_H
+
+#include "deviceinfo.h"
+
+#include <map>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+#include <cstdint>
+
+namespace rcdiscover
+{
+
+/**
+ * @brief Change of the fleet table between two discovery rounds.
+ */
+struct FleetEvent
+{
+  enum Type
+  {
+    APPEARED,    ///< device answered for the first time
+    DISAPPEARED, ///< device has been removed after missing rounds
+    CHANGED      ///< one of the fields in changed has a new value
+  };
+
+  enum Field
+  {
+    IP = 1,
+    SUBNET = 2,
+    GATEWAY = 4,
+    USER_NAME = 8
+  };
+
+  uint64_t seq;         ///< sequence number, starting with 1
+  uint64_t epoch;       ///< identifies the Fleet, see Fleet::getEpoch()
+  Type type;
+  unsigned int changed; ///< bitmask of Field, only set for CHANGED
+  DeviceInfo info;      ///< new state, last known state for DISAPPEARED
+};
+
+/**
+ * @brief Deduplicated table of all devices that answered in recent discovery
+ * rounds.
+ *
+ * A device is removed if it did not answer in a given number of consecutive
+ * rounds. Every change of the table is published as FleetEvent to all
+ * subscribers and kept in a bounded history, so that consumers can resume
+ * from the last sequence number they have seen. All methods are thread-safe.
+ */
+class Fleet
+{
+  public:
+    typedef std::function<void(const FleetEvent &)> EventCallback;
+
+    /**
+     * @brief Constructor.
+     * @param max_missing_rounds number of consecutive rounds without answer
+     * after which a device is removed
+     * @param max_events number of events that are kept for resuming
+     */
+    explicit Fleet(int max_missing_rounds = 3, size_t max_events = 4096);
+
+    /**
+     * @brief Updates the table with the result of one discovery round.
+     * @param round all responses of the round (duplicates and invalid
+     * entries are ignored)
+     */
+    void update(const std::vector<DeviceInfo> &round);
+
+    /**
+     * @brief Returns all devices sorted by MAC address.
+     * @return devices
+     */
+    std::vector<DeviceInfo> getDevices() const;
+
+    /**
+     * @brief Looks up a device by MAC address.
+     * @param mac MAC address
+     * @param info set to the device if found
+     * @return true if found
+     */
+    bool findByMAC(uint64_t mac, DeviceInfo &info) const;
+
+    /**
+     * @brief Looks up a device by serial number.
+     * @param serial serial number
+     * @param info set to the device if found
+     * @return true if found
+     */
+    bool findBySerial(const std::string &serial, DeviceInfo &info) const;
+
+    /**
+     * @brief Looks up devices by user name. For devices without user name,
+     * the model name is used, as in the output of rcdiscover.
+     * @param name name
+     * @return all devices with the given name sorted by MAC address
+     */
+    std::vector<DeviceInfo> findByName(const std::string &name) const;
+
+    /**
+     * @brief Returns the number of devices.
+     * @return number of devices
+     */
+    size_t size() const;
+
+    /**
+     * @brief Returns the number of rounds that have been passed to update().
+     * @return number of rounds
+     */
+    uint64_t getRounds() const;
+
+    /**
+     * @brief Registers a callback that is called for every event.
+     *
+     * Callbacks are called from the thread that calls update(), in order of
+     * the sequence numbers. They must not call subscribe() or unsubscribe().
+     * @param callback callback
+     * @return id for unsubscribe()
+     */
+    int subscribe(EventCallback callback);
+
+    /**
+     * @brief Removes a callback.
+     * @param id id returned by subscribe()
+     */
+    void unsubscribe(int id);
+
+    /**
+     * @brief Returns the sequence number of the latest event.
+     * @return sequence number, 0 if there was no event yet
+     */
+    uint64_t getLastSequence() const;
+
+    /**
+     * @brief Returns the epoch of the event stream. Sequence numbers are only
+     * comparable between events of the same epoch, e.g. a restarted daemon
+     * starts a new epoch with sequence number 1.
+     * @return time of construction in milliseconds since epoch
+     */
+    uint64_t getEpoch() const;
+
+    /**
+     * @brief Returns all events after the given sequence number from the
+     * history.
+     * @param seq sequence number of the last event that is known to the
+     * caller
+     * @param events filled with the events
+     * @return false if some of the requested events are not in the history
+     * anymore or seq is newer than the latest event (i.e. it stems from
+     * another epoch), so that the caller must resynchronize with getDevices()
+     */
+    bool getEventsSince(uint64_t seq, std::vector<FleetEvent> &events) const;
+
+  private:
+    struct Entry
+    {
+      DeviceInfo info;
+      int missing;
+    };
+
+    /**
+     * @brief Returns the name under which a device can be found.
+     */
+    static const std::string &getName(const DeviceInfo &info);
+
+    /**
+     * @brief Removes the index entries of a device.
+     */
+    void removeIndex(uint64_t mac, const DeviceInfo &info);
+
+    /**
+     * @brief Adds an event to the history and the list of pending events.
+     */
+    void addEvent(FleetEvent::Type type, unsigned int changed,
+                  const DeviceInfo &info, std::vector<FleetEvent> &pending);
+
+  private:
+    const int max_missing_rounds_;
+    const size_t max_events_;
+    const uint64_t epoch_;
+
+    mutable std::mutex mtx_;
+    uint64_t rounds_;
+    std::map<uint64_t, Entry> devices_;
+    std::unordered_map<std::string, uint64_t> serials_;
+    std::unordered_multimap<std::string, uint64_t> names_;
+
+    uint64_t last_seq_;
+    std::deque<FleetEvent> events_;
+
+    std::mutex cb_mtx_;
+    int next_cb_id_;
+    std::map<int, EventCallback> callbacks_;
+};
+
+}
+
+#endif // RCDISCOVER_FLEET_H
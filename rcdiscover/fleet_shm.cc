@@ -0,0 +1,374 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "fleet_shm.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <new>
+
+namespace rcdiscover
+{
+
+const char * const FLEET_SHM_DEFAULT_NAME = "/rcdiscoverd";
+
+namespace
+{
+
+const uint32_t FLEET_SHM_MAGIC = 0x54464352; // "RCFT"
+const uint32_t FLEET_SHM_VERSION = 1;
+
+// a publication takes microseconds, i.e. after this many attempts the writer
+// most likely died while publishing
+
+const int MAX_READ_ATTEMPTS = 10000;
+const int SPIN_READ_ATTEMPTS = 100;
+
+void copyString(char *dest, size_t len, const std::string &s)
+{
+  memset(dest, 0, len);
+  memcpy(dest, s.data(), std::min(len, s.size()));
+}
+
+std::string toString(const char *s, size_t len)
+{
+  return std::string(s, strnlen(s, len));
+}
+
+/**
+ * @brief Calls f with the number of valid records until the segment did not
+ * change while f was running. The processor is yielded after a number of
+ * unsuccessful attempts.
+ * @return false if no consistent state could be read
+ */
+template<class F> bool readConsistent(const FleetShmHeader *header, F f)
+{
+  for (int i = 0; i < MAX_READ_ATTEMPTS; ++i)
+  {
+    const uint32_t seq = header->seq.load(std::memory_order_acquire);
+
+    if ((seq & 1) == 0)
+    {
+      f(std::min(header->count, header->capacity));
+
+      std::atomic_thread_fence(std::memory_order_acquire);
+
+      if (header->seq.load(std::memory_order_relaxed) == seq)
+      {
+        return true;
+      }
+    }
+
+    if (i >= SPIN_READ_ATTEMPTS)
+    {
+      std::this_thread::yield();
+    }
+  }
+
+  return false;
+}
+
+}
+
+FleetShmWriter::FleetShmWriter(const std::string &name, size_t capacity) :
+  name_(name),
+  size_(sizeof(FleetShmHeader) + capacity*sizeof(FleetShmRecord)),
+  header_(nullptr),
+  records_(nullptr)
+{
+  // a segment of a previous writer is removed instead of reused, since
+  // resizing it would crash readers that still have it mapped
+
+  ::shm_unlink(name.c_str());
+
+  const int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+  if (fd == -1)
+  {
+    throw std::runtime_error("Cannot create shared memory " + name + ": " +
+                             strerror(errno));
+  }
+
+  if (::ftruncate(fd, static_cast<off_t>(size_)) == -1)
+  {
+    const int err = errno;
+    ::close(fd);
+    ::shm_unlink(name.c_str());
+    throw std::runtime_error("Cannot resize shared memory " + name + ": " +
+                             strerror(err));
+  }
+
+  void *p = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+
+  if (p == MAP_FAILED)
+  {
+    const int err = errno;
+    ::shm_unlink(name.c_str());
+    throw std::runtime_error("Cannot map shared memory " + name + ": " +
+                             strerror(err));
+  }
+
+  header_ = new (p) FleetShmHeader;
+  records_ = reinterpret_cast<FleetShmRecord *>(header_+1);
+
+  header_->version = FLEET_SHM_VERSION;
+  header_->capacity = static_cast<uint32_t>(capacity);
+  header_->record_size = sizeof(FleetShmRecord);
+  header_->seq.store(0, std::memory_order_relaxed);
+  header_->count = 0;
+  header_->truncated = 0;
+  header_->reserved = 0;
+
+  std::atomic_thread_fence(std::memory_order_release);
+  header_->magic = FLEET_SHM_MAGIC;
+}
+
+FleetShmWriter::~FleetShmWriter()
+{
+  // readers that still have the segment mapped see an empty table
+
+  publish(std::vector<DeviceInfo>());
+
+  ::munmap(header_, size_);
+  ::shm_unlink(name_.c_str());
+}
+
+void FleetShmWriter::publish(const std::vector<DeviceInfo> &devices)
+{
+  const uint32_t seq = header_->seq.load(std::memory_order_relaxed);
+
+  header_->seq.store(seq+1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  const size_t n = std::min(devices.size(),
+                            static_cast<size_t>(header_->capacity));
+
+  for (size_t i = 0; i < n; ++i)
+  {
+    const DeviceInfo &info = devices[i];
+    FleetShmRecord &r = records_[i];
+
+    r.mac = info.getMAC();
+    r.ip = info.getIP();
+    r.subnet = info.getSubnetMask();
+    r.gateway = info.getGateway();
+    r.major = static_cast<uint16_t>(info.getMajorVersion());
+    r.minor = static_cast<uint16_t>(info.getMinorVersion());
+    copyString(r.manufacturer_name, sizeof(r.manufacturer_name),
+               info.getManufacturerName());
+    copyString(r.model_name, sizeof(r.model_name), info.getModelName());
+    copyString(r.device_version, sizeof(r.device_version),
+               info.getDeviceVersion());
+    copyString(r.manufacturer_info, sizeof(r.manufacturer_info),
+               info.getManufacturerInfo());
+    copyString(r.serial_number, sizeof(r.serial_number),
+               info.getSerialNumber());
+    copyString(r.user_name, sizeof(r.user_name), info.getUserName());
+    copyString(r.iface_name, sizeof(r.iface_name), info.getIfaceName());
+  }
+
+  header_->count = static_cast<uint32_t>(n);
+  header_->truncated = static_cast<uint32_t>(devices.size() - n);
+
+  header_->seq.store(seq+2, std::memory_order_release);
+}
+
+FleetShmReader::FleetShmReader(const std::string &name) :
+  size_(0),
+  header_(nullptr),
+  records_(nullptr)
+{
+  const int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd == -1)
+  {
+    throw std::runtime_error("Cannot open shared memory " + name + ": " +
+                             strerror(errno));
+  }
+
+  struct stat st;
+  if (::fstat(fd, &st) == -1 ||
+      static_cast<size_t>(st.st_size) < sizeof(FleetShmHeader))
+  {
+    ::close(fd);
+    throw std::runtime_error("Shared memory " + name + " is not initialized");
+  }
+
+  size_ = static_cast<size_t>(st.st_size);
+
+  void *p = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+
+  if (p == MAP_FAILED)
+  {
+    throw std::runtime_error("Cannot map shared memory " + name + ": " +
+                             strerror(errno));
+  }
+
+  header_ = static_cast<const FleetShmHeader *>(p);
+  records_ = reinterpret_cast<const FleetShmRecord *>(header_+1);
+
+  if (header_->magic != FLEET_SHM_MAGIC ||
+      header_->version != FLEET_SHM_VERSION ||
+      header_->record_size != sizeof(FleetShmRecord) ||
+      sizeof(FleetShmHeader) + header_->capacity*sizeof(FleetShmRecord) > size_)
+  {
+    ::munmap(p, size_);
+    throw std::runtime_error("Shared memory " + name +
+                             " has an unsupported layout");
+  }
+}
+
+FleetShmReader::~FleetShmReader()
+{
+  ::munmap(const_cast<FleetShmHeader *>(header_), size_);
+}
+
+uint32_t FleetShmReader::getGeneration() const
+{
+  return header_->seq.load(std::memory_order_acquire) >> 1;
+}
+
+void FleetShmReader::read(std::vector<FleetShmRecord> &records) const
+{
+  records.reserve(header_->capacity);
+
+  if (!readConsistent(header_, [this, &records](uint32_t n)
+      {
+        records.assign(records_, records_ + n);
+      }))
+  {
+    records.clear();
+    throw std::runtime_error("Shared memory is not consistent, the writer "
+                             "may have died while publishing");
+  }
+}
+
+std::vector<DeviceInfo> FleetShmReader::getDevices() const
+{
+  std::vector<FleetShmRecord> records;
+  read(records);
+
+  std::vector<DeviceInfo> ret;
+  ret.reserve(records.size());
+
+  for (const auto &r : records)
+  {
+    ret.push_back(toDeviceInfo(r));
+  }
+
+  return ret;
+}
+
+bool FleetShmReader::findBySerial(const char *serial,
+                                  FleetShmRecord &record) const
+{
+  const size_t len = strlen(serial);
+  if (len > sizeof(record.serial_number))
+  {
+    return false;
+  }
+
+  bool found = false;
+
+  const bool ok = readConsistent(header_, [&](uint32_t n)
+  {
+    found = false;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+      const char *s = records_[i].serial_number;
+      if (memcmp(s, serial, len) == 0 &&
+          (len == sizeof(record.serial_number) || s[len] == '\0'))
+      {
+        record = records_[i];
+        found = true;
+        break;
+      }
+    }
+  });
+
+  return ok && found;
+}
+
+bool FleetShmReader::findByMAC(uint64_t mac, FleetShmRecord &record) const
+{
+  bool found = false;
+
+  const bool ok = readConsistent(header_, [&](uint32_t n)
+  {
+    found = false;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+      if (records_[i].mac == mac)
+      {
+        record = records_[i];
+        found = true;
+        break;
+      }
+    }
+  });
+
+  return ok && found;
+}
+
+DeviceInfo FleetShmReader::toDeviceInfo(const FleetShmRecord &r)
+{
+  DeviceInfo info(toString(r.iface_name, sizeof(r.iface_name)));
+
+  info.setVersion(r.major, r.minor);
+  info.setMAC(r.mac);
+  info.setIP(r.ip);
+  info.setSubnetMask(r.subnet);
+  info.setGateway(r.gateway);
+  info.setManufacturerName(toString(r.manufacturer_name,
+                                    sizeof(r.manufacturer_name)));
+  info.setModelName(toString(r.model_name, sizeof(r.model_name)));
+  info.setDeviceVersion(toString(r.device_version, sizeof(r.device_version)));
+  info.setManufacturerInfo(toString(r.manufacturer_info,
+                                    sizeof(r.manufacturer_info)));
+  info.setSerialNumber(toString(r.serial_number, sizeof(r.serial_number)));
+  info.setUserName(toString(r.user_name, sizeof(r.user_name)));
+
+  return info;
+}
+
+}
@@ -0,0 +1,213 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RCDISCOVER_FLEET_SHM_H
+#define RCDISCOVER_FLEET_SHM_H
+
+#include "deviceinfo.h"
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace rcdiscover
+{
+
+/**
+ * @brief Default name of the shared memory segment of rcdiscoverd.
+ */
+extern const char * const FLEET_SHM_DEFAULT_NAME;
+
+/**
+ * @brief Fixed size record of one device in shared memory.
+ *
+ * Strings have the size of the corresponding fields of the GigE Vision
+ * discovery acknowledge and are zero padded, but not zero terminated if
+ * they use the full size.
+ */
+struct FleetShmRecord
+{
+  uint64_t mac;
+  uint32_t ip;
+  uint32_t subnet;
+  uint32_t gateway;
+  uint16_t major;
+  uint16_t minor;
+  char manufacturer_name[32];
+  char model_name[32];
+  char device_version[32];
+  char manufacturer_info[48];
+  char serial_number[16];
+  char user_name[16];
+  char iface_name[16];
+};
+
+/**
+ * @brief Header of the shared memory segment, which is followed by capacity
+ * records.
+ *
+ * The writer increments seq before and after changing count or the records,
+ * i.e. readers must retry if seq is odd or has changed while reading
+ * (seqlock).
+ */
+struct FleetShmHeader
+{
+  uint32_t magic;
+  uint32_t version;
+  uint32_t capacity;
+  uint32_t record_size;
+  std::atomic<uint32_t> seq;
+  uint32_t count;
+  uint32_t truncated; ///< number of devices that did not fit
+  uint32_t reserved;
+};
+
+/**
+ * @brief Publishes the device table in a POSIX shared memory segment.
+ *
+ * Only one writer may exist per segment. A segment with the same name is
+ * replaced by a new one, i.e. readers of the old segment keep their mapping
+ * but do not see updates anymore. The segment is removed when the writer is
+ * destroyed.
+ */
+class FleetShmWriter
+{
+  public:
+    /**
+     * @brief Constructor. Creates the shared memory segment.
+     * @param name name of the segment, starting with '/'
+     * @param capacity maximum number of devices
+     * @throws std::runtime_error if the segment cannot be created
+     */
+    explicit FleetShmWriter(const std::string &name = FLEET_SHM_DEFAULT_NAME,
+                            size_t capacity = 1024);
+    ~FleetShmWriter();
+
+    FleetShmWriter(const FleetShmWriter &) = delete;
+    FleetShmWriter &operator=(const FleetShmWriter &) = delete;
+
+    /**
+     * @brief Replaces the published devices.
+     * @param devices devices, e.g. sorted by MAC address
+     */
+    void publish(const std::vector<DeviceInfo> &devices);
+
+  private:
+    std::string name_;
+    size_t size_;
+    FleetShmHeader *header_;
+    FleetShmRecord *records_;
+};
+
+/**
+ * @brief Reads the device table from a shared memory segment that is
+ * published by FleetShmWriter.
+ *
+ * Reading does neither involve system calls nor locks, unless the writer
+ * publishes for an unexpectedly long time (e.g. because it died while
+ * publishing). Then, readers yield the processor and give up after a bounded
+ * number of attempts. The find methods do not allocate memory and can
+ * therefore be used in real-time code.
+ */
+class FleetShmReader
+{
+  public:
+    /**
+     * @brief Constructor. Maps the shared memory segment.
+     * @param name name of the segment, starting with '/'
+     * @throws std::runtime_error if the segment does not exist or has an
+     * incompatible layout
+     */
+    explicit FleetShmReader(const std::string &name = FLEET_SHM_DEFAULT_NAME);
+    ~FleetShmReader();
+
+    FleetShmReader(const FleetShmReader &) = delete;
+    FleetShmReader &operator=(const FleetShmReader &) = delete;
+
+    /**
+     * @brief Returns a number that changes with every publication.
+     * @return generation
+     */
+    uint32_t getGeneration() const;
+
+    /**
+     * @brief Returns a consistent copy of all records.
+     * @param records filled with the records
+     * @throws std::runtime_error if no consistent state could be read
+     */
+    void read(std::vector<FleetShmRecord> &records) const;
+
+    /**
+     * @brief Returns a consistent copy of all devices.
+     * @return devices
+     * @throws std::runtime_error if no consistent state could be read
+     */
+    std::vector<DeviceInfo> getDevices() const;
+
+    /**
+     * @brief Looks up a device by serial number.
+     * @param serial zero terminated serial number
+     * @param record set to the device if found
+     * @return true if found, false if not found or if no consistent state
+     * could be read
+     */
+    bool findBySerial(const char *serial, FleetShmRecord &record) const;
+
+    /**
+     * @brief Looks up a device by MAC address.
+     * @param mac MAC address
+     * @param record set to the device if found
+     * @return true if found, false if not found or if no consistent state
+     * could be read
+     */
+    bool findByMAC(uint64_t mac, FleetShmRecord &record) const;
+
+    /**
+     * @brief Converts a record into a device.
+     * @param record record
+     * @return device
+     */
+    static DeviceInfo toDeviceInfo(const FleetShmRecord &record);
+
+  private:
+    size_t size_;
+    const FleetShmHeader *header_;
+    const FleetShmRecord *records_;
+};
+
+}
+
+#endif // RCDISCOVER_FLEET_SHM_H
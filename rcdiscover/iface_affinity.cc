@@ -0,0 +1,112 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "iface_affinity.h"
+
+#include "deviceinfo.h"
+
+#include <mutex>
+#include <unordered_map>
+
+namespace rcdiscover
+{
+
+namespace
+{
+
+std::mutex &getMutex()
+{
+  static std::mutex mtx;
+  return mtx;
+}
+
+std::unordered_map<uint64_t, std::string> &getMap()
+{
+  static std::unordered_map<uint64_t, std::string> map;
+  return map;
+}
+
+}
+
+void IfaceAffinity::update(uint64_t mac, const std::string &iface_name)
+{
+  if (iface_name.empty())
+  {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(getMutex());
+  getMap()[mac] = iface_name;
+}
+
+void IfaceAffinity::update(const std::vector<DeviceInfo> &devices)
+{
+  std::lock_guard<std::mutex> lock(getMutex());
+
+  for (const auto &info : devices)
+  {
+    if (info.isValid() && !info.getIfaceName().empty())
+    {
+      // most devices answer on the same interface in every round
+
+      std::string &iface_name = getMap()[info.getMAC()];
+      if (iface_name != info.getIfaceName())
+      {
+        iface_name = info.getIfaceName();
+      }
+    }
+  }
+}
+
+std::string IfaceAffinity::lookup(uint64_t mac)
+{
+  std::lock_guard<std::mutex> lock(getMutex());
+
+  const auto it = getMap().find(mac);
+  if (it == getMap().end())
+  {
+    return std::string();
+  }
+
+  return it->second;
+}
+
+void IfaceAffinity::clear()
+{
+  std::lock_guard<std::mutex> lock(getMutex());
+  getMap().clear();
+}
+
+}
@@ -0,0 +1,91 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RCDISCOVER_IFACE_AFFINITY_H
+#define RCDISCOVER_IFACE_AFFINITY_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace rcdiscover
+{
+
+class DeviceInfo;
+
+/**
+ * @brief Process wide record of the interface on which each device answered
+ * most recently.
+ *
+ * It is updated with the devices of each discovery round by
+ * ContinuousDiscover, ResetVerifier and the tools, and used by WOL and
+ * WOLBatch to send magic packets only on the interface on which the device
+ * lives. Users of Discover should pass their results to update(). All
+ * functions are thread-safe.
+ */
+class IfaceAffinity
+{
+  public:
+    /**
+     * @brief Stores the interface on which a device answered.
+     * @param mac MAC address of device
+     * @param iface_name name of interface (ignored if empty)
+     */
+    static void update(uint64_t mac, const std::string &iface_name);
+
+    /**
+     * @brief Stores the interfaces on which the devices of a discovery round
+     * answered. Invalid devices and devices without interface name are
+     * ignored.
+     * @param devices devices
+     */
+    static void update(const std::vector<DeviceInfo> &devices);
+
+    /**
+     * @brief Returns the interface on which a device answered most recently.
+     * @param mac MAC address of device
+     * @return name of interface, empty if the device has not been discovered
+     */
+    static std::string lookup(uint64_t mac);
+
+    /**
+     * @brief Forgets all devices.
+     */
+    static void clear();
+};
+
+}
+
+#endif // RCDISCOVER_IFACE_AFFINITY_H
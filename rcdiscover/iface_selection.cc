@@ -0,0 +1,161 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "iface_selection.h"
+
+#include "utils.h"
+
+#include <stdexcept>
+
+namespace rcdiscover
+{
+
+namespace
+{
+
+/*
+  Matches a string against a pattern with the wildcards '*' for any number
+  of characters and '?' for exactly one character.
+*/
+
+bool matchGlob(const char *p, const char *s)
+{
+  const char *star = nullptr;
+  const char *retry = nullptr;
+
+  while (*s != '\0')
+  {
+    if (*p == '*')
+    {
+      star = ++p;
+      retry = s;
+    }
+    else if (*p == '?' || *p == *s)
+    {
+      p++;
+      s++;
+    }
+    else if (star != nullptr)
+    {
+      // let the last star consume one more character
+
+      p = star;
+      s = ++retry;
+    }
+    else
+    {
+      return false;
+    }
+  }
+
+  while (*p == '*')
+  {
+    p++;
+  }
+
+  return *p == '\0';
+}
+
+}
+
+void InterfaceSelection::include(const std::string &pattern)
+{
+  include_.push_back(parse(pattern));
+}
+
+void InterfaceSelection::exclude(const std::string &pattern)
+{
+  exclude_.push_back(parse(pattern));
+}
+
+bool InterfaceSelection::empty() const
+{
+  return include_.empty() && exclude_.empty();
+}
+
+bool InterfaceSelection::matches(const std::string &name, uint32_t ip) const
+{
+  bool ret = include_.empty();
+
+  for (const Pattern &p : include_)
+  {
+    ret = ret || matches(p, name, ip);
+  }
+
+  for (const Pattern &p : exclude_)
+  {
+    ret = ret && !matches(p, name, ip);
+  }
+
+  return ret;
+}
+
+InterfaceSelection::Pattern InterfaceSelection::parse(
+  const std::string &pattern)
+{
+  Pattern p;
+  p.net = 0;
+  p.mask = 0;
+
+  // a single IP address is taken as subnet of one address
+
+  p.subnet = string2subnet(pattern, p.net, p.mask);
+
+  if (!p.subnet)
+  {
+    if (pattern.find('/') != std::string::npos)
+    {
+      throw std::invalid_argument("Invalid subnet: " + pattern);
+    }
+
+    p.glob = pattern;
+  }
+
+  return p;
+}
+
+bool InterfaceSelection::matches(const Pattern &p, const std::string &name,
+                                 uint32_t ip)
+{
+  if (p.subnet)
+  {
+    return (ip & p.mask) == p.net;
+  }
+
+  return matchGlob(p.glob.c_str(), name.c_str());
+}
+
+}
@@ -0,0 +1,107 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef RCDISCOVER_IFACE_SELECTION_H
+#define RCDISCOVER_IFACE_SELECTION_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace rcdiscover
+{
+
+/**
+ * @brief Selection of the interfaces that are used for discovery.
+ *
+ * Patterns are either interface names with the wildcards '*' and '?', e.g.
+ * "eth*" or "enp3s0", or subnets in CIDR notation, e.g. "10.0.2.0/24", or
+ * single IP addresses, which must contain the IPv4 address of the
+ * interface. On Windows, interfaces are named by their IP address. An interface is used if it matches at least
+ * one include pattern, or if there is none, and no exclude pattern. An empty
+ * selection contains all interfaces.
+ */
+class InterfaceSelection
+{
+  public:
+    /**
+     * @brief Adds a pattern of interfaces to be used.
+     * @param pattern name, glob or subnet
+     * @throws std::invalid_argument if a subnet cannot be parsed
+     */
+    void include(const std::string &pattern);
+
+    /**
+     * @brief Adds a pattern of interfaces not to be used.
+     * @param pattern name, glob or subnet
+     * @throws std::invalid_argument if a subnet cannot be parsed
+     */
+    void exclude(const std::string &pattern);
+
+    /**
+     * @brief Checks if patterns have been added.
+     * @return true if all interfaces are selected
+     */
+    bool empty() const;
+
+    /**
+     * @brief Checks if an interface is selected.
+     * @param name name of interface
+     * @param ip IPv4 address of interface in host byte order
+     * @return true if the interface is selected
+     */
+    bool matches(const std::string &name, uint32_t ip) const;
+
+  private:
+    struct Pattern
+    {
+      std::string glob;
+      bool subnet;
+      uint32_t net;
+      uint32_t mask;
+    };
+
+    static Pattern parse(const std::string &pattern);
+    static bool matches(const Pattern &p, const std::string &name,
+                        uint32_t ip);
+
+    std::vector<Pattern> include_;
+    std::vector<Pattern> exclude_;
+};
+
+}
+
+#endif // RCDISCOVER_IFACE_SELECTION_H
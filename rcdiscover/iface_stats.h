@@ -0,0 +1,75 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RCDISCOVER_IFACE_STATS_H
+#define RCDISCOVER_IFACE_STATS_H
+
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <system_error>
+
+namespace rcdiscover
+{
+
+/**
+ * @brief Discovery counters of one interface, as collected by Discover.
+ *
+ * Latencies are measured from the most recent broadcast on the interface.
+ */
+struct IfaceStats
+{
+  std::string iface_name;        ///< name of interface
+
+  uint64_t broadcasts_sent = 0;  ///< successfully sent discovery requests
+  uint64_t send_errors = 0;      ///< failed discovery requests
+  std::error_code last_error;    ///< error of the last failed request
+
+  uint64_t acks_received = 0;    ///< received packages
+  uint64_t acks_valid = 0;       ///< valid discovery acknowledges
+  uint64_t acks_invalid = 0;     ///< packages that are no valid acknowledge
+  uint64_t acks_filtered = 0;    ///< acknowledges rejected by the filter
+  uint64_t duplicates = 0;       ///< repeated acknowledges of the same device
+  uint64_t kernel_drops = 0;     ///< packages dropped by the kernel (Linux)
+
+  /// latency of the first valid acknowledge, negative if there was none
+  std::chrono::microseconds first_response{-1};
+  /// latency of the last valid acknowledge, negative if there was none
+  std::chrono::microseconds last_response{-1};
+};
+
+}
+
+#endif // RCDISCOVER_IFACE_STATS_H
@@ -0,0 +1,87 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RCDISCOVER_MAPPED_FILE_H
+#define RCDISCOVER_MAPPED_FILE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace rcdiscover
+{
+
+/**
+ * @brief Read-only view of a whole file.
+ *
+ * The file is mapped into memory if supported by the platform and read into
+ * a buffer otherwise. In both cases, the data is aligned to at least 8 bytes.
+ */
+class MappedFile
+{
+  public:
+    /**
+     * @brief Constructor. Maps the file.
+     * @param filename name of file
+     * @throws std::runtime_error if the file cannot be opened
+     */
+    explicit MappedFile(const std::string &filename);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    /**
+     * @brief Returns the content of the file.
+     * @return pointer to the first byte, nullptr if the file is empty
+     */
+    const uint8_t *data() const { return data_; }
+
+    /**
+     * @brief Returns the size of the file.
+     * @return size in bytes
+     */
+    size_t size() const { return size_; }
+
+  private:
+    std::vector<uint8_t> buffer_;
+    void *map_;
+    const uint8_t *data_;
+    size_t size_;
+};
+
+}
+
+#endif // RCDISCOVER_MAPPED_FILE_H
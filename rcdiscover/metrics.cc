@@ -0,0 +1,475 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "metrics.h"
+
+#include <atomic>
+#include <algorithm>
+#include <sstream>
+#include <fstream>
+#include <stdexcept>
+#include <cstdio>
+#include <cstring>
+
+namespace rcdiscover
+{
+
+namespace
+{
+
+const size_t MAX_IFACES = 64;
+
+/*
+  Histogram with fixed upper bounds in microseconds. Only the bucket into
+  which a value falls is counted, cumulative counts are computed on export.
+*/
+
+template<size_t N>
+struct Histogram
+{
+  explicit Histogram(const uint64_t (&b)[N]) : bounds(b)
+  {
+    clear();
+  }
+
+  void observe(std::chrono::microseconds value)
+  {
+    const uint64_t v = static_cast<uint64_t>(std::max<int64_t>(0,
+                                                                value.count()));
+
+    size_t i = 0;
+    while (i < N && v > bounds[i])
+    {
+      i++;
+    }
+
+    buckets[i].fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(v, std::memory_order_relaxed);
+  }
+
+  void clear()
+  {
+    for (auto &b : buckets)
+    {
+      b.store(0, std::memory_order_relaxed);
+    }
+    sum.store(0, std::memory_order_relaxed);
+  }
+
+  const uint64_t (&bounds)[N];
+  std::atomic<uint64_t> buckets[N+1];
+  std::atomic<uint64_t> sum;
+};
+
+const uint64_t SCAN_BOUNDS[] = {10000, 25000, 50000, 100000, 250000, 500000,
+                                1000000, 2500000, 5000000, 10000000};
+
+const uint64_t RTT_BOUNDS[] = {100, 250, 500, 1000, 2500, 5000, 10000, 25000,
+                               50000, 100000, 250000, 500000, 1000000};
+
+/*
+  Counters of one interface. A slot is claimed once by a compare and swap of
+  state from FREE to CLAIMED, and published by setting state to READY after
+  the name has been written.
+*/
+
+enum SlotState { FREE=0, CLAIMED=1, READY=2 };
+
+struct IfaceSlot
+{
+  std::atomic<int> state;
+  char name[32];
+  std::atomic<uint64_t> devices;
+  std::atomic<uint64_t> broadcasts;
+  std::atomic<uint64_t> send_errors;
+  std::atomic<uint64_t> acks_valid;
+  std::atomic<uint64_t> acks_invalid;
+  std::atomic<uint64_t> duplicates;
+  std::atomic<uint64_t> kernel_drops;
+};
+
+const char * const RESET_NAMES[] = {"params", "gige", "partition", "all",
+                                    "other"};
+
+struct Registry
+{
+  Registry() : scan_duration(SCAN_BOUNDS), reachability_rtt(RTT_BOUNDS)
+  {
+    clear();
+  }
+
+  void clear()
+  {
+    scan_duration.clear();
+    scan_errors.store(0, std::memory_order_relaxed);
+    reachability_rtt.clear();
+    unreachable.store(0, std::memory_order_relaxed);
+
+    for (auto &r : resets)
+    {
+      r.store(0, std::memory_order_relaxed);
+    }
+
+    for (auto &slot : ifaces)
+    {
+      slot.state.store(FREE, std::memory_order_relaxed);
+      slot.name[0] = '\0';
+      slot.devices.store(0, std::memory_order_relaxed);
+      slot.broadcasts.store(0, std::memory_order_relaxed);
+      slot.send_errors.store(0, std::memory_order_relaxed);
+      slot.acks_valid.store(0, std::memory_order_relaxed);
+      slot.acks_invalid.store(0, std::memory_order_relaxed);
+      slot.duplicates.store(0, std::memory_order_relaxed);
+      slot.kernel_drops.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  /*
+    Returns the slot of the given interface, or null if all slots are used.
+  */
+
+  IfaceSlot *getSlot(const std::string &name)
+  {
+    std::string n = name.substr(0, sizeof(IfaceSlot::name)-1);
+
+    for (auto &slot : ifaces)
+    {
+      int state = slot.state.load(std::memory_order_acquire);
+
+      if (state == FREE)
+      {
+        if (slot.state.compare_exchange_strong(state, CLAIMED,
+                                               std::memory_order_acquire))
+        {
+          std::strcpy(slot.name, n.c_str());
+          slot.state.store(READY, std::memory_order_release);
+          return &slot;
+        }
+      }
+
+      // wait for a concurrent claim of the same slot, which is short
+
+      while (state == CLAIMED)
+      {
+        state = slot.state.load(std::memory_order_acquire);
+      }
+
+      if (n == slot.name)
+      {
+        return &slot;
+      }
+    }
+
+    return nullptr;
+  }
+
+  Histogram<sizeof(SCAN_BOUNDS)/sizeof(uint64_t)> scan_duration;
+  std::atomic<uint64_t> scan_errors;
+  Histogram<sizeof(RTT_BOUNDS)/sizeof(uint64_t)> reachability_rtt;
+  std::atomic<uint64_t> unreachable;
+  std::atomic<uint64_t> resets[5];
+  IfaceSlot ifaces[MAX_IFACES];
+};
+
+Registry &getRegistry()
+{
+  static Registry registry;
+  return registry;
+}
+
+/*
+  Escapes a label value.
+*/
+
+std::string escape(const char *s)
+{
+  std::string ret;
+  for (; *s != '\0'; s++)
+  {
+    if (*s == '\\' || *s == '"')
+    {
+      ret.push_back('\\');
+      ret.push_back(*s);
+    }
+    else if (*s == '\n')
+    {
+      ret += "\\n";
+    }
+    else
+    {
+      ret.push_back(*s);
+    }
+  }
+  return ret;
+}
+
+/*
+  Prints microseconds as seconds without rounding and trailing zeros.
+*/
+
+void formatSeconds(std::ostream &out, uint64_t us)
+{
+  out << us/1000000;
+
+  char frac[8];
+  std::snprintf(frac, sizeof(frac), "%06u",
+                static_cast<unsigned int>(us%1000000));
+
+  size_t n = std::strlen(frac);
+  while (n > 0 && frac[n-1] == '0')
+  {
+    frac[--n] = '\0';
+  }
+
+  if (n > 0)
+  {
+    out << '.' << frac;
+  }
+}
+
+template<size_t N>
+void formatHistogram(std::ostream &out, const char *name, const char *help,
+                     const Histogram<N> &h)
+{
+  out << "# HELP " << name << ' ' << help << '\n';
+  out << "# TYPE " << name << " histogram\n";
+
+  uint64_t count = 0;
+  for (size_t i = 0; i < N; i++)
+  {
+    count += h.buckets[i].load(std::memory_order_relaxed);
+    out << name << "_bucket{le=\"";
+    formatSeconds(out, h.bounds[i]);
+    out << "\"} " << count << '\n';
+  }
+
+  count += h.buckets[N].load(std::memory_order_relaxed);
+  out << name << "_bucket{le=\"+Inf\"} " << count << '\n';
+
+  out << name << "_sum ";
+  formatSeconds(out, h.sum.load(std::memory_order_relaxed));
+  out << '\n';
+  out << name << "_count " << count << '\n';
+}
+
+void formatIfaceMetric(std::ostream &out, const Registry &r, const char *name,
+                       const char *type, const char *help,
+                       std::atomic<uint64_t> IfaceSlot::*value)
+{
+  out << "# HELP " << name << ' ' << help << '\n';
+  out << "# TYPE " << name << ' ' << type << '\n';
+
+  for (const auto &slot : r.ifaces)
+  {
+    if (slot.state.load(std::memory_order_acquire) == READY)
+    {
+      out << name << "{interface=\"" << escape(slot.name) << "\"} "
+          << (slot.*value).load(std::memory_order_relaxed) << '\n';
+    }
+  }
+}
+
+}
+
+void Metrics::recordScan(std::chrono::microseconds duration, bool success)
+{
+  Registry &r = getRegistry();
+
+  if (success)
+  {
+    r.scan_duration.observe(duration);
+  }
+  else
+  {
+    r.scan_errors.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void Metrics::recordInterfaces(const std::vector<IfaceStats> &stats,
+                                const std::vector<DeviceInfo> &devices)
+{
+  for (const auto &st : stats)
+  {
+    IfaceSlot *slot = getRegistry().getSlot(st.iface_name);
+
+    if (slot == nullptr)
+    {
+      continue;
+    }
+
+    // responses may contain the same device more than once
+
+    std::vector<uint64_t> macs;
+    for (const auto &info : devices)
+    {
+      if (info.isValid() && info.getIfaceName() == st.iface_name &&
+          std::find(macs.begin(), macs.end(), info.getMAC()) == macs.end())
+      {
+        macs.push_back(info.getMAC());
+      }
+    }
+
+    slot->devices.store(macs.size(), std::memory_order_relaxed);
+    slot->broadcasts.fetch_add(st.broadcasts_sent, std::memory_order_relaxed);
+    slot->send_errors.fetch_add(st.send_errors, std::memory_order_relaxed);
+    slot->acks_valid.fetch_add(st.acks_valid, std::memory_order_relaxed);
+    slot->acks_invalid.fetch_add(st.acks_invalid, std::memory_order_relaxed);
+    slot->duplicates.fetch_add(st.duplicates, std::memory_order_relaxed);
+    slot->kernel_drops.fetch_add(st.kernel_drops, std::memory_order_relaxed);
+  }
+}
+
+void Metrics::recordReachability(bool reachable,
+                                 std::chrono::microseconds rtt)
+{
+  Registry &r = getRegistry();
+
+  if (reachable)
+  {
+    r.reachability_rtt.observe(rtt);
+  }
+  else
+  {
+    r.unreachable.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void Metrics::recordReset(uint8_t func_id, uint64_t count)
+{
+  size_t i;
+  switch (func_id)
+  {
+    case 0xAA: i = 0; break;
+    case 0xBB: i = 1; break;
+    case 0xCC: i = 2; break;
+    case 0xFF: i = 3; break;
+    default: i = 4; break;
+  }
+
+  getRegistry().resets[i].fetch_add(count, std::memory_order_relaxed);
+}
+
+std::string Metrics::format()
+{
+  const Registry &r = getRegistry();
+  std::ostringstream out;
+
+  formatHistogram(out, "rcdiscover_scan_duration_seconds",
+                  "Duration of successful discovery rounds.",
+                  r.scan_duration);
+
+  out << "# HELP rcdiscover_scan_errors_total Discovery rounds that failed.\n";
+  out << "# TYPE rcdiscover_scan_errors_total counter\n";
+  out << "rcdiscover_scan_errors_total "
+      << r.scan_errors.load(std::memory_order_relaxed) << '\n';
+
+  formatIfaceMetric(out, r, "rcdiscover_devices", "gauge",
+                    "Devices that answered in the last round.",
+                    &IfaceSlot::devices);
+  formatIfaceMetric(out, r, "rcdiscover_broadcasts_total", "counter",
+                    "Sent discovery requests.", &IfaceSlot::broadcasts);
+  formatIfaceMetric(out, r, "rcdiscover_send_errors_total", "counter",
+                    "Discovery requests that could not be sent.",
+                    &IfaceSlot::send_errors);
+  formatIfaceMetric(out, r, "rcdiscover_acks_valid_total", "counter",
+                    "Valid discovery acknowledges.", &IfaceSlot::acks_valid);
+  formatIfaceMetric(out, r, "rcdiscover_acks_invalid_total", "counter",
+                    "Received packages that are no valid acknowledge.",
+                    &IfaceSlot::acks_invalid);
+  formatIfaceMetric(out, r, "rcdiscover_acks_duplicate_total", "counter",
+                    "Repeated acknowledges of the same device.",
+                    &IfaceSlot::duplicates);
+  formatIfaceMetric(out, r, "rcdiscover_kernel_drops_total", "counter",
+                    "Packages dropped by the kernel.",
+                    &IfaceSlot::kernel_drops);
+
+  formatHistogram(out, "rcdiscover_reachability_rtt_seconds",
+                  "Round trip time of successful reachability checks.",
+                  r.reachability_rtt);
+
+  out << "# HELP rcdiscover_unreachable_total Reachability checks without answer.\n";
+  out << "# TYPE rcdiscover_unreachable_total counter\n";
+  out << "rcdiscover_unreachable_total "
+      << r.unreachable.load(std::memory_order_relaxed) << '\n';
+
+  out << "# HELP rcdiscover_resets_total Devices to which a reset request has been sent.\n";
+  out << "# TYPE rcdiscover_resets_total counter\n";
+  for (size_t i = 0; i < 5; i++)
+  {
+    out << "rcdiscover_resets_total{function=\"" << RESET_NAMES[i] << "\"} "
+        << r.resets[i].load(std::memory_order_relaxed) << '\n';
+  }
+
+  return out.str();
+}
+
+void Metrics::writeTextfile(const std::string &filename)
+{
+  const std::string data = format();
+
+  // write to temporary file and rename, so that collectors never see a
+  // partially written file
+
+  const std::string tmp = filename + ".tmp";
+
+  {
+    std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+    out << data;
+    out.close();
+
+    if (!out)
+    {
+      std::remove(tmp.c_str());
+      throw std::runtime_error("Cannot write metrics: " + filename);
+    }
+  }
+
+#ifdef WIN32
+  std::remove(filename.c_str());
+#endif
+
+  if (std::rename(tmp.c_str(), filename.c_str()) != 0)
+  {
+    std::remove(tmp.c_str());
+    throw std::runtime_error("Cannot write metrics: " + filename);
+  }
+}
+
+void Metrics::clear()
+{
+  getRegistry().clear();
+}
+
+}
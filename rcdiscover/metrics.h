@@ -0,0 +1,115 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RCDISCOVER_METRICS_H
+#define RCDISCOVER_METRICS_H
+
+#include "iface_stats.h"
+#include "deviceinfo.h"
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+namespace rcdiscover
+{
+
+/**
+ * @brief Process wide metrics of discovery, reachability checks and resets
+ * that can be exported in the Prometheus text exposition format.
+ *
+ * Recording only uses relaxed atomic operations on preallocated counters,
+ * so that it does not disturb the timing of discovery. Up to 64 interfaces
+ * are tracked, further interfaces are ignored. All functions are
+ * thread-safe.
+ */
+class Metrics
+{
+  public:
+    /**
+     * @brief Records the duration of a discovery round.
+     * @param duration duration of round
+     * @param success false if the round failed with an exception
+     */
+    static void recordScan(std::chrono::microseconds duration, bool success);
+
+    /**
+     * @brief Records the counters of all interfaces of a discovery round.
+     * @param stats counters of the round, which are added
+     * @param devices responses of the round, which are counted per interface
+     */
+    static void recordInterfaces(const std::vector<IfaceStats> &stats,
+                                 const std::vector<DeviceInfo> &devices);
+
+    /**
+     * @brief Records the result of a reachability check.
+     * @param reachable true if the device answered
+     * @param rtt round trip time, ignored if the device did not answer
+     */
+    static void recordReachability(bool reachable,
+                                   std::chrono::microseconds rtt);
+
+    /**
+     * @brief Records sent reset requests.
+     * @param func_id reset function (see WOLBatch)
+     * @param count number of devices
+     */
+    static void recordReset(uint8_t func_id, uint64_t count=1);
+
+    /**
+     * @brief Returns all metrics in the Prometheus text exposition format.
+     * @return metrics
+     */
+    static std::string format();
+
+    /**
+     * @brief Writes all metrics to a file, e.g. for the textfile collector of
+     * the Prometheus node exporter. The file is replaced atomically.
+     * @param filename name of file
+     * @throws std::runtime_error if the file cannot be written
+     */
+    static void writeTextfile(const std::string &filename);
+
+    /**
+     * @brief Sets all metrics to zero and forgets all interfaces. Must not be
+     * called concurrently with recording.
+     */
+    static void clear();
+};
+
+}
+
+#endif // RCDISCOVER_METRICS_H
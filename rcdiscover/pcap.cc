@@ -0,0 +1,386 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "pcap.h"
+
+#include <chrono>
+#include <stdexcept>
+
+namespace rcdiscover
+{
+
+namespace
+{
+
+const uint32_t PCAP_MAGIC = 0xa1b2c3d4;
+const uint32_t PCAP_MAGIC_NSEC = 0xa1b23c4d;
+
+const uint32_t LINKTYPE_ETHERNET = 1;
+const uint32_t LINKTYPE_RAW = 101;
+const uint32_t LINKTYPE_LINUX_SLL = 113;
+const uint32_t LINKTYPE_IPV4 = 228;
+
+const uint32_t SNAPLEN = 65535;
+
+inline void put16le(uint8_t *p, uint16_t v)
+{
+  p[0] = static_cast<uint8_t>(v);
+  p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+inline void put32le(uint8_t *p, uint32_t v)
+{
+  for (int i = 0; i < 4; ++i)
+  {
+    p[i] = static_cast<uint8_t>(v >> (8*i));
+  }
+}
+
+inline void put16be(uint8_t *p, uint16_t v)
+{
+  p[0] = static_cast<uint8_t>(v >> 8);
+  p[1] = static_cast<uint8_t>(v);
+}
+
+inline void put32be(uint8_t *p, uint32_t v)
+{
+  for (int i = 0; i < 4; ++i)
+  {
+    p[i] = static_cast<uint8_t>(v >> (8*(3-i)));
+  }
+}
+
+inline uint16_t get16be(const uint8_t *p)
+{
+  return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+inline uint32_t get32be(const uint8_t *p)
+{
+  return (static_cast<uint32_t>(p[0]) << 24) |
+         (static_cast<uint32_t>(p[1]) << 16) |
+         (static_cast<uint32_t>(p[2]) << 8) |
+         static_cast<uint32_t>(p[3]);
+}
+
+inline uint32_t get32le(const uint8_t *p)
+{
+  return (static_cast<uint32_t>(p[3]) << 24) |
+         (static_cast<uint32_t>(p[2]) << 16) |
+         (static_cast<uint32_t>(p[1]) << 8) |
+         static_cast<uint32_t>(p[0]);
+}
+
+/*
+  Computes the internet checksum of an IPv4 header.
+*/
+
+uint16_t ipChecksum(const uint8_t *p, size_t len)
+{
+  uint32_t sum = 0;
+  for (size_t i = 0; i+1 < len; i += 2)
+  {
+    sum += get16be(p+i);
+  }
+
+  while (sum >> 16)
+  {
+    sum = (sum & 0xffff) + (sum >> 16);
+  }
+
+  return static_cast<uint16_t>(~sum);
+}
+
+}
+
+PcapWriter::PcapWriter(const std::string &filename) :
+  out_(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc),
+  ip_id_(0)
+{
+  if (!out_)
+  {
+    throw std::runtime_error("Cannot create pcap file: " + filename);
+  }
+
+  uint8_t header[24];
+  put32le(header, PCAP_MAGIC);
+  put16le(header+4, 2);
+  put16le(header+6, 4);
+  put32le(header+8, 0);
+  put32le(header+12, 0);
+  put32le(header+16, SNAPLEN);
+  put32le(header+20, LINKTYPE_RAW);
+
+  out_.write(reinterpret_cast<const char *>(header), sizeof(header));
+  out_.flush();
+}
+
+void PcapWriter::write(uint32_t src_ip, uint16_t src_port,
+                       uint32_t dst_ip, uint16_t dst_port,
+                       const uint8_t *data, size_t len)
+{
+  const auto now = std::chrono::system_clock::now().time_since_epoch();
+  const auto usec =
+      std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+
+  PcapPacket packet;
+  packet.ts_sec = static_cast<uint32_t>(usec / 1000000);
+  packet.ts_usec = static_cast<uint32_t>(usec % 1000000);
+  packet.src_ip = src_ip;
+  packet.src_port = src_port;
+  packet.dst_ip = dst_ip;
+  packet.dst_port = dst_port;
+  packet.payload.assign(data, data+len);
+
+  write(packet);
+}
+
+void PcapWriter::write(const PcapPacket &packet)
+{
+  const size_t len = packet.payload.size();
+  if (len > SNAPLEN - 28)
+  {
+    throw std::invalid_argument("UDP payload too large for pcap record");
+  }
+
+  // record header, IPv4 header and UDP header
+
+  uint8_t header[16+20+8];
+  uint8_t *ip = header+16;
+  uint8_t *udp = ip+20;
+
+  put32le(header, packet.ts_sec);
+  put32le(header+4, packet.ts_usec);
+  put32le(header+8, static_cast<uint32_t>(len+28));
+  put32le(header+12, static_cast<uint32_t>(len+28));
+
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  ip[0] = 0x45;
+  ip[1] = 0;
+  put16be(ip+2, static_cast<uint16_t>(len+28));
+  put16be(ip+4, ip_id_++);
+  put16be(ip+6, 0x4000);
+  ip[8] = 64;
+  ip[9] = 17;
+  put16be(ip+10, 0);
+  put32be(ip+12, packet.src_ip);
+  put32be(ip+16, packet.dst_ip);
+  put16be(ip+10, ipChecksum(ip, 20));
+
+  put16be(udp, packet.src_port);
+  put16be(udp+2, packet.dst_port);
+  put16be(udp+4, static_cast<uint16_t>(len+8));
+  put16be(udp+6, 0);
+
+  out_.write(reinterpret_cast<const char *>(header), sizeof(header));
+  out_.write(reinterpret_cast<const char *>(packet.payload.data()),
+             static_cast<std::streamsize>(len));
+  out_.flush();
+}
+
+PcapReader::PcapReader(const std::string &filename) :
+  in_(filename.c_str(), std::ios::in | std::ios::binary),
+  swapped_(false),
+  nano_(false),
+  linktype_(0)
+{
+  if (!in_)
+  {
+    throw std::runtime_error("Cannot open pcap file: " + filename);
+  }
+
+  uint8_t header[24];
+  if (!in_.read(reinterpret_cast<char *>(header), sizeof(header)))
+  {
+    throw std::runtime_error("Not a pcap file: " + filename);
+  }
+
+  // the byte order of the file is given by the byte order of the magic number
+
+  uint32_t magic = get32be(header);
+  if (magic != PCAP_MAGIC && magic != PCAP_MAGIC_NSEC)
+  {
+    magic = get32le(header);
+    swapped_ = true;
+  }
+
+  if (magic != PCAP_MAGIC && magic != PCAP_MAGIC_NSEC)
+  {
+    throw std::runtime_error("Not a pcap file: " + filename);
+  }
+
+  nano_ = (magic == PCAP_MAGIC_NSEC);
+
+  linktype_ = get32(header+20) & 0xffff;
+
+  if (linktype_ != LINKTYPE_ETHERNET && linktype_ != LINKTYPE_RAW &&
+      linktype_ != LINKTYPE_LINUX_SLL && linktype_ != LINKTYPE_IPV4)
+  {
+    throw std::runtime_error("Unsupported link type " +
+                             std::to_string(linktype_) + " in pcap file: " +
+                             filename);
+  }
+}
+
+uint32_t PcapReader::get32(const uint8_t *p) const
+{
+  return swapped_ ? get32le(p) : get32be(p);
+}
+
+bool PcapReader::next(PcapPacket &packet)
+{
+  std::vector<uint8_t> record;
+
+  while (true)
+  {
+    uint8_t header[16];
+    in_.read(reinterpret_cast<char *>(header), sizeof(header));
+    if (in_.gcount() == 0)
+    {
+      return false;
+    }
+    if (in_.gcount() != sizeof(header))
+    {
+      throw std::runtime_error("Truncated pcap record header");
+    }
+
+    const uint32_t caplen = get32(header+8);
+    if (caplen > 262144)
+    {
+      throw std::runtime_error("Invalid pcap record length");
+    }
+
+    record.resize(caplen);
+    if (!in_.read(reinterpret_cast<char *>(record.data()), caplen))
+    {
+      throw std::runtime_error("Truncated pcap record");
+    }
+
+    packet.ts_sec = get32(header);
+    packet.ts_usec = get32(header+4);
+    if (nano_)
+    {
+      packet.ts_usec /= 1000;
+    }
+
+    if (decode(record, packet))
+    {
+      return true;
+    }
+  }
+}
+
+bool PcapReader::decode(const std::vector<uint8_t> &record,
+                        PcapPacket &packet) const
+{
+  const uint8_t *p = record.data();
+  size_t n = record.size();
+
+  // strip link layer header
+
+  if (linktype_ == LINKTYPE_ETHERNET)
+  {
+    if (n < 14)
+    {
+      return false;
+    }
+
+    uint16_t type = get16be(p+12);
+    p += 14;
+    n -= 14;
+
+    while (type == 0x8100 || type == 0x88a8)
+    {
+      if (n < 4)
+      {
+        return false;
+      }
+
+      type = get16be(p+2);
+      p += 4;
+      n -= 4;
+    }
+
+    if (type != 0x0800)
+    {
+      return false;
+    }
+  }
+  else if (linktype_ == LINKTYPE_LINUX_SLL)
+  {
+    if (n < 16 || get16be(p+14) != 0x0800)
+    {
+      return false;
+    }
+
+    p += 16;
+    n -= 16;
+  }
+
+  // IPv4 header
+
+  if (n < 20 || (p[0] >> 4) != 4 || p[9] != 17)
+  {
+    return false;
+  }
+
+  const size_t ihl = static_cast<size_t>(p[0] & 0x0f)*4;
+  const size_t total = get16be(p+2);
+  if (ihl < 20 || total < ihl+8 || total > n || (get16be(p+6) & 0x3fff) != 0)
+  {
+    return false;
+  }
+
+  packet.src_ip = get32be(p+12);
+  packet.dst_ip = get32be(p+16);
+
+  // UDP header
+
+  const uint8_t *udp = p+ihl;
+  const size_t udp_len = get16be(udp+4);
+  if (udp_len < 8 || ihl+udp_len > total)
+  {
+    return false;
+  }
+
+  packet.src_port = get16be(udp);
+  packet.dst_port = get16be(udp+2);
+  packet.payload.assign(udp+8, udp+udp_len);
+
+  return true;
+}
+
+}
@@ -0,0 +1,165 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RCDISCOVER_PCAP_H
+#define RCDISCOVER_PCAP_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <mutex>
+#include <cstdint>
+
+namespace rcdiscover
+{
+
+/**
+ * @brief UDP datagram that is stored in or read from a pcap capture file.
+ *
+ * Addresses and ports are given in host byte order.
+ */
+struct PcapPacket
+{
+  uint32_t ts_sec;
+  uint32_t ts_usec;
+
+  uint32_t src_ip;
+  uint16_t src_port;
+  uint32_t dst_ip;
+  uint16_t dst_port;
+
+  std::vector<uint8_t> payload;
+};
+
+/**
+ * @brief Writes UDP datagrams to a file in the classic pcap format.
+ *
+ * Datagrams are stored with link type RAW (IPv4 header without link layer
+ * header), so that the file can be inspected with Wireshark or tcpdump. The
+ * writer may be shared by multiple threads.
+ */
+class PcapWriter
+{
+  public:
+    /**
+     * @brief Constructor. Creates the file and writes the pcap file header.
+     * @param filename name of file
+     * @throws std::runtime_error if the file cannot be created
+     */
+    explicit PcapWriter(const std::string &filename);
+
+    PcapWriter(const PcapWriter &) = delete;
+    PcapWriter &operator=(const PcapWriter &) = delete;
+
+    /**
+     * @brief Writes a datagram, using the current time as time stamp.
+     * @param src_ip source IPv4 address (host byte order)
+     * @param src_port source port (host byte order)
+     * @param dst_ip destination IPv4 address (host byte order)
+     * @param dst_port destination port (host byte order)
+     * @param data UDP payload
+     * @param len length of UDP payload
+     */
+    void write(uint32_t src_ip, uint16_t src_port,
+               uint32_t dst_ip, uint16_t dst_port,
+               const uint8_t *data, size_t len);
+
+    /**
+     * @brief Writes a datagram with the time stamp given in the packet.
+     * @param packet packet to write
+     */
+    void write(const PcapPacket &packet);
+
+  private:
+    std::mutex mtx_;
+    std::ofstream out_;
+    uint16_t ip_id_;
+};
+
+/**
+ * @brief Reads UDP datagrams from a file in the classic pcap format.
+ *
+ * Supported link types are Ethernet (including 802.1Q VLAN tags), Linux
+ * cooked capture (tcpdump -i any) and RAW IPv4. Records that do not contain
+ * an unfragmented IPv4 UDP datagram are skipped.
+ */
+class PcapReader
+{
+  public:
+    /**
+     * @brief Constructor. Opens the file and reads the pcap file header.
+     * @param filename name of file
+     * @throws std::runtime_error if the file cannot be opened or is not a
+     * supported pcap file
+     */
+    explicit PcapReader(const std::string &filename);
+
+    PcapReader(const PcapReader &) = delete;
+    PcapReader &operator=(const PcapReader &) = delete;
+
+    /**
+     * @brief Reads the next UDP datagram.
+     * @param packet packet that is filled with the datagram
+     * @return false if the end of the file is reached
+     * @throws std::runtime_error if the file is truncated
+     */
+    bool next(PcapPacket &packet);
+
+  private:
+    /**
+     * @brief Reads a 32 bit value in the byte order of the file.
+     * @param p pointer to 4 bytes
+     * @return value
+     */
+    uint32_t get32(const uint8_t *p) const;
+
+    /**
+     * @brief Extracts the UDP datagram from a record.
+     * @param record captured bytes of the record
+     * @param packet packet that is filled with addresses and payload
+     * @return false if the record does not contain a UDP datagram
+     */
+    bool decode(const std::vector<uint8_t> &record, PcapPacket &packet) const;
+
+  private:
+    std::ifstream in_;
+    bool swapped_;
+    bool nano_;
+    uint32_t linktype_;
+};
+
+}
+
+#endif // RCDISCOVER_PCAP_H
@@ -36,8 +36,15 @@
 #include "ping.h"
 
 #include "socket_exception.h"
+#include "cancel_token.h"
+#include "metrics.h"
 #include "utils.h"
 
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
 #ifdef WIN32
 
 #include <winsock2.h>
@@ -46,6 +53,12 @@
 
 #else
 
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <poll.h>
+
 #endif
 
 namespace rcdiscover
@@ -79,22 +92,246 @@ bool checkReachabilityOfSensor(const DeviceInfo &info)
 
   IcmpCloseHandle(h_icmp);
 
-  if (result != 0 &&
-      reinterpret_cast<ICMP_ECHO_REPLY *>(reply_buffer)->Status == IP_SUCCESS)
+  const ICMP_ECHO_REPLY *reply =
+    reinterpret_cast<ICMP_ECHO_REPLY *>(reply_buffer);
+
+  const bool reachable = (result != 0 && reply->Status == IP_SUCCESS);
+  const std::chrono::milliseconds rtt(reachable ? reply->RoundTripTime : 0);
+
+  free(reply_buffer);
+
+  Metrics::recordReachability(reachable, rtt);
+
+  return reachable;
+}
+
+Pinger::Pinger() :
+  fd_(-1),
+  raw_(false),
+  seq_(0)
+{ }
+
+Pinger::~Pinger()
+{ }
+
+void Pinger::ping(const std::vector<uint32_t> &ips,
+                  std::chrono::milliseconds timeout,
+                  const std::function<void(const PingResult &)> &callback)
+{
+  if (ips.empty())
+  {
+    return;
+  }
+
+  HANDLE h_icmp = IcmpCreateFile();
+  if (h_icmp == INVALID_HANDLE_VALUE)
   {
-    return true;
+    throw SocketException("Unable to create ICMP socket", GetLastError());
   }
-  else
+
+  char data[] = "data";
+  const DWORD reply_size = sizeof(ICMP_ECHO_REPLY) + sizeof(data) + 8;
+
+  struct Request
   {
-    return false;
+    uint32_t ip;
+    HANDLE event;
+    std::vector<char> reply;
+  };
+
+  std::vector<Request> requests(ips.size());
+  std::vector<size_t> pending;
+
+  // all requests are sent asynchronously, each one signals its own event
+
+  for (size_t i = 0; i < ips.size(); i++)
+  {
+    Request &r = requests[i];
+    r.ip = ips[i];
+    r.event = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    r.reply.resize(reply_size);
+
+    DWORD ret = 0;
+    if (r.event != nullptr)
+    {
+      ret = IcmpSendEcho2(h_icmp, r.event, nullptr, nullptr, htonl(r.ip),
+                          data, sizeof(data), nullptr, r.reply.data(),
+                          reply_size, static_cast<DWORD>(timeout.count()));
+    }
+
+    if (r.event != nullptr && (ret != 0 || GetLastError() == ERROR_IO_PENDING))
+    {
+      pending.push_back(i);
+    }
+    else
+    {
+      Metrics::recordReachability(false, std::chrono::microseconds(0));
+      callback(PingResult{r.ip, false, std::chrono::microseconds(0)});
+    }
+  }
+
+  // WaitForMultipleObjects is limited to MAXIMUM_WAIT_OBJECTS handles, so
+  // that the events are waited for in groups
+
+  const auto deadline = std::chrono::steady_clock::now() + timeout +
+                        std::chrono::milliseconds(100);
+
+  while (!pending.empty() && std::chrono::steady_clock::now() < deadline)
+  {
+    if (isCancelled())
+    {
+      pending.clear();
+      break;
+    }
+
+    // waiting is limited to notice cancellation
+
+    const auto remaining = std::min<std::chrono::milliseconds>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+        deadline - std::chrono::steady_clock::now()),
+      std::chrono::milliseconds(cancel_ ? 50 : 1000000));
+
+    bool progress = false;
+    for (size_t start = 0; start < pending.size(); )
+    {
+      const size_t n = std::min<size_t>(pending.size() - start,
+                                        MAXIMUM_WAIT_OBJECTS);
+
+      HANDLE events[MAXIMUM_WAIT_OBJECTS];
+      for (size_t k = 0; k < n; k++)
+      {
+        events[k] = requests[pending[start+k]].event;
+      }
+
+      const DWORD wait = (pending.size() <= MAXIMUM_WAIT_OBJECTS) ?
+        static_cast<DWORD>(std::max<int64_t>(remaining.count(), 0)) : 0;
+      const DWORD ret = WaitForMultipleObjects(static_cast<DWORD>(n), events,
+                                               FALSE, wait);
+
+      if (ret >= WAIT_OBJECT_0 && ret < WAIT_OBJECT_0 + n)
+      {
+        const size_t k = start + (ret - WAIT_OBJECT_0);
+        Request &r = requests[pending[k]];
+
+        const bool reachable =
+          IcmpParseReplies(r.reply.data(), reply_size) > 0 &&
+          reinterpret_cast<const ICMP_ECHO_REPLY *>(
+            r.reply.data())->Status == IP_SUCCESS;
+        const std::chrono::milliseconds rtt(reachable ?
+          reinterpret_cast<const ICMP_ECHO_REPLY *>(
+            r.reply.data())->RoundTripTime : 0);
+
+        pending.erase(pending.begin() + k);
+        progress = true;
+
+        Metrics::recordReachability(reachable, rtt);
+        callback(PingResult{r.ip, reachable, rtt});
+      }
+      else
+      {
+        start += n;
+      }
+    }
+
+    if (!progress && pending.size() > MAXIMUM_WAIT_OBJECTS)
+    {
+      Sleep(1);
+    }
+  }
+
+  if (!isCancelled())
+  {
+    for (size_t i : pending)
+    {
+      Metrics::recordReachability(false, std::chrono::microseconds(0));
+      callback(PingResult{requests[i].ip, false,
+                          std::chrono::microseconds(0)});
+    }
+  }
+
+  // closing the handle cancels requests that are still pending
+
+  IcmpCloseHandle(h_icmp);
+
+  for (Request &r : requests)
+  {
+    if (r.event != nullptr)
+    {
+      CloseHandle(r.event);
+    }
   }
 }
 
 #else
 
+namespace
+{
+
+/*
+  Reads the output of the ping command until it exits and returns whether
+  the host answered. The round trip time is taken from the output of ping,
+  which is more accurate than the run time of the command.
+*/
+
+bool finishPingCommand(FILE *in, std::chrono::steady_clock::time_point start,
+                       std::chrono::microseconds &rtt)
+{
+  rtt = std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now() - start);
+  bool have_rtt = false;
+
+  char line[256];
+  while (fgets(line, sizeof(line), in) != nullptr)
+  {
+    const char *p = strstr(line, "time=");
+    if (p != nullptr && !have_rtt)
+    {
+      rtt = std::chrono::microseconds(
+        static_cast<int64_t>(std::strtod(p+5, nullptr)*1000.0));
+      have_rtt = true;
+    }
+  }
+
+  const int exit_code = pclose(in);
+
+  if (!have_rtt)
+  {
+    rtt = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+  }
+
+  return exit_code == 0;
+}
+
+uint16_t icmpChecksum(const uint8_t *data, size_t len)
+{
+  uint32_t sum = 0;
+  for (size_t i = 0; i+1 < len; i += 2)
+  {
+    sum += (static_cast<uint32_t>(data[i]) << 8) | data[i+1];
+  }
+
+  if (len & 1)
+  {
+    sum += static_cast<uint32_t>(data[len-1]) << 8;
+  }
+
+  while (sum >> 16)
+  {
+    sum = (sum & 0xffff) + (sum >> 16);
+  }
+
+  return static_cast<uint16_t>(~sum);
+}
+
+}
+
 bool checkReachabilityOfSensor(const DeviceInfo &info)
 {
-  const std::string command = "ping -c 1 -W 1 " + ip2string(info.getIP());
+  const std::string command = "LC_ALL=C ping -c 1 -W 1 " +
+                              ip2string(info.getIP());
+
+  const auto start = std::chrono::steady_clock::now();
 
   FILE *in;
   if (!(in = popen(command.c_str(), "r")))
@@ -102,11 +339,267 @@ bool checkReachabilityOfSensor(const DeviceInfo &info)
     throw std::runtime_error("Could not execute ping command.");
   }
 
-  const int exit_code = pclose(in);
+  std::chrono::microseconds rtt;
+  const bool reachable = finishPingCommand(in, start, rtt);
 
-  return exit_code == 0;
+  Metrics::recordReachability(reachable, rtt);
+
+  return reachable;
+}
+
+Pinger::Pinger() :
+  fd_(-1),
+  raw_(false),
+  seq_(0)
+{
+  // unprivileged ICMP sockets are only permitted for the groups in
+  // net.ipv4.ping_group_range, raw sockets require CAP_NET_RAW
+
+  fd_ = socket(AF_INET, SOCK_DGRAM, IPPROTO_ICMP);
+
+  if (fd_ < 0)
+  {
+    fd_ = socket(AF_INET, SOCK_RAW, IPPROTO_ICMP);
+    raw_ = (fd_ >= 0);
+  }
+}
+
+Pinger::~Pinger()
+{
+  if (fd_ >= 0)
+  {
+    close(fd_);
+  }
+}
+
+void Pinger::ping(const std::vector<uint32_t> &ips,
+                  std::chrono::milliseconds timeout,
+                  const std::function<void(const PingResult &)> &callback)
+{
+  if (fd_ < 0)
+  {
+    // start the ping command for a limited number of hosts at once
+
+    const size_t max_processes = 64;
+    const long timeout_s = std::max<long>(1, static_cast<long>(
+      (timeout.count() + 999) / 1000));
+
+    for (size_t start = 0; start < ips.size() && !isCancelled();
+         start += max_processes)
+    {
+      const size_t n = std::min(max_processes, ips.size() - start);
+
+      std::vector<FILE *> in(n, nullptr);
+      std::vector<std::chrono::steady_clock::time_point> started(n);
+      for (size_t k = 0; k < n; k++)
+      {
+        const std::string command = "LC_ALL=C ping -c 1 -W " +
+                                    std::to_string(timeout_s) + " " +
+                                    ip2string(ips[start+k]);
+        started[k] = std::chrono::steady_clock::now();
+        in[k] = popen(command.c_str(), "r");
+      }
+
+      for (size_t k = 0; k < n; k++)
+      {
+        std::chrono::microseconds rtt(0);
+        const bool reachable = in[k] != nullptr &&
+                               finishPingCommand(in[k], started[k], rtt);
+
+        if (!reachable)
+        {
+          rtt = std::chrono::microseconds(0);
+        }
+
+        if (!isCancelled())
+        {
+          Metrics::recordReachability(reachable, rtt);
+          callback(PingResult{ips[start+k], reachable, rtt});
+        }
+      }
+    }
+
+    return;
+  }
+
+  // sequence numbers identify the requests, so that at most 2^15 hosts are
+  // pinged at once to never confuse replies of consecutive calls
+
+  const size_t max_requests = 1u << 15;
+
+  if (ips.size() > max_requests)
+  {
+    for (size_t start = 0; start < ips.size() && !isCancelled();
+         start += max_requests)
+    {
+      const size_t n = std::min(max_requests, ips.size() - start);
+      ping(std::vector<uint32_t>(ips.begin() + start,
+                                 ips.begin() + start + n),
+           timeout, callback);
+    }
+
+    return;
+  }
+
+  // the kernel sets the identifier of unprivileged ICMP sockets to the
+  // local port and only passes matching replies
+
+  const uint16_t ident = static_cast<uint16_t>(getpid() & 0xffff);
+  const uint16_t base = seq_;
+  seq_ = static_cast<uint16_t>(seq_ + ips.size());
+
+  std::vector<std::chrono::steady_clock::time_point> sent(ips.size());
+  std::vector<char> done(ips.size(), 0);
+  size_t pending = 0;
+
+  for (size_t i = 0; i < ips.size(); i++)
+  {
+    const uint16_t seq = static_cast<uint16_t>(base + i);
+
+    uint8_t packet[16];
+    std::memset(packet, 0, sizeof(packet));
+    packet[0] = 8; // echo request
+    packet[4] = static_cast<uint8_t>(ident >> 8);
+    packet[5] = static_cast<uint8_t>(ident & 0xff);
+    packet[6] = static_cast<uint8_t>(seq >> 8);
+    packet[7] = static_cast<uint8_t>(seq & 0xff);
+    std::memcpy(packet+8, "rcdiscvr", 8);
+
+    const uint16_t checksum = icmpChecksum(packet, sizeof(packet));
+    packet[2] = static_cast<uint8_t>(checksum >> 8);
+    packet[3] = static_cast<uint8_t>(checksum & 0xff);
+
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(ips[i]);
+
+    sent[i] = std::chrono::steady_clock::now();
+
+    if (sendto(fd_, packet, sizeof(packet), 0,
+               reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) < 0)
+    {
+      done[i] = 1;
+      Metrics::recordReachability(false, std::chrono::microseconds(0));
+      callback(PingResult{ips[i], false, std::chrono::microseconds(0)});
+    }
+    else
+    {
+      pending++;
+    }
+  }
+
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+  while (pending > 0)
+  {
+    const auto now = std::chrono::steady_clock::now();
+    if (now >= deadline)
+    {
+      break;
+    }
+
+    if (isCancelled())
+    {
+      return;
+    }
+
+    pollfd pfd;
+    pfd.fd = fd_;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    // waiting is limited to notice cancellation
+
+    auto remaining = std::chrono::duration_cast<
+      std::chrono::milliseconds>(deadline - now).count() + 1;
+
+    if (cancel_)
+    {
+      remaining = std::min<decltype(remaining)>(remaining, 50);
+    }
+
+    if (poll(&pfd, 1, static_cast<int>(remaining)) <= 0)
+    {
+      continue;
+    }
+
+    uint8_t buffer[1500];
+    sockaddr_in addr;
+    socklen_t addr_len = sizeof(addr);
+
+    ssize_t len;
+    while ((len = recvfrom(fd_, buffer, sizeof(buffer), MSG_DONTWAIT,
+                           reinterpret_cast<sockaddr *>(&addr),
+                           &addr_len)) > 0)
+    {
+      const auto received = std::chrono::steady_clock::now();
+      addr_len = sizeof(addr);
+
+      // raw sockets receive all ICMP packets including the IP header
+
+      const uint8_t *p = buffer;
+      if (raw_)
+      {
+        const size_t header_len = (buffer[0] & 0x0f) * 4u;
+        if (static_cast<size_t>(len) < header_len)
+        {
+          continue;
+        }
+
+        p += header_len;
+        len -= static_cast<ssize_t>(header_len);
+      }
+
+      if (len < 8 || p[0] != 0)
+      {
+        continue;
+      }
+
+      if (raw_ && ((p[4] << 8) | p[5]) != ident)
+      {
+        continue;
+      }
+
+      const uint16_t seq = static_cast<uint16_t>((p[6] << 8) | p[7]);
+      const size_t i = static_cast<uint16_t>(seq - base);
+
+      if (i >= ips.size() || done[i] || ntohl(addr.sin_addr.s_addr) != ips[i])
+      {
+        continue;
+      }
+
+      done[i] = 1;
+      pending--;
+
+      const auto rtt = std::chrono::duration_cast<std::chrono::microseconds>(
+        received - sent[i]);
+
+      Metrics::recordReachability(true, rtt);
+      callback(PingResult{ips[i], true, rtt});
+    }
+  }
+
+  for (size_t i = 0; i < ips.size(); i++)
+  {
+    if (!done[i])
+    {
+      Metrics::recordReachability(false, std::chrono::microseconds(0));
+      callback(PingResult{ips[i], false, std::chrono::microseconds(0)});
+    }
+  }
 }
 
 #endif
 
+void Pinger::setCancelToken(std::shared_ptr<const CancelToken> cancel)
+{
+  cancel_ = std::move(cancel);
+}
+
+bool Pinger::isCancelled() const
+{
+  return cancel_ && cancel_->isCancelled();
+}
+
 }
\ No newline at end of file
@@ -35,9 +35,17 @@
 
 #include "deviceinfo.h"
 
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
 namespace rcdiscover
 {
 
+class CancelToken;
+
 /**
  * @brief Check whether an rc_visard is reachable via ICMP.
  * @param info DeviceInfo of rc_visard
@@ -45,4 +53,65 @@ namespace rcdiscover
  */
 bool checkReachabilityOfSensor(const DeviceInfo &info);
 
+/**
+ * @brief Result of pinging one host.
+ */
+struct PingResult
+{
+  uint32_t ip; ///< IP address in host byte order
+  bool reachable;
+  std::chrono::microseconds rtt; ///< round trip time, 0 if not reachable
+};
+
+/**
+ * @brief Pings many hosts at once from the calling thread.
+ *
+ * All echo requests are sent before the replies are collected, so that
+ * pinging n hosts takes about as long as pinging the slowest one. On Linux,
+ * an unprivileged ICMP socket is used if permitted by
+ * net.ipv4.ping_group_range, otherwise a raw socket. If neither can be
+ * opened, the ping command is started for all hosts in parallel.
+ */
+class Pinger
+{
+  public:
+    Pinger();
+    ~Pinger();
+
+    Pinger(const Pinger &) = delete;
+    Pinger &operator=(const Pinger &) = delete;
+
+    /**
+     * @brief Pings the given hosts once.
+     * @param ips IP addresses in host byte order
+     * @param timeout time to wait for replies
+     * @param callback called for each host as soon as its reply arrived or
+     *                 the timeout expired, but not for the remaining hosts
+     *                 after cancellation
+     */
+    void ping(const std::vector<uint32_t> &ips,
+              std::chrono::milliseconds timeout,
+              const std::function<void(const PingResult &)> &callback);
+
+    /**
+     * @brief Sets a token that stops ping() within a few milliseconds after
+     * it has been cancelled from another thread. If the ping command is
+     * used, the running commands are waited for. The token is removed by
+     * passing a null pointer.
+     * @param cancel cancel token
+     */
+    void setCancelToken(std::shared_ptr<const CancelToken> cancel);
+
+  private:
+    /**
+     * @brief Returns true if the cancel token has been cancelled.
+     */
+    bool isCancelled() const;
+
+    std::shared_ptr<const CancelToken> cancel_;
+    int fd_; // ICMP socket or -1 (Linux only)
+    bool raw_; // true if fd_ is a raw socket
+    uint16_t seq_; // sequence number of the next echo request
+};
+
 }
\ No newline at end of file
@@ -0,0 +1,460 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "presence_log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <cstdio>
+#include <cstring>
+
+#ifdef WIN32
+#include <io.h>
+#include <fcntl.h>
+#include <share.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace rcdiscover
+{
+
+namespace
+{
+
+const char LOG_MAGIC[8] = { 'R', 'C', 'D', 'P', 'L', 'O', 'G', 0 };
+const char INDEX_MAGIC[8] = { 'R', 'C', 'D', 'P', 'I', 'D', 'X', 0 };
+const uint32_t PRESENCE_VERSION = 1;
+
+bool isLittleEndian()
+{
+  const uint16_t v = 1;
+  return *reinterpret_cast<const uint8_t *>(&v) == 1;
+}
+
+/**
+ * @brief Removes a partially written record from the end of the file.
+ */
+void truncateFile(const std::string &filename, uint64_t size)
+{
+#ifdef WIN32
+  int fd;
+  if (_sopen_s(&fd, filename.c_str(), _O_RDWR | _O_BINARY, _SH_DENYNO, 0) == 0)
+  {
+    _chsize_s(fd, static_cast<__int64>(size));
+    _close(fd);
+  }
+#else
+  if (::truncate(filename.c_str(), static_cast<off_t>(size)) != 0)
+  {
+    throw std::runtime_error("Cannot repair presence log: " + filename);
+  }
+#endif
+}
+
+uint64_t overlap(uint64_t a0, uint64_t a1, uint64_t b0, uint64_t b1)
+{
+  const uint64_t s = std::max(a0, b0);
+  const uint64_t e = std::min(a1, b1);
+
+  return (e > s) ? e - s : 0;
+}
+
+}
+
+PresenceLogWriter::PresenceLogWriter(const std::string &filename) :
+  filename_(filename),
+  last_time_(0)
+{
+  if (!isLittleEndian())
+  {
+    throw std::runtime_error("Presence logs are only supported on little endian hosts");
+  }
+
+  uint64_t size = 0;
+
+  {
+    std::ifstream in(filename, std::ios::binary);
+    if (in)
+    {
+      in.seekg(0, std::ios::end);
+      size = static_cast<uint64_t>(in.tellg());
+    }
+  }
+
+  if (size > 0)
+  {
+    PresenceLog log(filename);
+
+    if (log.size() > 0)
+    {
+      last_time_ = log.getRecord(log.size()-1).time;
+    }
+
+    const uint64_t valid = sizeof(PresenceLogHeader) +
+                           log.size()*sizeof(PresenceRecord);
+
+    if (valid < size)
+    {
+      truncateFile(filename, valid);
+    }
+  }
+
+  out_.open(filename, std::ios::binary | std::ios::app);
+  if (!out_)
+  {
+    throw std::runtime_error("Cannot open presence log: " + filename);
+  }
+
+  const uint64_t now = static_cast<uint64_t>(
+    std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count());
+
+  if (size == 0)
+  {
+    PresenceLogHeader header;
+    memcpy(header.magic, LOG_MAGIC, sizeof(header.magic));
+    header.version = PRESENCE_VERSION;
+    header.record_size = sizeof(PresenceRecord);
+    header.created = now;
+    header.reserved = 0;
+
+    out_.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  }
+
+  PresenceRecord record;
+  memset(&record, 0, sizeof(record));
+  record.time = now;
+  record.type = PresenceRecord::START;
+
+  append(record);
+}
+
+void PresenceLogWriter::append(const FleetEvent &event, uint64_t time)
+{
+  PresenceRecord record;
+  memset(&record, 0, sizeof(record));
+
+  record.time = time;
+  record.mac = event.info.getMAC();
+  record.ip = event.info.getIP();
+  record.subnet = event.info.getSubnetMask();
+  record.gateway = event.info.getGateway();
+  record.changed = static_cast<uint8_t>(event.changed);
+
+  switch (event.type)
+  {
+    case FleetEvent::APPEARED: record.type = PresenceRecord::APPEARED; break;
+    case FleetEvent::DISAPPEARED: record.type = PresenceRecord::DISAPPEARED; break;
+    case FleetEvent::CHANGED: record.type = PresenceRecord::CHANGED; break;
+  }
+
+  std::lock_guard<std::mutex> lock(mtx_);
+  append(record);
+}
+
+void PresenceLogWriter::append(PresenceRecord record)
+{
+  // the log must be sorted by time, even if the clock is set back
+
+  record.time = std::max(record.time, last_time_);
+  last_time_ = record.time;
+
+  out_.write(reinterpret_cast<const char *>(&record), sizeof(record));
+  out_.flush();
+
+  if (!out_)
+  {
+    throw std::runtime_error("Cannot write presence log: " + filename_);
+  }
+}
+
+void PresenceLogWriter::writeIndex()
+{
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  PresenceLog log(filename_);
+
+  if (log.size() > UINT32_MAX)
+  {
+    throw std::runtime_error("Presence log too large for index: " + filename_);
+  }
+
+  // sorting pairs of MAC and record index groups the records by MAC,
+  // keeping the order of time within a group
+
+  std::vector<std::pair<uint64_t, uint32_t> > pairs(log.size());
+  for (size_t i = 0; i < log.size(); ++i)
+  {
+    pairs[i] = std::make_pair(log.getRecord(i).mac, static_cast<uint32_t>(i));
+  }
+
+  std::sort(pairs.begin(), pairs.end());
+
+  std::vector<PresenceIndexEntry> entries;
+  std::vector<uint32_t> postings(pairs.size());
+
+  for (size_t i = 0; i < pairs.size(); ++i)
+  {
+    if (entries.empty() || entries.back().mac != pairs[i].first)
+    {
+      PresenceIndexEntry entry;
+      entry.mac = pairs[i].first;
+      entry.first = i;
+      entry.count = 0;
+      entries.push_back(entry);
+    }
+
+    entries.back().count++;
+    postings[i] = pairs[i].second;
+  }
+
+  PresenceIndexHeader header;
+  memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+  header.version = PRESENCE_VERSION;
+  header.entries = static_cast<uint32_t>(entries.size());
+  header.indexed_records = log.size();
+  header.created = log.getCreated();
+
+  // write to temporary file and rename, so that readers never see a
+  // partially written index
+
+  const std::string index = filename_ + ".idx";
+  const std::string tmp = index + ".tmp";
+
+  {
+    std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(entries.data()),
+              static_cast<std::streamsize>(entries.size()*sizeof(PresenceIndexEntry)));
+    out.write(reinterpret_cast<const char *>(postings.data()),
+              static_cast<std::streamsize>(postings.size()*sizeof(uint32_t)));
+    out.close();
+
+    if (!out)
+    {
+      std::remove(tmp.c_str());
+      throw std::runtime_error("Cannot write presence index: " + index);
+    }
+  }
+
+#ifdef WIN32
+  std::remove(index.c_str());
+#endif
+
+  if (std::rename(tmp.c_str(), index.c_str()) != 0)
+  {
+    std::remove(tmp.c_str());
+    throw std::runtime_error("Cannot write presence index: " + index);
+  }
+}
+
+PresenceLog::PresenceLog(const std::string &filename) :
+  file_(new MappedFile(filename)),
+  records_(nullptr),
+  count_(0),
+  created_(0),
+  index_entries_(nullptr),
+  index_count_(0),
+  postings_(nullptr),
+  postings_count_(0),
+  indexed_records_(0)
+{
+  if (!isLittleEndian())
+  {
+    throw std::runtime_error("Presence logs are only supported on little endian hosts");
+  }
+
+  const PresenceLogHeader *header =
+    reinterpret_cast<const PresenceLogHeader *>(file_->data());
+
+  if (file_->size() < sizeof(PresenceLogHeader) ||
+      memcmp(header->magic, LOG_MAGIC, sizeof(LOG_MAGIC)) != 0 ||
+      header->version != PRESENCE_VERSION ||
+      header->record_size != sizeof(PresenceRecord))
+  {
+    throw std::runtime_error("Not a presence log: " + filename);
+  }
+
+  records_ = reinterpret_cast<const PresenceRecord *>(header+1);
+  count_ = (file_->size() - sizeof(PresenceLogHeader))/sizeof(PresenceRecord);
+  created_ = header->created;
+
+  // the index is optional, e.g. it may not have been written yet
+
+  try
+  {
+    index_.reset(new MappedFile(filename + ".idx"));
+  }
+  catch(const std::exception &)
+  {
+    return;
+  }
+
+  const PresenceIndexHeader *ih =
+    reinterpret_cast<const PresenceIndexHeader *>(index_->data());
+
+  if (index_->size() < sizeof(PresenceIndexHeader) ||
+      memcmp(ih->magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0 ||
+      ih->version != PRESENCE_VERSION || ih->created != header->created ||
+      ih->indexed_records > count_)
+  {
+    index_.reset();
+    return;
+  }
+
+  const size_t entries_size = ih->entries*sizeof(PresenceIndexEntry);
+  if (index_->size() - sizeof(PresenceIndexHeader) < entries_size)
+  {
+    index_.reset();
+    return;
+  }
+
+  index_entries_ = reinterpret_cast<const PresenceIndexEntry *>(ih+1);
+  index_count_ = ih->entries;
+  postings_ = reinterpret_cast<const uint32_t *>(index_entries_ + ih->entries);
+  postings_count_ = (index_->size() - sizeof(PresenceIndexHeader) -
+                     entries_size)/sizeof(uint32_t);
+  indexed_records_ = static_cast<size_t>(ih->indexed_records);
+}
+
+std::vector<size_t> PresenceLog::findByMAC(uint64_t mac) const
+{
+  std::vector<size_t> device, start;
+
+  collect(mac, device);
+  collect(0, start);
+
+  std::vector<size_t> ret(device.size() + start.size());
+  std::merge(device.begin(), device.end(), start.begin(), start.end(),
+             ret.begin());
+
+  return ret;
+}
+
+void PresenceLog::findByTime(uint64_t from, uint64_t to, size_t &first,
+                             size_t &last) const
+{
+  auto less = [](const PresenceRecord &r, uint64_t t) { return r.time < t; };
+
+  first = static_cast<size_t>(
+    std::lower_bound(records_, records_ + count_, from, less) - records_);
+  last = static_cast<size_t>(
+    std::lower_bound(records_ + first, records_ + count_, to, less) - records_);
+}
+
+uint64_t PresenceLog::getUptime(uint64_t mac, uint64_t from, uint64_t to) const
+{
+  uint64_t ret = 0;
+  bool present = false;
+  uint64_t since = 0;
+
+  for (const size_t i : findByMAC(mac))
+  {
+    const PresenceRecord &r = records_[i];
+
+    if (r.time >= to)
+    {
+      break;
+    }
+
+    switch (r.type)
+    {
+      case PresenceRecord::APPEARED:
+      case PresenceRecord::CHANGED:
+        if (!present)
+        {
+          present = true;
+          since = r.time;
+        }
+        break;
+
+      case PresenceRecord::DISAPPEARED:
+      case PresenceRecord::START:
+        if (present)
+        {
+          ret += overlap(since, r.time, from, to);
+          present = false;
+        }
+        break;
+    }
+  }
+
+  if (present)
+  {
+    ret += overlap(since, to, from, to);
+  }
+
+  return ret;
+}
+
+void PresenceLog::collect(uint64_t mac, std::vector<size_t> &ret) const
+{
+  size_t i = 0;
+
+  if (index_entries_ != nullptr)
+  {
+    const PresenceIndexEntry *end = index_entries_ + index_count_;
+    const PresenceIndexEntry *e = std::lower_bound(index_entries_, end, mac,
+      [](const PresenceIndexEntry &a, uint64_t m) { return a.mac < m; });
+
+    if (e != end && e->mac == mac && e->first <= postings_count_ &&
+        e->count <= postings_count_ - e->first)
+    {
+      for (uint64_t k = e->first; k < e->first + e->count; ++k)
+      {
+        if (postings_[k] < indexed_records_)
+        {
+          ret.push_back(postings_[k]);
+        }
+      }
+    }
+
+    i = indexed_records_;
+  }
+
+  // records that have been appended after writing the index
+
+  for (; i < count_; ++i)
+  {
+    if (records_[i].mac == mac)
+    {
+      ret.push_back(i);
+    }
+  }
+}
+
+}
@@ -0,0 +1,251 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RCDISCOVER_PRESENCE_LOG_H
+#define RCDISCOVER_PRESENCE_LOG_H
+
+#include "fleet.h"
+#include "mapped_file.h"
+
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace rcdiscover
+{
+
+/**
+ * @brief Fixed size record of the presence log. All values are little
+ * endian.
+ */
+struct PresenceRecord
+{
+  enum Type
+  {
+    APPEARED = 0,
+    DISAPPEARED = 1,
+    CHANGED = 2,
+    START = 3     ///< writer has been (re)started, mac is 0
+  };
+
+  uint64_t time;    ///< milliseconds since epoch
+  uint64_t mac;
+  uint32_t ip;
+  uint32_t subnet;
+  uint32_t gateway;
+  uint8_t type;     ///< Type
+  uint8_t changed;  ///< bitmask of FleetEvent::Field for CHANGED
+  uint16_t reserved;
+};
+
+/**
+ * @brief Header of the presence log file, which is followed by records.
+ */
+struct PresenceLogHeader
+{
+  char magic[8];        ///< "RCDPLOG" followed by 0
+  uint32_t version;
+  uint32_t record_size;
+  uint64_t created;     ///< milliseconds since epoch, identifies the log
+  uint64_t reserved;
+};
+
+/**
+ * @brief Header of the index of a presence log file, which is followed by
+ * entries sorted by MAC address and postings.
+ */
+struct PresenceIndexHeader
+{
+  char magic[8];            ///< "RCDPIDX" followed by 0
+  uint32_t version;
+  uint32_t entries;         ///< number of PresenceIndexEntry
+  uint64_t indexed_records; ///< number of records of the log in the index
+  uint64_t created;         ///< equal to PresenceLogHeader::created
+};
+
+/**
+ * @brief Entry of the index. The postings of a MAC address are the indices
+ * of its records in the order of time.
+ */
+struct PresenceIndexEntry
+{
+  uint64_t mac;
+  uint64_t first;  ///< first element in postings (uint32_t)
+  uint64_t count;  ///< number of elements in postings
+};
+
+/**
+ * @brief Appends state transitions of devices to a presence log file.
+ *
+ * The file consists of a header and records in the order of time. A
+ * partially written record at the end of the file, e.g. after power loss,
+ * is removed on opening. The writer may be shared by multiple threads.
+ */
+class PresenceLogWriter
+{
+  public:
+    /**
+     * @brief Constructor. Opens or creates the log file and appends a START
+     * record, since devices that are present will appear again.
+     * @param filename name of file
+     * @throws std::runtime_error if the file cannot be opened or is not a
+     * presence log
+     */
+    explicit PresenceLogWriter(const std::string &filename);
+
+    PresenceLogWriter(const PresenceLogWriter &) = delete;
+    PresenceLogWriter &operator=(const PresenceLogWriter &) = delete;
+
+    /**
+     * @brief Appends an event of the fleet table.
+     * @param event event
+     * @param time milliseconds since epoch
+     */
+    void append(const FleetEvent &event, uint64_t time);
+
+    /**
+     * @brief Writes the per-MAC index of the log file (see PresenceLog).
+     * @throws std::runtime_error if the index cannot be written
+     */
+    void writeIndex();
+
+  private:
+    void append(PresenceRecord record);
+
+  private:
+    std::mutex mtx_;
+    std::string filename_;
+    std::ofstream out_;
+    uint64_t last_time_;
+};
+
+/**
+ * @brief Read access to a presence log file.
+ *
+ * The log and its index (filename + ".idx") are mapped into memory. Records
+ * that are not covered by the index, because they have been appended after
+ * the index has been written, are searched linearly.
+ */
+class PresenceLog
+{
+  public:
+    /**
+     * @brief Constructor. Maps the log file and its index, if available.
+     * @param filename name of log file
+     * @throws std::runtime_error if the file cannot be opened or is not a
+     * presence log
+     */
+    explicit PresenceLog(const std::string &filename);
+
+    /**
+     * @brief Returns the number of records.
+     * @return number of records
+     */
+    size_t size() const { return count_; }
+
+    /**
+     * @brief Returns a record.
+     * @param i index of record, which must be smaller than size()
+     * @return record
+     */
+    const PresenceRecord &getRecord(size_t i) const { return records_[i]; }
+
+    /**
+     * @brief Returns the time at which the log has been created.
+     * @return milliseconds since epoch
+     */
+    uint64_t getCreated() const { return created_; }
+
+    /**
+     * @brief Returns true if the index could be used.
+     * @return true if index is used
+     */
+    bool hasIndex() const { return index_entries_ != nullptr; }
+
+    /**
+     * @brief Returns the indices of all records of a device, including all
+     * START records, in the order of time.
+     * @param mac MAC address
+     * @return indices of records
+     */
+    std::vector<size_t> findByMAC(uint64_t mac) const;
+
+    /**
+     * @brief Returns the indices of all records in a time interval.
+     * @param from start of interval in milliseconds since epoch (inclusive)
+     * @param to end of interval in milliseconds since epoch (exclusive)
+     * @param first set to the index of the first record
+     * @param last set to the index after the last record
+     */
+    void findByTime(uint64_t from, uint64_t to, size_t &first,
+                    size_t &last) const;
+
+    /**
+     * @brief Computes the time in which a device answered in a time
+     * interval. The device is assumed to be present from an APPEARED or
+     * CHANGED record until the next DISAPPEARED or START record.
+     * @param mac MAC address
+     * @param from start of interval in milliseconds since epoch
+     * @param to end of interval in milliseconds since epoch
+     * @return time of presence in milliseconds
+     */
+    uint64_t getUptime(uint64_t mac, uint64_t from, uint64_t to) const;
+
+  private:
+    /**
+     * @brief Appends the indices of all records with the given MAC address.
+     */
+    void collect(uint64_t mac, std::vector<size_t> &ret) const;
+
+  private:
+    std::unique_ptr<MappedFile> file_;
+    const PresenceRecord *records_;
+    size_t count_;
+    uint64_t created_;
+
+    std::unique_ptr<MappedFile> index_;
+    const PresenceIndexEntry *index_entries_;
+    size_t index_count_;
+    const uint32_t *postings_;
+    size_t postings_count_;
+    size_t indexed_records_;
+};
+
+}
+
+#endif // RCDISCOVER_PRESENCE_LOG_H
@@ -0,0 +1,211 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "profile.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace rcdiscover
+{
+
+namespace
+{
+
+const size_t MAX_PHASES = 64;
+
+/*
+  Timings of one phase. A slot is claimed by a compare and swap of the name
+  from null and is identified by the contents of the name afterwards.
+*/
+
+struct PhaseSlot
+{
+  std::atomic<const char *> phase;
+  std::atomic<int> depth;
+  std::atomic<uint64_t> calls;
+  std::atomic<int64_t> total;
+  std::atomic<int64_t> first;
+};
+
+PhaseSlot slots[MAX_PHASES];
+
+std::atomic<int64_t> origin(0);
+
+int64_t toNanoseconds(std::chrono::steady_clock::time_point t)
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    t.time_since_epoch()).count();
+}
+
+/*
+  Nesting level of the running timers of the current thread.
+*/
+
+thread_local int current_depth = 0;
+
+}
+
+std::atomic<bool> Profile::enabled_(false);
+
+void Profile::setEnabled(bool enable)
+{
+  if (enable)
+  {
+    origin.store(toNanoseconds(std::chrono::steady_clock::now()),
+                 std::memory_order_relaxed);
+  }
+
+  enabled_.store(enable, std::memory_order_relaxed);
+}
+
+void Profile::record(const char *phase,
+                     std::chrono::steady_clock::time_point start,
+                     std::chrono::nanoseconds duration, int depth) noexcept
+{
+  if (!isEnabled())
+  {
+    return;
+  }
+
+  const int64_t t = toNanoseconds(start) -
+                    origin.load(std::memory_order_relaxed);
+
+  for (auto &slot : slots)
+  {
+    const char *p = slot.phase.load(std::memory_order_acquire);
+
+    if (p == nullptr)
+    {
+      // the first measurement of a phase initializes the slot before
+      // publishing the name
+
+      if (slot.phase.compare_exchange_strong(p, phase,
+                                             std::memory_order_acq_rel))
+      {
+        p = phase;
+        slot.depth.store(depth, std::memory_order_relaxed);
+        slot.first.store(t, std::memory_order_relaxed);
+      }
+    }
+
+    if (p == phase || std::strcmp(p, phase) == 0)
+    {
+      slot.calls.fetch_add(1, std::memory_order_relaxed);
+      slot.total.fetch_add(duration.count(), std::memory_order_relaxed);
+
+      int64_t first = slot.first.load(std::memory_order_relaxed);
+      while (t < first &&
+             !slot.first.compare_exchange_weak(first, t,
+                                               std::memory_order_relaxed))
+      { }
+
+      return;
+    }
+  }
+}
+
+std::vector<ProfileEntry> Profile::getEntries()
+{
+  std::vector<ProfileEntry> ret;
+
+  for (const auto &slot : slots)
+  {
+    const char *p = slot.phase.load(std::memory_order_acquire);
+    if (p == nullptr)
+    {
+      break;
+    }
+
+    ProfileEntry entry;
+    entry.phase = p;
+    entry.depth = slot.depth.load(std::memory_order_relaxed);
+    entry.calls = slot.calls.load(std::memory_order_relaxed);
+    entry.total = std::chrono::nanoseconds(
+      slot.total.load(std::memory_order_relaxed));
+    entry.first = std::chrono::nanoseconds(
+      slot.first.load(std::memory_order_relaxed));
+
+    ret.push_back(entry);
+  }
+
+  std::stable_sort(ret.begin(), ret.end(),
+                   [](const ProfileEntry &a, const ProfileEntry &b)
+                   { return a.first < b.first; });
+
+  return ret;
+}
+
+void Profile::clear()
+{
+  for (auto &slot : slots)
+  {
+    slot.phase.store(nullptr, std::memory_order_relaxed);
+    slot.depth.store(0, std::memory_order_relaxed);
+    slot.calls.store(0, std::memory_order_relaxed);
+    slot.total.store(0, std::memory_order_relaxed);
+    slot.first.store(0, std::memory_order_relaxed);
+  }
+}
+
+ScopedTimer::ScopedTimer(const char *phase) noexcept :
+  phase_(Profile::isEnabled() ? phase : nullptr),
+  depth_(0)
+{
+  if (phase_ != nullptr)
+  {
+    depth_ = current_depth++;
+    start_ = std::chrono::steady_clock::now();
+  }
+}
+
+ScopedTimer::~ScopedTimer()
+{
+  stop();
+}
+
+void ScopedTimer::stop() noexcept
+{
+  if (phase_ != nullptr)
+  {
+    const auto end = std::chrono::steady_clock::now();
+    current_depth--;
+
+    Profile::record(phase_, start_, end - start_, depth_);
+    phase_ = nullptr;
+  }
+}
+
+}
@@ -0,0 +1,147 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RCDISCOVER_PROFILE_H
+#define RCDISCOVER_PROFILE_H
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace rcdiscover
+{
+
+/**
+ * @brief Accumulated wall-clock time of one phase.
+ */
+struct ProfileEntry
+{
+  std::string phase;               ///< name of phase
+  int depth;                       ///< nesting level of first occurrence
+  uint64_t calls;                  ///< number of measurements
+  std::chrono::nanoseconds total;  ///< sum of all measurements
+  std::chrono::nanoseconds first;  ///< start of first measurement
+};
+
+/**
+ * @brief Process wide collection of phase timings, which is filled by
+ * ScopedTimer and explicit calls of record().
+ *
+ * Profiling is disabled by default. In this case, a ScopedTimer costs one
+ * relaxed atomic load. Up to 64 phases are collected, further phases are
+ * ignored. All functions are thread-safe.
+ */
+class Profile
+{
+  public:
+    /**
+     * @brief Enables or disables profiling. Enabling sets the origin for the
+     * start times of the phases.
+     * @param enable true for enabling
+     */
+    static void setEnabled(bool enable);
+
+    /**
+     * @brief Returns if profiling is enabled.
+     * @return true if enabled
+     */
+    static bool isEnabled() noexcept
+    {
+      return enabled_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Adds a measurement of a phase if profiling is enabled.
+     * @param phase name of phase, which must be a string literal or
+     * otherwise stay valid until the end of the program
+     * @param start start of measurement
+     * @param duration duration of measurement
+     * @param depth nesting level
+     */
+    static void record(const char *phase,
+                       std::chrono::steady_clock::time_point start,
+                       std::chrono::nanoseconds duration,
+                       int depth=0) noexcept;
+
+    /**
+     * @brief Returns all phases ordered by the start of their first
+     * measurement.
+     * @return phases
+     */
+    static std::vector<ProfileEntry> getEntries();
+
+    /**
+     * @brief Forgets all phases. Must not be called concurrently with
+     * measurements.
+     */
+    static void clear();
+
+  private:
+    static std::atomic<bool> enabled_;
+};
+
+/**
+ * @brief Measures the wall-clock time from construction to destruction as
+ * one call of a phase. Timers may be nested.
+ */
+class ScopedTimer
+{
+  public:
+    /**
+     * @brief Constructor. Starts the measurement if profiling is enabled.
+     * @param phase name of phase as string literal
+     */
+    explicit ScopedTimer(const char *phase) noexcept;
+    ~ScopedTimer();
+
+    /**
+     * @brief Ends the measurement before destruction.
+     */
+    void stop() noexcept;
+
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+  private:
+    const char *phase_;
+    int depth_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+}
+
+#endif // RCDISCOVER_PROFILE_H
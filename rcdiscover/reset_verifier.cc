@@ -0,0 +1,213 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "reset_verifier.h"
+
+#include "discover.h"
+#include "iface_affinity.h"
+
+#include <algorithm>
+#include <map>
+#include <thread>
+
+namespace rcdiscover
+{
+
+namespace
+{
+
+/*
+  Runs one discovery round and returns the answering devices by MAC address.
+*/
+
+void discoverRound(Discover &discover, std::map<uint64_t, DeviceInfo> &seen)
+{
+  std::vector<DeviceInfo> infos;
+
+  discover.broadcastRequest();
+  while (discover.getResponse(infos, 100)) { }
+
+  IfaceAffinity::update(infos);
+
+  seen.clear();
+  for (const auto &info : infos)
+  {
+    if (info.isValid())
+    {
+      seen[info.getMAC()] = info;
+    }
+  }
+}
+
+}
+
+ResetVerifier::ResetVerifier(const std::vector<uint64_t> &macs) :
+  macs_(macs),
+  baseline_(macs.size(), 0),
+  interval_(200),
+  missing_rounds_(2)
+{ }
+
+void ResetVerifier::setScanInterval(std::chrono::milliseconds interval)
+{
+  interval_ = interval;
+}
+
+void ResetVerifier::setMissingRounds(int rounds)
+{
+  missing_rounds_ = std::max(rounds, 1);
+}
+
+size_t ResetVerifier::takeBaseline()
+{
+  Discover discover;
+  std::map<uint64_t, DeviceInfo> seen;
+  discoverRound(discover, seen);
+
+  size_t n = 0;
+  for (size_t i = 0; i < macs_.size(); ++i)
+  {
+    baseline_[i] = (seen.find(macs_[i]) != seen.end()) ? 1 : 0;
+    n += baseline_[i];
+  }
+
+  return n;
+}
+
+std::vector<ResetStatus> ResetVerifier::run(
+    std::chrono::steady_clock::time_point reset_time,
+    std::chrono::milliseconds timeout,
+    const Callback &callback) const
+{
+  typedef std::chrono::steady_clock clock;
+
+  std::vector<ResetStatus> status(macs_.size());
+  std::vector<int> missing(macs_.size(), 0);
+  std::vector<clock::time_point> first_missing(macs_.size());
+
+  for (size_t i = 0; i < macs_.size(); ++i)
+  {
+    status[i].mac = macs_[i];
+    status[i].state = baseline_[i] ? ResetStatus::ANSWERING :
+                                     ResetStatus::NOT_SEEN;
+    status[i].time_to_disappear = std::chrono::milliseconds(0);
+    status[i].time_to_reappear = std::chrono::milliseconds(0);
+  }
+
+  Discover discover;
+
+  const auto deadline = reset_time + timeout;
+  std::map<uint64_t, DeviceInfo> seen;
+
+  size_t reappeared = 0;
+  while (reappeared < status.size() && clock::now() < deadline)
+  {
+    const auto round_start = clock::now();
+    const auto since_reset = std::chrono::duration_cast<std::chrono::milliseconds>(
+                               round_start - reset_time);
+
+    discoverRound(discover, seen);
+
+    for (size_t i = 0; i < status.size(); ++i)
+    {
+      const auto it = seen.find(status[i].mac);
+
+      switch (status[i].state)
+      {
+        case ResetStatus::NOT_SEEN:
+          // missing rounds are only counted after the first answer
+
+          if (it != seen.end())
+          {
+            status[i].state = ResetStatus::ANSWERING;
+            status[i].info = it->second;
+          }
+          break;
+
+        case ResetStatus::ANSWERING:
+          if (it != seen.end())
+          {
+            missing[i] = 0;
+            status[i].info = it->second;
+          }
+          else
+          {
+            if (missing[i] == 0)
+            {
+              first_missing[i] = round_start;
+            }
+
+            if (++missing[i] >= missing_rounds_)
+            {
+              status[i].state = ResetStatus::DISAPPEARED;
+              status[i].time_to_disappear =
+                  std::chrono::duration_cast<std::chrono::milliseconds>(
+                    first_missing[i] - reset_time);
+
+              if (callback)
+              {
+                callback(status[i]);
+              }
+            }
+          }
+          break;
+
+        case ResetStatus::DISAPPEARED:
+          if (it != seen.end())
+          {
+            status[i].state = ResetStatus::REAPPEARED;
+            status[i].time_to_reappear = since_reset;
+            status[i].info = it->second;
+            reappeared++;
+
+            if (callback)
+            {
+              callback(status[i]);
+            }
+          }
+          break;
+
+        case ResetStatus::REAPPEARED:
+          break;
+      }
+    }
+
+    std::this_thread::sleep_until(std::min(round_start + interval_, deadline));
+  }
+
+  return status;
+}
+
+}
@@ -0,0 +1,152 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RCDISCOVER_RESET_VERIFIER_H
+#define RCDISCOVER_RESET_VERIFIER_H
+
+#include "deviceinfo.h"
+
+#include <vector>
+#include <chrono>
+#include <functional>
+#include <cstdint>
+
+namespace rcdiscover
+{
+
+/**
+ * @brief State of an rc_visard after a reset command.
+ */
+struct ResetStatus
+{
+  enum State
+  {
+    /// device has not answered any discovery request so far
+    NOT_SEEN,
+    /// device still answers discovery requests
+    ANSWERING,
+    /// device stopped answering
+    DISAPPEARED,
+    /// device answers again after it disappeared
+    REAPPEARED
+  };
+
+  uint64_t mac;
+  State state;
+
+  /// time between reset and first discovery round without answer, only
+  /// valid if the device has been seen answering before
+  std::chrono::milliseconds time_to_disappear;
+
+  /// time between reset and first discovery round with answer again
+  std::chrono::milliseconds time_to_reappear;
+
+  /// last received information, i.e. new IP address and subnet after reset
+  DeviceInfo info;
+};
+
+/**
+ * @brief Verifies that rc_visards actually reset by watching them with
+ * continuous discovery until they stop answering and reappear.
+ *
+ * All devices are watched concurrently by the same discovery rounds. The
+ * resolution of the reported times is the scan interval.
+ *
+ * A device only counts as disappeared after it has been seen answering,
+ * either in the baseline round before the reset or in a round after it.
+ * Devices that never answered are reported as NOT_SEEN.
+ */
+class ResetVerifier
+{
+  public:
+    /**
+     * @brief Callback that is called whenever the state of a device changes.
+     */
+    typedef std::function<void(const ResetStatus &)> Callback;
+
+  public:
+    /**
+     * @brief Constructor.
+     * @param macs MAC addresses of the devices that have been reset
+     */
+    explicit ResetVerifier(const std::vector<uint64_t> &macs);
+
+    /**
+     * @brief Sets the minimum time between two discovery rounds. The
+     * default is 200 ms.
+     * @param interval scan interval
+     */
+    void setScanInterval(std::chrono::milliseconds interval);
+
+    /**
+     * @brief Sets the number of consecutive rounds in which a device must
+     * not answer to be considered as disappeared. This prevents that a single
+     * lost acknowledge is taken as reset. The default is 2.
+     * @param rounds number of rounds (at least 1)
+     */
+    void setMissingRounds(int rounds);
+
+    /**
+     * @brief Runs one discovery round before the reset commands are sent,
+     * to record which devices answer. Without baseline, a device that
+     * disappears before the first round after the reset is not noticed.
+     * @return number of devices that answered
+     */
+    size_t takeBaseline();
+
+    /**
+     * @brief Watches the devices until all of them reappeared or the
+     * timeout is reached.
+     * @param reset_time time at which the reset commands were sent
+     * @param timeout maximum time after reset_time to watch the devices
+     * @param callback optional callback for state changes
+     * @return final state of all devices in the order given to the
+     * constructor. Devices that are still ANSWERING probably ignored the
+     * reset command, devices that are NOT_SEEN never answered.
+     */
+    std::vector<ResetStatus> run(std::chrono::steady_clock::time_point reset_time,
+                                 std::chrono::milliseconds timeout,
+                                 const Callback &callback = Callback()) const;
+
+  private:
+    std::vector<uint64_t> macs_;
+    std::vector<char> baseline_; // 1 if device answered in baseline round
+    std::chrono::milliseconds interval_;
+    int missing_rounds_;
+};
+
+}
+
+#endif // RCDISCOVER_RESET_VERIFIER_H
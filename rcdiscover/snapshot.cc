@@ -0,0 +1,374 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "snapshot.h"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <cstring>
+
+namespace rcdiscover
+{
+
+namespace
+{
+
+const char SNAPSHOT_MAGIC[8] = { 'R', 'C', 'D', 'S', 'N', 'A', 'P', 0 };
+const uint32_t SNAPSHOT_VERSION = 1;
+
+bool isLittleEndian()
+{
+  const uint16_t v = 1;
+  return *reinterpret_cast<const uint8_t *>(&v) == 1;
+}
+
+/**
+ * @brief String table that stores every distinct string only once.
+ */
+class StringTable
+{
+  public:
+    StringTable() : data_(1, '\0')
+    {
+      offsets_[std::string()] = 0;
+    }
+
+    uint32_t add(const std::string &s)
+    {
+      const auto it = offsets_.find(s);
+      if (it != offsets_.end())
+      {
+        return it->second;
+      }
+
+      const uint32_t offset = static_cast<uint32_t>(data_.size());
+      data_.insert(data_.end(), s.begin(), s.end());
+      data_.push_back('\0');
+      offsets_[s] = offset;
+
+      return offset;
+    }
+
+    const std::vector<char> &getData() const { return data_; }
+
+  private:
+    std::vector<char> data_;
+    std::unordered_map<std::string, uint32_t> offsets_;
+};
+
+}
+
+std::vector<uint8_t> Snapshot::serialize(const std::vector<DeviceInfo> &devices,
+                                         uint64_t timestamp)
+{
+  if (!isLittleEndian())
+  {
+    throw std::runtime_error("Snapshots are only supported on little endian hosts");
+  }
+
+  std::vector<DeviceInfo> sorted;
+  sorted.reserve(devices.size());
+
+  for (const auto &info : devices)
+  {
+    if (info.isValid())
+    {
+      sorted.push_back(info);
+    }
+  }
+
+  std::sort(sorted.begin(), sorted.end());
+  sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+  StringTable strings;
+  std::vector<SnapshotRecord> records(sorted.size());
+
+  for (size_t i = 0; i < sorted.size(); ++i)
+  {
+    const DeviceInfo &info = sorted[i];
+    SnapshotRecord &r = records[i];
+
+    r.mac = info.getMAC();
+    r.ip = info.getIP();
+    r.subnet = info.getSubnetMask();
+    r.gateway = info.getGateway();
+    r.major = static_cast<uint16_t>(info.getMajorVersion());
+    r.minor = static_cast<uint16_t>(info.getMinorVersion());
+    r.manufacturer_name = strings.add(info.getManufacturerName());
+    r.model_name = strings.add(info.getModelName());
+    r.device_version = strings.add(info.getDeviceVersion());
+    r.manufacturer_info = strings.add(info.getManufacturerInfo());
+    r.serial_number = strings.add(info.getSerialNumber());
+    r.user_name = strings.add(info.getUserName());
+    r.iface_name = strings.add(info.getIfaceName());
+    r.reserved = 0;
+  }
+
+  SnapshotHeader header;
+  memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+  header.version = SNAPSHOT_VERSION;
+  header.count = static_cast<uint32_t>(records.size());
+  header.timestamp = timestamp;
+  header.strings_size = static_cast<uint32_t>(strings.getData().size());
+  header.reserved = 0;
+
+  const size_t records_size = records.size()*sizeof(SnapshotRecord);
+
+  std::vector<uint8_t> ret(sizeof(header) + records_size +
+                           header.strings_size);
+
+  uint8_t *p = ret.data();
+  memcpy(p, &header, sizeof(header));
+  p += sizeof(header);
+
+  if (records_size > 0)
+  {
+    memcpy(p, records.data(), records_size);
+    p += records_size;
+  }
+
+  memcpy(p, strings.getData().data(), header.strings_size);
+
+  return ret;
+}
+
+void Snapshot::write(const std::string &filename,
+                     const std::vector<DeviceInfo> &devices,
+                     uint64_t timestamp)
+{
+  const std::vector<uint8_t> data = serialize(devices, timestamp);
+
+  std::ofstream out(filename, std::ios::binary);
+  out.write(reinterpret_cast<const char *>(data.data()),
+            static_cast<std::streamsize>(data.size()));
+  out.close();
+
+  if (!out)
+  {
+    throw std::runtime_error("Cannot write snapshot file: " + filename);
+  }
+}
+
+Snapshot::Snapshot(const std::string &filename) :
+  file_(new MappedFile(filename)),
+  header_(nullptr),
+  records_(nullptr),
+  strings_(nullptr)
+{
+  init(file_->data(), file_->size());
+}
+
+Snapshot::Snapshot(const uint8_t *data, size_t size) :
+  header_(nullptr),
+  records_(nullptr),
+  strings_(nullptr)
+{
+  init(data, size);
+}
+
+DeviceInfo Snapshot::getDevice(size_t i) const
+{
+  const SnapshotRecord &r = records_[i];
+  DeviceInfo info(getString(r.iface_name));
+
+  info.setVersion(r.major, r.minor);
+  info.setMAC(r.mac);
+  info.setIP(r.ip);
+  info.setSubnetMask(r.subnet);
+  info.setGateway(r.gateway);
+  info.setManufacturerName(getString(r.manufacturer_name));
+  info.setModelName(getString(r.model_name));
+  info.setDeviceVersion(getString(r.device_version));
+  info.setManufacturerInfo(getString(r.manufacturer_info));
+  info.setSerialNumber(getString(r.serial_number));
+  info.setUserName(getString(r.user_name));
+
+  return info;
+}
+
+bool Snapshot::find(uint64_t mac, size_t &i) const
+{
+  const SnapshotRecord *end = records_ + header_->count;
+  const SnapshotRecord *r = std::lower_bound(records_, end, mac,
+    [](const SnapshotRecord &a, uint64_t m) { return a.mac < m; });
+
+  if (r == end || r->mac != mac)
+  {
+    return false;
+  }
+
+  i = static_cast<size_t>(r - records_);
+  return true;
+}
+
+void Snapshot::init(const uint8_t *data, size_t size)
+{
+  if (!isLittleEndian())
+  {
+    throw std::runtime_error("Snapshots are only supported on little endian hosts");
+  }
+
+  if (size < sizeof(SnapshotHeader))
+  {
+    throw std::runtime_error("Snapshot too small");
+  }
+
+  header_ = reinterpret_cast<const SnapshotHeader *>(data);
+
+  if (memcmp(header_->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0)
+  {
+    throw std::runtime_error("Not a snapshot");
+  }
+
+  if (header_->version != SNAPSHOT_VERSION)
+  {
+    throw std::runtime_error("Unsupported snapshot version " +
+                             std::to_string(header_->version));
+  }
+
+  const size_t records_size =
+    static_cast<size_t>(header_->count)*sizeof(SnapshotRecord);
+
+  if (header_->strings_size == 0 ||
+      size - sizeof(SnapshotHeader) < records_size ||
+      size - sizeof(SnapshotHeader) - records_size < header_->strings_size)
+  {
+    throw std::runtime_error("Truncated snapshot");
+  }
+
+  records_ = reinterpret_cast<const SnapshotRecord *>(header_+1);
+  strings_ = reinterpret_cast<const char *>(records_ + header_->count);
+
+  // check once, so that accessing the snapshot is safe afterwards
+
+  if (strings_[header_->strings_size-1] != '\0')
+  {
+    throw std::runtime_error("Invalid string table in snapshot");
+  }
+
+  const uint32_t n = header_->strings_size;
+  for (uint32_t i = 0; i < header_->count; ++i)
+  {
+    const SnapshotRecord &r = records_[i];
+
+    if (r.manufacturer_name >= n || r.model_name >= n ||
+        r.device_version >= n || r.manufacturer_info >= n ||
+        r.serial_number >= n || r.user_name >= n || r.iface_name >= n)
+    {
+      throw std::runtime_error("Invalid string offset in snapshot");
+    }
+
+    if (i > 0 && records_[i-1].mac >= r.mac)
+    {
+      throw std::runtime_error("Snapshot is not sorted by MAC address");
+    }
+  }
+}
+
+std::vector<SnapshotChange> diffSnapshots(const Snapshot &a, const Snapshot &b)
+{
+  std::vector<SnapshotChange> ret;
+
+  size_t i = 0, k = 0;
+  while (i < a.size() || k < b.size())
+  {
+    SnapshotChange change;
+    change.fields = 0;
+    change.old_index = i;
+    change.new_index = k;
+
+    if (k >= b.size() || (i < a.size() && a.getRecord(i).mac < b.getRecord(k).mac))
+    {
+      change.mac = a.getRecord(i).mac;
+      change.type = SnapshotChange::REMOVED;
+      ret.push_back(change);
+      i++;
+      continue;
+    }
+
+    if (i >= a.size() || b.getRecord(k).mac < a.getRecord(i).mac)
+    {
+      change.mac = b.getRecord(k).mac;
+      change.type = SnapshotChange::ADDED;
+      ret.push_back(change);
+      k++;
+      continue;
+    }
+
+    const SnapshotRecord &ra = a.getRecord(i);
+    const SnapshotRecord &rb = b.getRecord(k);
+
+    auto differs = [&a, &b](uint32_t sa, uint32_t sb)
+    {
+      return std::strcmp(a.getString(sa), b.getString(sb)) != 0;
+    };
+
+    if (ra.ip != rb.ip) change.fields |= SnapshotChange::IP;
+    if (ra.subnet != rb.subnet) change.fields |= SnapshotChange::SUBNET;
+    if (ra.gateway != rb.gateway) change.fields |= SnapshotChange::GATEWAY;
+    if (ra.major != rb.major || ra.minor != rb.minor)
+      change.fields |= SnapshotChange::VERSION;
+    if (differs(ra.manufacturer_name, rb.manufacturer_name))
+      change.fields |= SnapshotChange::MANUFACTURER_NAME;
+    if (differs(ra.model_name, rb.model_name))
+      change.fields |= SnapshotChange::MODEL_NAME;
+    if (differs(ra.device_version, rb.device_version))
+      change.fields |= SnapshotChange::DEVICE_VERSION;
+    if (differs(ra.manufacturer_info, rb.manufacturer_info))
+      change.fields |= SnapshotChange::MANUFACTURER_INFO;
+    if (differs(ra.serial_number, rb.serial_number))
+      change.fields |= SnapshotChange::SERIAL_NUMBER;
+    if (differs(ra.user_name, rb.user_name))
+      change.fields |= SnapshotChange::USER_NAME;
+    if (differs(ra.iface_name, rb.iface_name))
+      change.fields |= SnapshotChange::IFACE_NAME;
+
+    if (change.fields != 0)
+    {
+      change.mac = ra.mac;
+      change.type = SnapshotChange::CHANGED;
+      ret.push_back(change);
+    }
+
+    i++;
+    k++;
+  }
+
+  return ret;
+}
+
+}
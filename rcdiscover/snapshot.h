@@ -0,0 +1,235 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RCDISCOVER_SNAPSHOT_H
+#define RCDISCOVER_SNAPSHOT_H
+
+#include "deviceinfo.h"
+#include "mapped_file.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace rcdiscover
+{
+
+/**
+ * @brief Header of a binary snapshot file.
+ *
+ * The file consists of the header, count records sorted by MAC address and
+ * a string table of strings_size bytes. All values are little endian.
+ */
+struct SnapshotHeader
+{
+  char magic[8];        ///< "RCDSNAP" followed by 0
+  uint32_t version;
+  uint32_t count;       ///< number of records
+  uint64_t timestamp;   ///< seconds since epoch
+  uint32_t strings_size;
+  uint32_t reserved;
+};
+
+/**
+ * @brief Fixed size record of one device in a binary snapshot.
+ *
+ * Strings are given as offsets into the string table, where they are zero
+ * terminated. Equal strings share the same offset and offset 0 is always
+ * the empty string.
+ */
+struct SnapshotRecord
+{
+  uint64_t mac;
+  uint32_t ip;
+  uint32_t subnet;
+  uint32_t gateway;
+  uint16_t major;
+  uint16_t minor;
+  uint32_t manufacturer_name;
+  uint32_t model_name;
+  uint32_t device_version;
+  uint32_t manufacturer_info;
+  uint32_t serial_number;
+  uint32_t user_name;
+  uint32_t iface_name;
+  uint32_t reserved;
+};
+
+/**
+ * @brief Difference of one device between two snapshots.
+ */
+struct SnapshotChange
+{
+  enum Type
+  {
+    ADDED,
+    REMOVED,
+    CHANGED
+  };
+
+  enum Field
+  {
+    IP = 1,
+    SUBNET = 2,
+    GATEWAY = 4,
+    VERSION = 8,
+    MANUFACTURER_NAME = 16,
+    MODEL_NAME = 32,
+    DEVICE_VERSION = 64,
+    MANUFACTURER_INFO = 128,
+    SERIAL_NUMBER = 256,
+    USER_NAME = 512,
+    IFACE_NAME = 1024
+  };
+
+  uint64_t mac;
+  Type type;
+  unsigned int fields;  ///< bitmask of Field, only set for CHANGED
+  size_t old_index;     ///< index in old snapshot, not set for ADDED
+  size_t new_index;     ///< index in new snapshot, not set for REMOVED
+};
+
+/**
+ * @brief Compact, versioned binary snapshot of a discovery result.
+ *
+ * The snapshot is used in place, i.e. loading a file only maps it into
+ * memory and accessing a device does not involve any parsing.
+ */
+class Snapshot
+{
+  public:
+    /**
+     * @brief Serializes devices into a snapshot.
+     * @param devices devices (invalid devices and duplicates are ignored)
+     * @param timestamp seconds since epoch
+     * @return content of snapshot
+     */
+    static std::vector<uint8_t> serialize(const std::vector<DeviceInfo> &devices,
+                                          uint64_t timestamp);
+
+    /**
+     * @brief Serializes devices into a snapshot file.
+     * @param filename name of file
+     * @param devices devices
+     * @param timestamp seconds since epoch
+     * @throws std::runtime_error if the file cannot be written
+     */
+    static void write(const std::string &filename,
+                      const std::vector<DeviceInfo> &devices,
+                      uint64_t timestamp);
+
+    /**
+     * @brief Constructor. Maps a snapshot file into memory.
+     * @param filename name of file
+     * @throws std::runtime_error if the file cannot be read or is invalid
+     */
+    explicit Snapshot(const std::string &filename);
+
+    /**
+     * @brief Constructor. Uses a snapshot in memory, which must stay valid
+     * and must be aligned to 8 bytes.
+     * @param data snapshot
+     * @param size size of snapshot
+     * @throws std::runtime_error if the snapshot is invalid
+     */
+    Snapshot(const uint8_t *data, size_t size);
+
+    Snapshot(const Snapshot &) = delete;
+    Snapshot &operator=(const Snapshot &) = delete;
+
+    /**
+     * @brief Returns the number of devices.
+     * @return number of devices
+     */
+    size_t size() const { return header_->count; }
+
+    /**
+     * @brief Returns the time at which the snapshot has been taken.
+     * @return seconds since epoch
+     */
+    uint64_t getTimestamp() const { return header_->timestamp; }
+
+    /**
+     * @brief Returns a record.
+     * @param i index of record, which must be smaller than size()
+     * @return record
+     */
+    const SnapshotRecord &getRecord(size_t i) const { return records_[i]; }
+
+    /**
+     * @brief Returns a string of the string table.
+     * @param offset offset as given in a record
+     * @return zero terminated string
+     */
+    const char *getString(uint32_t offset) const { return strings_ + offset; }
+
+    /**
+     * @brief Converts a record into a device.
+     * @param i index of record
+     * @return device
+     */
+    DeviceInfo getDevice(size_t i) const;
+
+    /**
+     * @brief Looks up a device by MAC address via binary search.
+     * @param mac MAC address
+     * @param i set to the index of the record if found
+     * @return true if found
+     */
+    bool find(uint64_t mac, size_t &i) const;
+
+  private:
+    void init(const uint8_t *data, size_t size);
+
+  private:
+    std::unique_ptr<MappedFile> file_;
+
+    const SnapshotHeader *header_;
+    const SnapshotRecord *records_;
+    const char *strings_;
+};
+
+/**
+ * @brief Compares two snapshots in linear time.
+ * @param a old snapshot
+ * @param b new snapshot
+ * @return changes sorted by MAC address
+ */
+std::vector<SnapshotChange> diffSnapshots(const Snapshot &a, const Snapshot &b);
+
+}
+
+#endif // RCDISCOVER_SNAPSHOT_H
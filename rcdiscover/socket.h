@@ -33,8 +33,16 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#ifndef RCDISCOVER_SOCKET_H
+#define RCDISCOVER_SOCKET_H
+
+#include "socket_exception.h"
+#include "trace.h"
+
 #include <vector>
+#include <system_error>
 #include <cstdint>
+#include <cstddef>
 
 struct sockaddr_in;
 
@@ -86,10 +94,76 @@ class Socket
     /**
      * @brief Sends data.
      * @param sendbuf data to send
+     * @throws NetworkUnreachableException or SocketException on error
      */
     void send(const std::vector<uint8_t>& sendbuf)
     {
-      getDerived().sendImpl(sendbuf);
+      throwOnError(trySend(sendbuf));
+    }
+
+    /**
+     * @brief Sends data without throwing exceptions.
+     * @param sendbuf data to send
+     * @return system error, false if successful
+     */
+    std::error_code trySend(const std::vector<uint8_t>& sendbuf) noexcept
+    {
+      RCDISCOVER_TRACE_SCOPE("send", sendbuf.size());
+      return getDerived().trySendImpl(sendbuf);
+    }
+
+    /**
+     * @brief Sends data to a single host instead of the destination address
+     * of the socket, using the same port.
+     * @param sendbuf data to send
+     * @param dst_ip IPv4 address of host in host byte order
+     * @throws NetworkUnreachableException or SocketException on error
+     */
+    void sendTo(const std::vector<uint8_t>& sendbuf, uint32_t dst_ip)
+    {
+      throwOnError(trySendTo(sendbuf, dst_ip));
+    }
+
+    /**
+     * @brief Sends data to a single host without throwing exceptions.
+     * @param sendbuf data to send
+     * @param dst_ip IPv4 address of host in host byte order
+     * @return system error, false if successful
+     */
+    std::error_code trySendTo(const std::vector<uint8_t>& sendbuf,
+                              uint32_t dst_ip) noexcept
+    {
+      RCDISCOVER_TRACE_SCOPE("send to", sendbuf.size());
+      return getDerived().trySendToImpl(sendbuf, dst_ip);
+    }
+
+    /**
+     * @brief Sends several datagrams of the same length with as few system
+     * calls as possible.
+     * @param data count consecutive datagrams
+     * @param len length of each datagram
+     * @param count number of datagrams
+     * @throws NetworkUnreachableException or SocketException on error
+     */
+    void sendMultiple(const uint8_t *data, size_t len, size_t count)
+    {
+      throwOnError(trySendMultiple(data, len, count));
+    }
+
+    /**
+     * @brief Sends several datagrams without throwing exceptions.
+     * @param data count consecutive datagrams
+     * @param len length of each datagram
+     * @param count number of datagrams
+     * @return system error, false if all datagrams have been sent. If the
+     * socket buffer of a non-blocking socket does not drain within 100 ms,
+     * std::errc::resource_unavailable_try_again is returned.
+     */
+    std::error_code trySendMultiple(const uint8_t *data, size_t len,
+                                    size_t count) noexcept
+    {
+      RCDISCOVER_TRACE_SCOPE("send multiple", count);
+      return getDerived().trySendMultipleImpl(data, len, count);
     }
 
     /**
@@ -107,6 +181,27 @@ class Socket
     {
       getDerived().enableNonBlockingImpl();
     }
+
+  private:
+    /**
+     * @brief Converts the error of a send operation into an exception.
+     * @param ec system error
+     */
+    static void throwOnError(const std::error_code &ec)
+    {
+      if (ec == std::errc::network_unreachable)
+      {
+        throw NetworkUnreachableException(
+              "Error while sending data - network unreachable", ec.value());
+      }
+
+      if (ec)
+      {
+        throw SocketException("Error while sending data", ec.value());
+      }
+    }
 };
 
-}
\ No newline at end of file
+}
+
+#endif // RCDISCOVER_SOCKET_H
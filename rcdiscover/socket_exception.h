@@ -33,7 +33,11 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#ifndef RCDISCOVER_SOCKET_EXCEPTION_H
+#define RCDISCOVER_SOCKET_EXCEPTION_H
+
 #include <stdexcept>
+#include <string>
 
 namespace rcdiscover
 {
@@ -85,4 +89,6 @@ class NetworkUnreachableException : public SocketException
     virtual ~NetworkUnreachableException() = default;
 };
 
-}
\ No newline at end of file
+}
+
+#endif // RCDISCOVER_SOCKET_EXCEPTION_H
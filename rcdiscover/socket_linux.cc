@@ -36,7 +36,9 @@
 #include "socket_linux.h"
 
 #include "socket_exception.h"
+#include "iface_selection.h"
 #include "operation_not_permitted.h"
+#include "profile.h"
 
 #include <arpa/inet.h>
 #include <unistd.h>
@@ -47,7 +49,9 @@
 #include <netinet/ether.h>
 #include <ifaddrs.h>
 #include <fcntl.h>
+#include <poll.h>
 
+#include <algorithm>
 #include <iostream>
 
 namespace rcdiscover
@@ -65,6 +69,11 @@ const sockaddr_in& SocketLinux::getDestSockAddr() const
   return dst_addr_;
 }
 
+const std::string &SocketLinux::getIfaceName() const
+{
+  return iface_name_;
+}
+
 SocketLinux SocketLinux::create(const in_addr_t dst_ip, const uint16_t port)
 {
   return SocketLinux(AF_INET, SOCK_DGRAM, IPPROTO_UDP, dst_ip, port);
@@ -72,11 +81,49 @@ SocketLinux SocketLinux::create(const in_addr_t dst_ip, const uint16_t port)
 
 std::vector<SocketLinux> SocketLinux::createAndBindForAllInterfaces(
     const uint16_t port)
+{
+  return createAndBind(port, [](const std::string &, uint32_t)
+  {
+    return true;
+  }, true);
+}
+
+std::vector<SocketLinux> SocketLinux::createAndBindForInterfaces(
+    const uint16_t port, const std::vector<std::string> &names)
+{
+  return createAndBind(port, [&names](const std::string &name, uint32_t)
+  {
+    return std::find(names.begin(), names.end(), name) != names.end();
+  }, false);
+}
+
+std::vector<SocketLinux> SocketLinux::createAndBindForInterfaces(
+    const uint16_t port, const InterfaceSelection &selection)
+{
+  // the global broadcast would leave the selected interfaces
+
+  return createAndBind(port, [&selection](const std::string &name,
+                                          uint32_t ip)
+  {
+    return selection.matches(name, ip);
+  }, false);
+}
+
+std::vector<SocketLinux> SocketLinux::createAndBind(
+    const uint16_t port,
+    const std::function<bool(const std::string &, uint32_t)> &filter,
+    const bool global_broadcast_fallback)
 {
   std::vector<SocketLinux> sockets;
 
   ifaddrs *addrs;
-  getifaddrs(&addrs);
+
+  {
+    ScopedTimer timer("enumerate interfaces");
+    getifaddrs(&addrs);
+  }
+
+  ScopedTimer timer("create sockets");
 
   bool global_broadcast = true;
 
@@ -92,12 +139,16 @@ std::vector<SocketLinux> SocketLinux::createAndBindForAllInterfaces(
         baddr != nullptr)
     {
       std::string name(addr->ifa_name);
-      if (name.length() != 0 && name != "lo")
+      const uint32_t ip = ntohl(reinterpret_cast<struct sockaddr_in *>(
+        addr->ifa_addr)->sin_addr.s_addr);
+
+      if (name.length() != 0 && name != "lo" && filter(name, ip))
       {
         sockets.emplace_back(
               SocketLinux::create(
                 broadcast_addr_,
                 port));
+        sockets.back().iface_name_ = name;
 
         sockaddr_in addr;
         addr.sin_family = AF_INET;
@@ -122,7 +173,7 @@ std::vector<SocketLinux> SocketLinux::createAndBindForAllInterfaces(
   freeifaddrs(addrs);
   addrs = nullptr;
 
-  if (!global_broadcast)
+  if (!global_broadcast && global_broadcast_fallback)
   {
     // one socket for global broadcast on default interface (mostly eth0)
     sockets.emplace_back(SocketLinux::create(broadcast_addr_, port));
@@ -159,7 +210,8 @@ SocketLinux::SocketLinux(int domain, int type, int protocol,
 
 SocketLinux::SocketLinux(SocketLinux &&other) :
   sock_(-1),
-  dst_addr_(std::move(other.dst_addr_))
+  dst_addr_(std::move(other.dst_addr_)),
+  iface_name_(std::move(other.iface_name_))
 {
   std::swap(sock_, other.sock_);
 }
@@ -167,6 +219,8 @@ SocketLinux::SocketLinux(SocketLinux &&other) :
 SocketLinux &SocketLinux::operator=(SocketLinux &&other)
 {
   std::swap(sock_, other.sock_);
+  std::swap(dst_addr_, other.dst_addr_);
+  std::swap(iface_name_, other.iface_name_);
   return *this;
 }
 
@@ -193,23 +247,107 @@ void SocketLinux::bindImpl(const ::sockaddr_in& addr)
   }
 }
 
-void SocketLinux::sendImpl(const std::vector<uint8_t>& sendbuf)
+std::error_code SocketLinux::trySendImpl(
+    const std::vector<uint8_t>& sendbuf) noexcept
+{
+  return sendToAddr(sendbuf, dst_addr_);
+}
+
+std::error_code SocketLinux::trySendToImpl(const std::vector<uint8_t>& sendbuf,
+                                           uint32_t dst_ip) noexcept
+{
+  sockaddr_in addr = dst_addr_;
+  addr.sin_addr.s_addr = htonl(dst_ip);
+
+  return sendToAddr(sendbuf, addr);
+}
+
+std::error_code SocketLinux::trySendMultipleImpl(const uint8_t *data,
+                                                 const size_t len,
+                                                 const size_t count) noexcept
+{
+  // messages are passed to sendmmsg in chunks, which keeps the headers on
+  // the stack
+
+  const size_t max_batch = 64;
+
+  iovec iov[max_batch];
+  mmsghdr msgs[max_batch];
+
+  size_t sent = 0;
+  while (sent < count)
+  {
+    const size_t n = std::min(count - sent, max_batch);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+      iov[i].iov_base = const_cast<uint8_t *>(data + (sent+i)*len);
+      iov[i].iov_len = len;
+
+      msgs[i].msg_hdr = msghdr();
+      msgs[i].msg_hdr.msg_name = &dst_addr_;
+      msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+      msgs[i].msg_hdr.msg_iov = &iov[i];
+      msgs[i].msg_hdr.msg_iovlen = 1;
+      msgs[i].msg_len = 0;
+    }
+
+    const int ret = ::sendmmsg(sock_, msgs, static_cast<unsigned int>(n), 0);
+    if (ret == -1)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+
+      if (errno == EAGAIN || errno == EWOULDBLOCK)
+      {
+        // wait until the socket buffer has space again, but give up if it
+        // does not drain
+
+        pollfd pfd;
+        pfd.fd = sock_;
+        pfd.events = POLLOUT;
+        pfd.revents = 0;
+
+        const int n = ::poll(&pfd, 1, 100);
+        if (n == 0)
+        {
+          return std::make_error_code(
+                   std::errc::resource_unavailable_try_again);
+        }
+
+        if (n == -1 && errno != EINTR)
+        {
+          return std::error_code(errno, std::system_category());
+        }
+
+        continue;
+      }
+
+      return std::error_code(errno, std::system_category());
+    }
+
+    sent += static_cast<size_t>(ret);
+  }
+
+  return std::error_code();
+}
+
+std::error_code SocketLinux::sendToAddr(const std::vector<uint8_t>& sendbuf,
+                                        const sockaddr_in &addr) const noexcept
 {
   if (::sendto(sock_,
               static_cast<const void *>(sendbuf.data()),
               sendbuf.size(),
               0,
-              reinterpret_cast<const sockaddr *>(&dst_addr_),
+              reinterpret_cast<const sockaddr *>(&addr),
               static_cast<socklen_t>(sizeof(sockaddr_in))) == -1)
-   {
-     if (errno == 101)
-     {
-       throw NetworkUnreachableException(
-             "Error while sending data - network unreachable", errno);
-     }
-
-     throw SocketException("Error while sending data", errno);
-   }
+  {
+    return std::error_code(errno, std::system_category());
+  }
+
+  return std::error_code();
 }
 
 void SocketLinux::enableBroadcastImpl()
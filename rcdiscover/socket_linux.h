@@ -39,12 +39,15 @@
 #include "socket.h"
 
 #include <string>
+#include <functional>
 
 #include <netinet/in.h>
 
 namespace rcdiscover
 {
 
+class InterfaceSelection;
+
 /**
  * @brief Socket implementation for Linux.
  */
@@ -75,6 +78,27 @@ class SocketLinux : public Socket<SocketLinux>
      */
     static std::vector<SocketLinux> createAndBindForAllInterfaces(uint16_t port);
 
+    /**
+     * @brief Creates sockets for the given interfaces only and binds them to
+     * the respective interface.
+     * @param port destination port
+     * @param names names of the interfaces
+     * @return vector of sockets, which is empty if none of the interfaces
+     * exists
+     */
+    static std::vector<SocketLinux> createAndBindForInterfaces(
+        uint16_t port, const std::vector<std::string> &names);
+
+    /**
+     * @brief Creates sockets for the selected interfaces only and binds them
+     * to the respective interface.
+     * @param port destination port
+     * @param selection selection of interfaces by name or subnet
+     * @return vector of sockets, which is empty if no interface is selected
+     */
+    static std::vector<SocketLinux> createAndBindForInterfaces(
+        uint16_t port, const InterfaceSelection &selection);
+
     /**
      * @brief Constructor.
      * @param domain domain of socket()
@@ -95,6 +119,14 @@ class SocketLinux : public Socket<SocketLinux>
      */
     const sockaddr_in& getDestSockAddr() const;
 
+    /**
+     * @brief Returns the name of the interface for which the socket was
+     * created.
+     * @return interface name, or empty string for the global broadcast
+     * socket
+     */
+    const std::string &getIfaceName() const;
+
     /**
      * @brief Returns the broadcast address.
      * @return broadcast address
@@ -117,8 +149,28 @@ class SocketLinux : public Socket<SocketLinux>
     /**
      * @brief Sends data.
      * @param sendbuf data buffer
+     * @return system error, false if successful
+     */
+    std::error_code trySendImpl(const std::vector<uint8_t> &sendbuf) noexcept;
+
+    /**
+     * @brief Sends data to a single host.
+     * @param sendbuf data buffer
+     * @param dst_ip IPv4 address of host in host byte order
+     * @return system error, false if successful
      */
-    void sendImpl(const std::vector<uint8_t> &sendbuf);
+    std::error_code trySendToImpl(const std::vector<uint8_t> &sendbuf,
+                                  uint32_t dst_ip) noexcept;
+
+    /**
+     * @brief Sends several datagrams of the same length.
+     * @param data count consecutive datagrams
+     * @param len length of each datagram
+     * @param count number of datagrams
+     * @return system error, false if successful
+     */
+    std::error_code trySendMultipleImpl(const uint8_t *data, size_t len,
+                                        size_t count) noexcept;
 
     /**
      * @brief Enables broadcast for this socket.
@@ -131,6 +183,22 @@ class SocketLinux : public Socket<SocketLinux>
     void enableNonBlockingImpl();
 
   private:
+    /**
+     * @brief Creates sockets for all interfaces that are accepted by the
+     * filter.
+     * @param port destination port
+     * @param filter returns true for the name and IPv4 address (in host
+     * byte order) of interfaces to be used
+     * @param global_broadcast_fallback whether an additional socket for
+     * global broadcast on the default interface is created if binding to
+     * devices is not permitted
+     * @return vector of sockets
+     */
+    static std::vector<SocketLinux> createAndBind(
+        uint16_t port,
+        const std::function<bool(const std::string &, uint32_t)> &filter,
+        bool global_broadcast_fallback);
+
     /**
      * @brief Binds this socket to a specific device
      * (root privileges are required).
@@ -140,10 +208,20 @@ class SocketLinux : public Socket<SocketLinux>
      */
     void bindToDevice(const std::string &device);
 
+    /**
+     * @brief Sends data to the given address.
+     * @param sendbuf data buffer
+     * @param addr destination address
+     * @return system error, false if successful
+     */
+    std::error_code sendToAddr(const std::vector<uint8_t> &sendbuf,
+                               const sockaddr_in &addr) const noexcept;
+
   private:
     const static in_addr_t broadcast_addr_;
     int sock_;
     sockaddr_in dst_addr_;
+    std::string iface_name_;
 };
 
 }
@@ -36,9 +36,13 @@
 #include "socket_windows.h"
 
 #include "socket_exception.h"
+#include "iface_selection.h"
+#include "profile.h"
 
 #include <iphlpapi.h>
 
+#include <algorithm>
+
 namespace rcdiscover
 {
 
@@ -49,6 +53,16 @@ const ULONG &SocketWindows::getBroadcastAddr()
   return broadcast_addr_;
 }
 
+const sockaddr_in& SocketWindows::getDestSockAddr() const
+{
+  return dst_addr_;
+}
+
+const std::string &SocketWindows::getIfaceName() const
+{
+  return iface_name_;
+}
+
 SocketWindows SocketWindows::create(const ULONG dst_ip, const uint16_t port)
 {
   return SocketWindows(AF_INET,
@@ -60,31 +74,68 @@ SocketWindows SocketWindows::create(const ULONG dst_ip, const uint16_t port)
 
 std::vector<SocketWindows> SocketWindows::createAndBindForAllInterfaces(
   const uint16_t port)
+{
+  return createAndBind(port, [](const std::string &, uint32_t)
+  {
+    return true;
+  });
+}
+
+std::vector<SocketWindows> SocketWindows::createAndBindForInterfaces(
+  const uint16_t port, const std::vector<std::string> &names)
+{
+  return createAndBind(port, [&names](const std::string &name, uint32_t)
+  {
+    return std::find(names.begin(), names.end(), name) != names.end();
+  });
+}
+
+std::vector<SocketWindows> SocketWindows::createAndBindForInterfaces(
+  const uint16_t port, const InterfaceSelection &selection)
+{
+  return createAndBind(port, [&selection](const std::string &name,
+                                          uint32_t ip)
+  {
+    return selection.matches(name, ip);
+  });
+}
+
+std::vector<SocketWindows> SocketWindows::createAndBind(
+  const uint16_t port,
+  const std::function<bool(const std::string &, uint32_t)> &filter)
 {
   ULONG forward_tab_size = 0;
   PMIB_IPFORWARDTABLE table = nullptr;
 
   int result = NO_ERROR;
-  for (int i = 0; i < 5; ++i)
+
   {
-    result = GetIpForwardTable(table, &forward_tab_size, false);
+    ScopedTimer timer("enumerate interfaces");
 
-    if (result == NO_ERROR)
-    {
-      break;
-    }
-    else if (result == ERROR_INSUFFICIENT_BUFFER)
+    for (int i = 0; i < 5; ++i)
     {
-      free(table);
-      table = (PMIB_IPFORWARDTABLE)malloc(forward_tab_size);
+      result = GetIpForwardTable(table, &forward_tab_size, false);
+
+      if (result == NO_ERROR)
+      {
+        break;
+      }
+      else if (result == ERROR_INSUFFICIENT_BUFFER)
+      {
+        free(table);
+        table = (PMIB_IPFORWARDTABLE)malloc(forward_tab_size);
+      }
     }
   }
+
   if (result != NO_ERROR)
   {
     throw SocketException("Error while getting forward table",
                           ::WSAGetLastError());
   }
 
+  ScopedTimer timer("create sockets");
+
   std::vector<SocketWindows> sockets;
   for (unsigned int i = 0; i < table->dwNumEntries; ++i)
   {
@@ -96,7 +147,17 @@ std::vector<SocketWindows> SocketWindows::createAndBindForAllInterfaces(
       continue;
     }
 
+    in_addr iface_addr;
+    iface_addr.s_addr = row->dwForwardNextHop;
+    const std::string name(inet_ntoa(iface_addr));
+
+    if (!filter(name, ntohl(row->dwForwardNextHop)))
+    {
+      continue;
+    }
+
     sockets.emplace_back(SocketWindows::create(broadcast_addr_, port));
+    sockets.back().iface_name_ = name;
 
     sockaddr_in src_addr;
     src_addr.sin_family = AF_INET;
@@ -129,7 +190,8 @@ SocketWindows::SocketWindows(int domain,
 
 SocketWindows::SocketWindows(SocketWindows&& other) :
   sock_(INVALID_SOCKET),
-  dst_addr_(other.dst_addr_)
+  dst_addr_(other.dst_addr_),
+  iface_name_(std::move(other.iface_name_))
 {
   std::swap(sock_, other.sock_);
 }
@@ -137,6 +199,8 @@ SocketWindows::SocketWindows(SocketWindows&& other) :
 SocketWindows& SocketWindows::operator=(SocketWindows&& other)
 {
   std::swap(sock_, other.sock_);
+  std::swap(dst_addr_, other.dst_addr_);
+  std::swap(iface_name_, other.iface_name_);
   return *this;
 }
 
@@ -163,27 +227,62 @@ void SocketWindows::bindImpl(const sockaddr_in& addr)
   }
 }
 
-void SocketWindows::sendImpl(const std::vector<uint8_t>& sendbuf)
+std::error_code SocketWindows::trySendImpl(
+    const std::vector<uint8_t>& sendbuf) noexcept
+{
+  return sendToAddr(sendbuf.data(), sendbuf.size(), dst_addr_);
+}
+
+std::error_code SocketWindows::trySendToImpl(
+    const std::vector<uint8_t>& sendbuf, uint32_t dst_ip) noexcept
+{
+  sockaddr_in addr = dst_addr_;
+  addr.sin_addr.s_addr = htonl(dst_ip);
+
+  return sendToAddr(sendbuf.data(), sendbuf.size(), addr);
+}
+
+std::error_code SocketWindows::trySendMultipleImpl(const uint8_t *data,
+                                                   const size_t len,
+                                                   const size_t count) noexcept
 {
-  auto sb = sendbuf;
+  // Windows does not provide sendmmsg, thus all datagrams are passed
+  // separately
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    const std::error_code ec = sendToAddr(data+i*len, len, dst_addr_);
+    if (ec)
+    {
+      return ec;
+    }
+  }
 
+  return std::error_code();
+}
+
+std::error_code SocketWindows::sendToAddr(const uint8_t *data, size_t len,
+                                          const sockaddr_in &addr) const noexcept
+{
   WSABUF wsa_buffer;
-  wsa_buffer.len = sb.size();
-  wsa_buffer.buf = reinterpret_cast<char *>(sb.data());
+  wsa_buffer.len = static_cast<ULONG>(len);
+  wsa_buffer.buf = reinterpret_cast<char *>(const_cast<uint8_t *>(data));
 
-  DWORD len;
+  DWORD sent;
   if (::WSASendTo(sock_,
              &wsa_buffer,
              1,
-             &len,
+             &sent,
              0,
-             reinterpret_cast<const struct sockaddr *>(&dst_addr_),
-             sizeof(dst_addr_),
+             reinterpret_cast<const struct sockaddr *>(&addr),
+             sizeof(addr),
              nullptr,
              nullptr) == SOCKET_ERROR)
-   {
-     throw SocketException("Error while sending data", ::WSAGetLastError());
-   }
+  {
+    return std::error_code(::WSAGetLastError(), std::system_category());
+  }
+
+  return std::error_code();
 }
 
 void SocketWindows::enableBroadcastImpl()
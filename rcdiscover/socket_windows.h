@@ -35,11 +35,16 @@
 
 #include "socket.h"
 
+#include <string>
+#include <functional>
+
 #include <winsock2.h>
 
 namespace rcdiscover
 {
 
+class InterfaceSelection;
+
 class SocketWindows : public Socket<SocketWindows>
 {
   friend class Socket<SocketWindows>;
@@ -68,6 +73,27 @@ class SocketWindows : public Socket<SocketWindows>
     static std::vector<SocketWindows> createAndBindForAllInterfaces(
       uint16_t port);
 
+    /**
+     * @brief Creates sockets for the given interfaces only and binds them to
+     * the respective interface.
+     * @param port destination port
+     * @param names names of the interfaces as returned by getIfaceName()
+     * @return vector of sockets, which is empty if none of the interfaces
+     * exists
+     */
+    static std::vector<SocketWindows> createAndBindForInterfaces(
+      uint16_t port, const std::vector<std::string> &names);
+
+    /**
+     * @brief Creates sockets for the selected interfaces only and binds them
+     * to the respective interface.
+     * @param port destination port
+     * @param selection selection of interfaces by name or subnet
+     * @return vector of sockets, which is empty if no interface is selected
+     */
+    static std::vector<SocketWindows> createAndBindForInterfaces(
+      uint16_t port, const InterfaceSelection &selection);
+
     /**
      * @brief Constructor.
      * @param domain domain of socket()
@@ -82,6 +108,19 @@ class SocketWindows : public Socket<SocketWindows>
     SocketWindows &operator=(SocketWindows &&other);
     ~SocketWindows();
 
+    /**
+     * @brief Returns the sockaddr to which the socket is bound.
+     * @return sockaddr to which the socket is bound.
+     */
+    const sockaddr_in& getDestSockAddr() const;
+
+    /**
+     * @brief Returns the name of the interface for which the socket was
+     * created, which is the IP address of the interface on Windows.
+     * @return interface name
+     */
+    const std::string &getIfaceName() const;
+
     /**
      * @brief Returns the broadcast address.
      * @return broadcast address
@@ -104,8 +143,28 @@ class SocketWindows : public Socket<SocketWindows>
     /**
      * @brief Sends data.
      * @param sendbuf data buffer
+     * @return system error, false if successful
      */
-    void sendImpl(const std::vector<uint8_t> &sendbuf);
+    std::error_code trySendImpl(const std::vector<uint8_t> &sendbuf) noexcept;
+
+    /**
+     * @brief Sends data to a single host.
+     * @param sendbuf data buffer
+     * @param dst_ip IPv4 address of host in host byte order
+     * @return system error, false if successful
+     */
+    std::error_code trySendToImpl(const std::vector<uint8_t> &sendbuf,
+                                  uint32_t dst_ip) noexcept;
+
+    /**
+     * @brief Sends several datagrams of the same length.
+     * @param data count consecutive datagrams
+     * @param len length of each datagram
+     * @param count number of datagrams
+     * @return system error, false if successful
+     */
+    std::error_code trySendMultipleImpl(const uint8_t *data, size_t len,
+                                        size_t count) noexcept;
 
     /**
      * @brief Enables broadcast for this socket.
@@ -117,10 +176,34 @@ class SocketWindows : public Socket<SocketWindows>
      */
     void enableNonBlockingImpl();
 
+  private:
+    /**
+     * @brief Creates sockets for all interfaces that are accepted by the
+     * filter.
+     * @param port destination port
+     * @param filter returns true for the name and IPv4 address (in host
+     * byte order) of interfaces to be used
+     * @return vector of sockets
+     */
+    static std::vector<SocketWindows> createAndBind(
+      uint16_t port,
+      const std::function<bool(const std::string &, uint32_t)> &filter);
+
+    /**
+     * @brief Sends one datagram to the given address.
+     * @param data datagram
+     * @param len length of datagram
+     * @param addr destination address
+     * @return system error, false if successful
+     */
+    std::error_code sendToAddr(const uint8_t *data, size_t len,
+                               const sockaddr_in &addr) const noexcept;
+
   private:
     const static ULONG broadcast_addr_;
     SOCKET sock_;
     sockaddr_in dst_addr_;
+    std::string iface_name_;
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,257 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "trace.h"
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <new>
+#include <cstdio>
+
+namespace rcdiscover
+{
+
+namespace
+{
+
+const uint64_t CAPACITY = 8192;
+
+/*
+  Ring buffer of one thread. Only the owning thread writes events and
+  publishes them by incrementing head. Buffers are never freed, but handed
+  over to new threads after the owning thread has finished.
+*/
+
+struct ThreadBuffer
+{
+  std::atomic<bool> owned;
+  std::atomic<uint64_t> head;
+  TraceEvent events[CAPACITY];
+  ThreadBuffer *next;
+};
+
+std::atomic<ThreadBuffer *> buffers(nullptr);
+std::atomic<uint32_t> next_tid(1);
+
+ThreadBuffer *acquireBuffer() noexcept
+{
+  for (ThreadBuffer *b = buffers.load(std::memory_order_acquire); b != nullptr;
+       b = b->next)
+  {
+    bool owned = false;
+    if (b->owned.compare_exchange_strong(owned, true,
+                                         std::memory_order_acquire))
+    {
+      return b;
+    }
+  }
+
+  ThreadBuffer *b = new (std::nothrow) ThreadBuffer;
+  if (b == nullptr)
+  {
+    return nullptr;
+  }
+
+  b->owned.store(true, std::memory_order_relaxed);
+  b->head.store(0, std::memory_order_relaxed);
+
+  b->next = buffers.load(std::memory_order_relaxed);
+  while (!buffers.compare_exchange_weak(b->next, b,
+                                        std::memory_order_release,
+                                        std::memory_order_relaxed))
+  { }
+
+  return b;
+}
+
+/*
+  Buffer of the current thread, which is released when the thread ends.
+*/
+
+struct BufferHandle
+{
+  ThreadBuffer *buffer = nullptr;
+  uint32_t tid = 0;
+
+  ~BufferHandle()
+  {
+    if (buffer != nullptr)
+    {
+      buffer->owned.store(false, std::memory_order_release);
+    }
+  }
+};
+
+thread_local BufferHandle handle;
+
+void push(const char *name, char phase, uint64_t ts, uint64_t dur,
+          uint64_t arg) noexcept
+{
+  BufferHandle &h = handle;
+
+  if (h.buffer == nullptr)
+  {
+    h.buffer = acquireBuffer();
+    if (h.buffer == nullptr)
+    {
+      return;
+    }
+
+    h.tid = next_tid.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  const uint64_t i = h.buffer->head.load(std::memory_order_relaxed);
+
+  TraceEvent &e = h.buffer->events[i%CAPACITY];
+  e.ts = ts;
+  e.dur = dur;
+  e.name = name;
+  e.arg = arg;
+  e.tid = h.tid;
+  e.phase = phase;
+
+  h.buffer->head.store(i+1, std::memory_order_release);
+}
+
+/*
+  Copies the events of a buffer, omitting events that may have been
+  overwritten while copying.
+*/
+
+void collect(const ThreadBuffer &b, std::vector<TraceEvent> &events)
+{
+  const uint64_t head = b.head.load(std::memory_order_acquire);
+  const uint64_t first = head > CAPACITY ? head-CAPACITY : 0;
+
+  const size_t offset = events.size();
+  for (uint64_t i = first; i < head; i++)
+  {
+    events.push_back(b.events[i%CAPACITY]);
+  }
+
+  const uint64_t head_after = b.head.load(std::memory_order_acquire);
+  if (head_after >= first+CAPACITY)
+  {
+    const uint64_t lost = std::min(head - first,
+                                   head_after - CAPACITY + 1 - first);
+    events.erase(events.begin() + static_cast<std::ptrdiff_t>(offset),
+                 events.begin() + static_cast<std::ptrdiff_t>(offset + lost));
+  }
+}
+
+}
+
+uint64_t Trace::now() noexcept
+{
+  return static_cast<uint64_t>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void Trace::instant(const char *name, uint64_t arg) noexcept
+{
+  push(name, 'i', now(), 0, arg);
+}
+
+void Trace::complete(const char *name, uint64_t start, uint64_t arg) noexcept
+{
+  push(name, 'X', start, now() - start, arg);
+}
+
+void Trace::writeChromeJson(std::ostream &out)
+{
+  std::vector<TraceEvent> events;
+  for (ThreadBuffer *b = buffers.load(std::memory_order_acquire); b != nullptr;
+       b = b->next)
+  {
+    collect(*b, events);
+  }
+
+  std::sort(events.begin(), events.end(),
+            [](const TraceEvent &a, const TraceEvent &b)
+            { return a.ts < b.ts; });
+
+  // timestamps are given in microseconds relative to the first event
+
+  const uint64_t t0 = events.empty() ? 0 : events.front().ts;
+
+  out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+  for (size_t i = 0; i < events.size(); i++)
+  {
+    const TraceEvent &e = events[i];
+    char ts[32], dur[32];
+    std::snprintf(ts, sizeof(ts), "%.3f",
+                  static_cast<double>(e.ts - t0)/1000.0);
+    std::snprintf(dur, sizeof(dur), "%.3f",
+                  static_cast<double>(e.dur)/1000.0);
+
+    out << (i > 0 ? ",\n" : "\n");
+    out << "{\"name\":\"" << e.name << "\",\"ph\":\"" << e.phase
+        << "\",\"ts\":" << ts;
+
+    if (e.phase == 'X')
+    {
+      out << ",\"dur\":" << dur;
+    }
+    else
+    {
+      out << ",\"s\":\"t\"";
+    }
+
+    out << ",\"pid\":1,\"tid\":" << e.tid << ",\"args\":{\"arg\":" << e.arg
+        << "}}";
+  }
+
+  out << "\n]}\n";
+}
+
+void Trace::writeChromeJson(const std::string &filename)
+{
+  std::ofstream out(filename);
+  writeChromeJson(out);
+  out.close();
+
+  if (!out)
+  {
+    throw std::runtime_error("Cannot write trace: " + filename);
+  }
+}
+
+}
@@ -0,0 +1,165 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RCDISCOVER_TRACE_H
+#define RCDISCOVER_TRACE_H
+
+/*
+  Trace points for fine-grained timing of discovery. They are only compiled
+  if HAVE_TRACING is defined (CMake option WITH_TRACING). Otherwise, the
+  macros expand to nothing and their arguments are not evaluated.
+
+  RCDISCOVER_TRACE_SCOPE(name, arg) records the duration of the enclosing
+  scope, RCDISCOVER_TRACE_INSTANT(name, arg) records a point in time. The
+  name must be a string literal and arg is an arbitrary integer, e.g. the
+  number of bytes.
+*/
+
+#ifdef HAVE_TRACING
+
+#include <string>
+#include <ostream>
+#include <cstdint>
+
+#define RCDISCOVER_TRACE_CONCAT_(a, b) a##b
+#define RCDISCOVER_TRACE_CONCAT(a, b) RCDISCOVER_TRACE_CONCAT_(a, b)
+
+#define RCDISCOVER_TRACE_SCOPE(name, arg) \
+  ::rcdiscover::TraceScope RCDISCOVER_TRACE_CONCAT(rcdiscover_trace_, \
+                                                   __LINE__)(name, arg)
+
+#define RCDISCOVER_TRACE_INSTANT(name, arg) \
+  ::rcdiscover::Trace::instant(name, arg)
+
+namespace rcdiscover
+{
+
+/**
+ * @brief Binary trace event.
+ */
+struct TraceEvent
+{
+  uint64_t ts;       ///< start in nanoseconds of the steady clock
+  uint64_t dur;      ///< duration in nanoseconds, 0 for instant events
+  const char *name;  ///< name as string literal
+  uint64_t arg;      ///< argument
+  uint32_t tid;      ///< thread id as assigned by Trace
+  char phase;        ///< 'X' for complete events, 'i' for instant events
+};
+
+/**
+ * @brief Recording of trace events in per-thread ring buffers.
+ *
+ * Each thread writes into its own ring buffer of 8192 events without locks.
+ * If the buffer is full, the oldest events are overwritten. Buffers of
+ * finished threads are reused by new threads, so that their events are
+ * kept until they are overwritten.
+ */
+class Trace
+{
+  public:
+    /**
+     * @brief Returns the current time in nanoseconds of the steady clock.
+     * @return time
+     */
+    static uint64_t now() noexcept;
+
+    /**
+     * @brief Records an instant event.
+     * @param name name as string literal
+     * @param arg argument
+     */
+    static void instant(const char *name, uint64_t arg) noexcept;
+
+    /**
+     * @brief Records a complete event that ends now.
+     * @param name name as string literal
+     * @param start start as returned by now()
+     * @param arg argument
+     */
+    static void complete(const char *name, uint64_t start,
+                         uint64_t arg) noexcept;
+
+    /**
+     * @brief Writes all recorded events in the Chrome trace event format,
+     * which can be loaded by chrome://tracing or Perfetto. May be called
+     * while events are recorded.
+     * @param out output stream
+     */
+    static void writeChromeJson(std::ostream &out);
+
+    /**
+     * @brief Writes all recorded events to a file in the Chrome trace event
+     * format.
+     * @param filename name of file
+     * @throws std::runtime_error if the file cannot be written
+     */
+    static void writeChromeJson(const std::string &filename);
+};
+
+/**
+ * @brief Records a complete event for the lifetime of the object.
+ */
+class TraceScope
+{
+  public:
+    TraceScope(const char *name, uint64_t arg) noexcept :
+      name_(name), arg_(arg), start_(Trace::now())
+    { }
+
+    ~TraceScope()
+    {
+      Trace::complete(name_, start_, arg_);
+    }
+
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+  private:
+    const char *name_;
+    uint64_t arg_;
+    uint64_t start_;
+};
+
+}
+
+#else
+
+#define RCDISCOVER_TRACE_SCOPE(name, arg) do { } while (0)
+#define RCDISCOVER_TRACE_INSTANT(name, arg) do { } while (0)
+
+#endif
+
+#endif // RCDISCOVER_TRACE_H
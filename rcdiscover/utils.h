@@ -36,10 +36,12 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <array>
 #include <iomanip>
 #include <sstream>
 #include <stdexcept>
 #include <algorithm>
+#include <cstdint>
 
 inline std::string mac2string(const uint64_t mac)
 {
@@ -110,4 +112,55 @@ inline std::array<uint8_t, 4> string2ip(const std::string& ip)
   return string2byte<4>(ip, 10, '.');
 }
 
+/*
+  Parses a subnet in CIDR notation, e.g. 10.0.2.0/24, or a single IP address
+  into network address and mask in host byte order. Returns false if the
+  string is malformed.
+*/
+
+inline bool string2subnet(const std::string& s, uint32_t &net, uint32_t &mask)
+{
+  const size_t slash = s.find('/');
+  const std::string ip = s.substr(0, slash);
+
+  unsigned long bits = 32;
+  if (slash != std::string::npos)
+  {
+    const std::string b = s.substr(slash+1);
+    if (b.empty() || b.size() > 2 ||
+        b.find_first_not_of("0123456789") != std::string::npos)
+    {
+      return false;
+    }
+
+    bits = std::stoul(b);
+  }
+
+  if (bits > 32 || ip.empty() || ip.back() == '.' ||
+      std::count(ip.begin(), ip.end(), '.') != 3)
+  {
+    return false;
+  }
+
+  std::istringstream in(ip);
+  std::string b;
+  net = 0;
+  while (std::getline(in, b, '.'))
+  {
+    if (b.empty() || b.size() > 3 ||
+        b.find_first_not_of("0123456789") != std::string::npos ||
+        std::stoul(b) > 255)
+    {
+      return false;
+    }
+
+    net = (net<<8) | static_cast<uint32_t>(std::stoul(b));
+  }
+
+  mask = bits == 0 ? 0 : ~static_cast<uint32_t>(0) << (32-bits);
+  net &= mask;
+
+  return true;
+}
+
 #endif // UTILS_H
\ No newline at end of file
@@ -42,6 +42,12 @@
 #endif
 
 #include "socket_exception.h"
+#include "operation_not_permitted.h"
+#include "iface_affinity.h"
+#include "metrics.h"
+#include "trace.h"
+
+#include <new>
 
 namespace rcdiscover
 {
@@ -56,6 +62,11 @@ WOL::WOL(std::array<uint8_t, 6> hardware_addr, uint16_t port) noexcept :
   port_{port}
 { }
 
+void WOL::setInterface(const std::string &iface_name)
+{
+  iface_name_ = iface_name;
+}
+
 void WOL::send() const
 {
   sendImpl(nullptr);
@@ -66,27 +77,31 @@ void WOL::send(const std::array<uint8_t, 4>& password) const
   sendImpl(&password);
 }
 
+size_t WOL::trySend(std::vector<IfaceStatus> *status) const noexcept
+{
+  return trySendImpl(nullptr, status);
+}
+
+size_t WOL::trySend(const std::array<uint8_t, 4>& password,
+                    std::vector<IfaceStatus> *status) const noexcept
+{
+  return trySendImpl(&password, status);
+}
+
 std::vector<uint8_t>& WOL::appendMagicPacket(
     std::vector<uint8_t>& sendbuf,
     const std::array<uint8_t, 4> *password) const
 {
-  for (int i = 0; i < 6; ++i)
-  {
-    sendbuf.push_back(0xFF);
-  }
+  sendbuf.reserve(sendbuf.size() + 6 + 16*hardware_addr_.size() + 4);
+
+  sendbuf.insert(sendbuf.end(), 6, 0xFF);
   for (int i = 0; i < 16; ++i)
   {
-    for (size_t j = 0; j < hardware_addr_.size(); ++j)
-    {
-      sendbuf.push_back(hardware_addr_[j]);
-    }
+    sendbuf.insert(sendbuf.end(), hardware_addr_.begin(), hardware_addr_.end());
   }
   if (password != nullptr)
   {
-    for (int i = 0; i < 4; ++i)
-    {
-      sendbuf.push_back((*password)[i]);
-    }
+    sendbuf.insert(sendbuf.end(), password->begin(), password->end());
   }
 
   return sendbuf;
@@ -95,35 +110,153 @@ std::vector<uint8_t>& WOL::appendMagicPacket(
 template<uint8_t num>
 std::array<uint8_t, num> WOL::toByteArray(uint64_t data) noexcept
 {
+  // most significant byte first, as the MAC is stored by DeviceInfo
+
   std::array<uint8_t, num> result;
   for (uint8_t i = 0; i < num; ++i)
   {
-    result[i] = static_cast<uint8_t>((data >> (i*8)) & 0xFF);
+    result[i] = static_cast<uint8_t>((data >> ((num-1-i)*8)) & 0xFF);
   }
   return result;
 }
 
-void WOL::sendImpl(const std::array<uint8_t, 4> *password) const
+std::vector<WOL::SocketType> WOL::openSockets() const
 {
-  auto sockets = SocketType::createAndBindForAllInterfaces(port_);
+  std::string iface_name = iface_name_;
+  if (iface_name.empty())
+  {
+    uint64_t mac = 0;
+    for (const uint8_t b : hardware_addr_)
+    {
+      mac = (mac << 8) | b;
+    }
 
-  for (auto &socket : sockets)
+    iface_name = IfaceAffinity::lookup(mac);
+  }
+
+  std::vector<SocketType> sockets;
+  if (!iface_name.empty())
   {
-    std::vector<uint8_t> sendbuf;
-    appendMagicPacket(sendbuf, password);
+    sockets = SocketType::createAndBindForInterfaces(port_, {iface_name});
+  }
 
+  if (sockets.empty())
+  {
+    sockets = SocketType::createAndBindForAllInterfaces(port_);
+  }
+
+  for (auto &socket : sockets)
+  {
     socket.enableBroadcast();
     socket.enableNonBlocking();
+  }
+
+  return sockets;
+}
+
+size_t WOL::sendOnSockets(std::vector<SocketType> &sockets,
+                          const std::vector<uint8_t> &sendbuf,
+                          std::vector<IfaceStatus> *status) noexcept
+{
+  RCDISCOVER_TRACE_SCOPE("wol send", sockets.size());
+
+  if (status != nullptr)
+  {
+    status->resize(sockets.size());
+  }
+
+  size_t ret = 0;
+  for (size_t i = 0; i < sockets.size(); ++i)
+  {
+    const std::error_code ec = sockets[i].trySend(sendbuf);
+
+    if (status != nullptr)
+    {
+      (*status)[i].iface_name = sockets[i].getIfaceName();
+      (*status)[i].error = ec;
+    }
+
+    if (!ec)
+    {
+      ret++;
+    }
+  }
+
+  return ret;
+}
+
+void WOL::sendImpl(const std::array<uint8_t, 4> *password) const
+{
+  std::vector<SocketType> sockets = openSockets();
 
-    try
+  std::vector<uint8_t> sendbuf;
+  appendMagicPacket(sendbuf, password);
+
+  std::vector<IfaceStatus> status;
+  sendOnSockets(sockets, sendbuf, &status);
+
+  // down interfaces are expected
+
+  for (const auto &st : status)
+  {
+    if (st.error && st.error != std::errc::network_unreachable)
     {
-      socket.send(sendbuf);
+      throw SocketException("Error while sending data", st.error.value());
     }
-    catch(const NetworkUnreachableException &)
+  }
+
+  if (password != nullptr)
+  {
+    Metrics::recordReset((*password)[3]);
+  }
+}
+
+size_t WOL::trySendImpl(const std::array<uint8_t, 4> *password,
+                        std::vector<IfaceStatus> *status) const noexcept
+{
+  std::error_code ec;
+
+  try
+  {
+    std::vector<SocketType> sockets = openSockets();
+
+    std::vector<uint8_t> sendbuf;
+    appendMagicPacket(sendbuf, password);
+
+    const size_t ret = sendOnSockets(sockets, sendbuf, status);
+
+    if (ret > 0 && password != nullptr)
     {
-      continue;
+      Metrics::recordReset((*password)[3]);
     }
+
+    return ret;
+  }
+  catch(const OperationNotPermitted &)
+  {
+    ec = std::make_error_code(std::errc::operation_not_permitted);
   }
+  catch(const SocketException &ex)
+  {
+    ec = std::error_code(ex.get_error_code(), std::system_category());
+  }
+  catch(const std::bad_alloc &)
+  {
+    ec = std::make_error_code(std::errc::not_enough_memory);
+  }
+  catch(...)
+  {
+    ec = std::make_error_code(std::errc::io_error);
+  }
+
+  if (status != nullptr)
+  {
+    status->resize(1);
+    (*status)[0].iface_name.clear();
+    (*status)[0].error = ec;
+  }
+
+  return 0;
 }
 
-}
\ No newline at end of file
+}
@@ -36,7 +36,10 @@
 #ifndef WOL_H
 #define WOL_H
 
+#include "iface_status.h"
+
 #include <array>
+#include <string>
 #include <vector>
 #include <memory>
 #include <cstdint>
@@ -85,8 +88,22 @@ class WOL
     ~WOL() = default;
 
   public:
+    /**
+     * @brief Sets the interface on which the Magic Packet is sent.
+     *
+     * If no interface is set, the interface on which the rc_visard answered
+     * the most recent discovery in this process is used (see IfaceAffinity).
+     * If this is not known either or the interface does not exist anymore,
+     * the Magic Packet is sent on all interfaces.
+     * @param iface_name name of interface, empty for automatic selection
+     */
+    void setInterface(const std::string &iface_name);
+
     /**
      * @brief Send Magic Packet without any data ("password").
+     *
+     * NOTE: Exceptions are thrown in case of network errors, except for
+     * interfaces on which the network is unreachable.
      */
     void send() const;
 
@@ -96,6 +113,26 @@ class WOL
      */
     void send(const std::array<uint8_t, 4>& password) const;
 
+    /**
+     * @brief Send Magic Packet without any data ("password") without
+     * throwing exceptions.
+     * @param status if not null, it is set to the result for each interface.
+     * If the sockets cannot be created, it contains one entry with empty
+     * interface name.
+     * @return number of interfaces on which the Magic Packet has been sent
+     */
+    size_t trySend(std::vector<IfaceStatus> *status=nullptr) const noexcept;
+
+    /**
+     * @brief Send Magic Packet with data ("password") without throwing
+     * exceptions.
+     * @param password data to send
+     * @param status see trySend()
+     * @return number of interfaces on which the Magic Packet has been sent
+     */
+    size_t trySend(const std::array<uint8_t, 4>& password,
+                   std::vector<IfaceStatus> *status=nullptr) const noexcept;
+
   private:
     /**
      * @brief Appends a magic packet to a data buffer.
@@ -120,9 +157,36 @@ class WOL
      */
     void sendImpl(const std::array<uint8_t, 4> *password) const;
 
+    /**
+     * @brief Non-throwing counterpart of sendImpl().
+     * @param password data to send (null if non)
+     * @param status result for each interface (may be null)
+     * @return number of interfaces on which the Magic Packet has been sent
+     */
+    size_t trySendImpl(const std::array<uint8_t, 4> *password,
+                       std::vector<IfaceStatus> *status) const noexcept;
+
+    /**
+     * @brief Creates broadcast sockets for the selected interfaces.
+     * @return sockets
+     */
+    std::vector<SocketType> openSockets() const;
+
+    /**
+     * @brief Sends the data on all sockets.
+     * @param sockets sockets
+     * @param sendbuf data to send
+     * @param status result for each socket (may be null)
+     * @return number of sockets on which the data has been sent
+     */
+    static size_t sendOnSockets(std::vector<SocketType> &sockets,
+                                const std::vector<uint8_t> &sendbuf,
+                                std::vector<IfaceStatus> *status) noexcept;
+
   private:
     const std::array<uint8_t, 6> hardware_addr_;
     uint16_t port_;
+    std::string iface_name_;
 };
 
 }
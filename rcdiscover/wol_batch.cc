@@ -0,0 +1,279 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "wol_batch.h"
+
+#ifdef WIN32
+#include "socket_windows.h"
+#else
+#include "socket_linux.h"
+#endif
+
+#include "socket_exception.h"
+#include "iface_affinity.h"
+#include "metrics.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <system_error>
+
+namespace rcdiscover
+{
+
+#ifdef WIN32
+typedef SocketWindows SocketImpl;
+#else
+typedef SocketLinux SocketImpl;
+#endif
+
+const size_t WOLBatch::PACKET_SIZE;
+
+WOLBatch::WOLBatch(uint16_t port) noexcept :
+  port_(port),
+  batch_size_(64),
+  pacing_(0)
+{ }
+
+void WOLBatch::add(uint64_t hardware_addr, uint8_t func_id,
+                   const std::string &iface_name)
+{
+  std::array<uint8_t, 6> mac;
+  for (size_t i = 0; i < mac.size(); ++i)
+  {
+    mac[i] = static_cast<uint8_t>((hardware_addr >> ((5-i)*8)) & 0xFF);
+  }
+
+  add(mac, func_id, iface_name);
+}
+
+void WOLBatch::add(const std::array<uint8_t, 6> &hardware_addr,
+                   uint8_t func_id, const std::string &iface_name)
+{
+  if (!isResetFunction(func_id))
+  {
+    throw std::invalid_argument("Unknown reset function id");
+  }
+
+  const size_t offset = packets_.size();
+  packets_.resize(offset + PACKET_SIZE);
+
+  auto p = packets_.begin() + static_cast<std::ptrdiff_t>(offset);
+  p = std::fill_n(p, 6, 0xFF);
+  for (int i = 0; i < 16; ++i)
+  {
+    p = std::copy(hardware_addr.begin(), hardware_addr.end(), p);
+  }
+  p = std::fill_n(p, 3, 0xEE);
+  *p = func_id;
+
+  ifaces_.push_back(iface_name);
+}
+
+void WOLBatch::setBatchSize(size_t batch_size)
+{
+  batch_size_ = std::max<size_t>(batch_size, 1);
+}
+
+void WOLBatch::setPacing(std::chrono::microseconds pacing)
+{
+  pacing_ = pacing;
+}
+
+size_t WOLBatch::send(const ProgressCallback &progress) const
+{
+  const size_t count = size();
+
+  // resolve the interface of each device
+
+  std::vector<std::string> ifaces(count);
+  bool all_known = true;
+  std::vector<std::string> names;
+
+  for (size_t k = 0; k < count; ++k)
+  {
+    ifaces[k] = ifaces_[k];
+
+    if (ifaces[k].empty())
+    {
+      uint64_t mac = 0;
+      for (size_t i = 0; i < 6; ++i)
+      {
+        mac = (mac << 8) | packets_[k*PACKET_SIZE + 6 + i];
+      }
+
+      ifaces[k] = IfaceAffinity::lookup(mac);
+    }
+
+    if (ifaces[k].empty())
+    {
+      all_known = false;
+    }
+    else if (std::find(names.begin(), names.end(), ifaces[k]) == names.end())
+    {
+      names.push_back(ifaces[k]);
+    }
+  }
+
+  // only create sockets for the required interfaces if possible
+
+  std::vector<SocketImpl> sockets;
+  if (all_known)
+  {
+    sockets = SocketImpl::createAndBindForInterfaces(port_, names);
+  }
+
+  for (const auto &name : names)
+  {
+    if (std::none_of(sockets.begin(), sockets.end(),
+                     [&name](const SocketImpl &socket)
+                     { return socket.getIfaceName() == name; }))
+    {
+      all_known = false;
+    }
+  }
+
+  if (!all_known)
+  {
+    sockets = SocketImpl::createAndBindForAllInterfaces(port_);
+  }
+
+  // assign packets to sockets, falling back to all sockets if the interface
+  // of a device is unknown or does not exist anymore (sockets without
+  // interface name, e.g. the global broadcast socket, never match)
+
+  std::vector<std::vector<uint8_t>> buffers(sockets.size());
+  size_t total = 0;
+
+  for (size_t k = 0; k < count; ++k)
+  {
+    const auto packet = packets_.begin() +
+                        static_cast<std::ptrdiff_t>(k*PACKET_SIZE);
+
+    bool found = false;
+    for (size_t i = 0; i < sockets.size() && !ifaces[k].empty(); ++i)
+    {
+      if (sockets[i].getIfaceName() == ifaces[k])
+      {
+        buffers[i].insert(buffers[i].end(), packet, packet + PACKET_SIZE);
+        found = true;
+        total++;
+      }
+    }
+
+    if (!found)
+    {
+      for (auto &buffer : buffers)
+      {
+        buffer.insert(buffer.end(), packet, packet + PACKET_SIZE);
+        total++;
+      }
+    }
+  }
+
+  for (auto &socket : sockets)
+  {
+    socket.enableBroadcast();
+  }
+
+  // packets for unreachable interfaces or sockets whose buffer does not
+  // drain are counted as failed, but do not stop sending on the others
+
+  std::vector<bool> usable(sockets.size(), true);
+  size_t sent = 0;
+  size_t failed = 0;
+
+  for (size_t start = 0; sent < total; start += batch_size_)
+  {
+    for (size_t i = 0; i < sockets.size(); ++i)
+    {
+      const size_t available = buffers[i].size()/PACKET_SIZE;
+      if (start >= available)
+      {
+        continue;
+      }
+
+      const size_t n = std::min(batch_size_, available - start);
+
+      if (usable[i])
+      {
+        const std::error_code ec = sockets[i].trySendMultiple(
+            buffers[i].data() + start*PACKET_SIZE, PACKET_SIZE, n);
+
+        if (ec == std::errc::network_unreachable ||
+            ec == std::errc::resource_unavailable_try_again)
+        {
+          usable[i] = false;
+        }
+        else if (ec)
+        {
+          throw SocketException("Error while sending data", ec.value());
+        }
+      }
+
+      if (!usable[i])
+      {
+        failed += n;
+      }
+
+      sent += n;
+    }
+
+    if (progress)
+    {
+      progress(sent, total);
+    }
+
+    if (pacing_.count() > 0 && sent < total)
+    {
+      std::this_thread::sleep_for(pacing_);
+    }
+  }
+
+  for (size_t k = 0; k < count; ++k)
+  {
+    Metrics::recordReset(packets_[k*PACKET_SIZE + PACKET_SIZE - 1]);
+  }
+
+  return failed;
+}
+
+bool WOLBatch::isResetFunction(uint8_t func_id)
+{
+  return func_id == 0xAA || func_id == 0xBB || func_id == 0xCC ||
+         func_id == 0xFF;
+}
+
+}
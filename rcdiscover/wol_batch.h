@@ -0,0 +1,161 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RCDISCOVER_WOL_BATCH_H
+#define RCDISCOVER_WOL_BATCH_H
+
+#include <array>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+namespace rcdiscover
+{
+
+/**
+ * @brief Magic Packet (Wake-on-Lan (WOL)) reset of many rc_visards at once.
+ *
+ * All magic packets are computed when the devices are added. Sending uses one
+ * socket per interface for the whole batch and passes as many packets as
+ * possible per system call. Each packet is only sent on the interface on
+ * which the device lives, if this is known. Otherwise, it is sent on all
+ * interfaces.
+ */
+class WOLBatch
+{
+  public:
+    /**
+     * @brief Callback for reporting progress.
+     *
+     * The first parameter is the number of packets sent so far, the second
+     * the total number of packets over all interfaces.
+     */
+    typedef std::function<void(size_t, size_t)> ProgressCallback;
+
+    /**
+     * @brief Size of a Magic Packet including function id ("password").
+     */
+    static const size_t PACKET_SIZE = 6 + 16*6 + 4;
+
+  public:
+    /**
+     * @brief Constructor.
+     * @param port destination UDP port
+     */
+    explicit WOLBatch(uint16_t port) noexcept;
+
+    /**
+     * @brief Adds an rc_visard to the batch.
+     * @param hardware_addr MAC-address of rc_visard
+     * @param func_id reset function (0xAA: parameters, 0xBB: GigE, 0xCC:
+     * switch partition, 0xFF: all)
+     * @param iface_name interface on which the rc_visard lives. If empty, the
+     * interface on which it answered the most recent discovery in this
+     * process is used (see IfaceAffinity).
+     * @throws std::invalid_argument if func_id is not a known reset function
+     */
+    void add(uint64_t hardware_addr, uint8_t func_id,
+             const std::string &iface_name = std::string());
+
+    /**
+     * @brief Adds an rc_visard to the batch.
+     * @param hardware_addr MAC-address of rc_visard
+     * @param func_id reset function (0xAA: parameters, 0xBB: GigE, 0xCC:
+     * switch partition, 0xFF: all)
+     * @param iface_name interface on which the rc_visard lives. If empty, the
+     * interface on which it answered the most recent discovery in this
+     * process is used (see IfaceAffinity).
+     * @throws std::invalid_argument if func_id is not a known reset function
+     */
+    void add(const std::array<uint8_t, 6> &hardware_addr, uint8_t func_id,
+             const std::string &iface_name = std::string());
+
+    /**
+     * @brief Returns the number of rc_visards in the batch.
+     * @return number of rc_visards
+     */
+    size_t size() const { return packets_.size()/PACKET_SIZE; }
+
+    /**
+     * @brief Removes all rc_visards from the batch.
+     */
+    void clear() { packets_.clear(); ifaces_.clear(); }
+
+    /**
+     * @brief Sets the maximum number of packets that are sent per interface
+     * before pausing. The default is 64.
+     * @param batch_size number of packets (at least 1)
+     */
+    void setBatchSize(size_t batch_size);
+
+    /**
+     * @brief Sets the pause between two batches. The default is no pause.
+     * @param pacing pause between batches
+     */
+    void setPacing(std::chrono::microseconds pacing);
+
+    /**
+     * @brief Sends the Magic Packets of all rc_visards on all interfaces.
+     *
+     * Sending stops on an interface if its network is unreachable or its
+     * socket buffer does not drain within 100 ms. The remaining packets of
+     * this interface are counted as failed.
+     * @param progress optional callback that is called after each batch
+     * @return number of packets that could not be sent
+     * @throws SocketException on other errors
+     */
+    size_t send(const ProgressCallback &progress = ProgressCallback()) const;
+
+    /**
+     * @brief Checks if a function id denotes a known reset function.
+     * @param func_id function id
+     * @return true if the function id is known
+     */
+    static bool isResetFunction(uint8_t func_id);
+
+  private:
+    uint16_t port_;
+    size_t batch_size_;
+    std::chrono::microseconds pacing_;
+    std::vector<uint8_t> packets_;
+    std::vector<std::string> ifaces_;
+};
+
+}
+
+#endif // RCDISCOVER_WOL_BATCH_H
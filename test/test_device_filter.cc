@@ -0,0 +1,178 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "test_utils.h"
+
+#include "rcdiscover/device_filter.h"
+#include "rcdiscover/discover.h"
+
+#include <stdexcept>
+
+namespace
+{
+
+/*
+  The filter must give the same result on the raw acknowledge, i.e. at the
+  offsets that are used before decoding, as on the decoded device.
+*/
+
+bool matchesBoth(const rcdiscover::DeviceFilter &filter,
+                 const rcdiscover::DeviceInfo &info)
+{
+  const std::vector<uint8_t> ack = test::makeAck(info);
+
+  rcdiscover::DeviceInfo decoded("eth0");
+  CHECK(rcdiscover::Discover::decodeResponse(ack.data(), ack.size(), decoded));
+  CHECK(test::equalDevices(decoded, info));
+
+  const bool raw = filter.matches(ack.data()+8, ack.size()-8);
+  CHECK(raw == filter.matches(info));
+
+  return raw;
+}
+
+void testEmpty()
+{
+  rcdiscover::DeviceFilter filter;
+
+  CHECK(filter.empty());
+  CHECK(matchesBoth(filter, test::makeDevice(1)));
+}
+
+void testSerial()
+{
+  rcdiscover::DeviceFilter filter;
+  filter.addSerialNumber("02900001");
+  filter.addSerialNumber("02900003");
+
+  CHECK(!filter.empty());
+  CHECK(matchesBoth(filter, test::makeDevice(1)));
+  CHECK(!matchesBoth(filter, test::makeDevice(2)));
+  CHECK(matchesBoth(filter, test::makeDevice(3)));
+
+  // serial numbers must match completely, not only as prefix
+
+  rcdiscover::DeviceInfo info = test::makeDevice(1);
+  info.setSerialNumber("029000011");
+  CHECK(!matchesBoth(filter, info));
+}
+
+void testMACPrefix()
+{
+  rcdiscover::DeviceFilter filter;
+  filter.addMACPrefix("00:14:2d:2c:6e:0");
+
+  CHECK(matchesBoth(filter, test::makeDevice(0)));
+  CHECK(!matchesBoth(filter, test::makeDevice(1)));
+
+  rcdiscover::DeviceFilter vendor;
+  vendor.addMACPrefix("00:14:2d");
+
+  CHECK(matchesBoth(vendor, test::makeDevice(5)));
+
+  rcdiscover::DeviceInfo info = test::makeDevice(5);
+  info.setMAC(0x00142e000001ULL);
+  CHECK(!matchesBoth(vendor, info));
+
+  rcdiscover::DeviceFilter invalid;
+  CHECK_THROWS(invalid.addMACPrefix("00:14:"), std::invalid_argument);
+  CHECK_THROWS(invalid.addMACPrefix("00:14:2d:2c:6e:00:01"),
+               std::invalid_argument);
+  CHECK_THROWS(invalid.addMACPrefix("0g"), std::invalid_argument);
+}
+
+void testNames()
+{
+  rcdiscover::DeviceFilter filter;
+  filter.addModelName("rc_visard");
+  filter.addUserName("cam2");
+
+  CHECK(matchesBoth(filter, test::makeDevice(2)));
+  CHECK(!matchesBoth(filter, test::makeDevice(1)));
+
+  rcdiscover::DeviceInfo info = test::makeDevice(2);
+  info.setModelName("rc_cube");
+  CHECK(!matchesBoth(filter, info));
+
+  // a user name of the full field length is not zero terminated
+
+  rcdiscover::DeviceFilter full;
+  full.addUserName("0123456789abcdef");
+
+  info = test::makeDevice(2);
+  info.setUserName("0123456789abcdef");
+  CHECK(matchesBoth(full, info));
+}
+
+void testSubnet()
+{
+  rcdiscover::DeviceFilter filter;
+  filter.addSubnet("10.0.2.40/30");
+
+  CHECK(matchesBoth(filter, test::makeDevice(0)));
+  CHECK(matchesBoth(filter, test::makeDevice(3)));
+  CHECK(!matchesBoth(filter, test::makeDevice(4)));
+
+  rcdiscover::DeviceFilter invalid;
+  CHECK_THROWS(invalid.addSubnet("10.0.2.0/33"), std::invalid_argument);
+}
+
+void testShortAck()
+{
+  // criteria beyond the end of a truncated acknowledge do not match, names
+  // are compared including the terminating null byte
+
+  rcdiscover::DeviceFilter filter;
+  filter.addUserName("cam1");
+
+  const std::vector<uint8_t> ack = test::makeAck(test::makeDevice(1));
+  CHECK(filter.matches(ack.data()+8, 248));
+  CHECK(filter.matches(ack.data()+8, 237));
+  CHECK(!filter.matches(ack.data()+8, 236));
+}
+
+}
+
+int main()
+{
+  testEmpty();
+  testSerial();
+  testMACPrefix();
+  testNames();
+  testSubnet();
+  testShortAck();
+
+  return 0;
+}
@@ -0,0 +1,316 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "test_utils.h"
+
+#include "tools/rcdiscover-gui/device-list-model.h"
+#include "tools/rcdiscover-gui/device-queue.h"
+
+#include <wx/init.h>
+
+#include <random>
+
+namespace
+{
+
+/*
+  Keeps a copy of the table like the control does, i.e. only from the
+  notifications of the model.
+*/
+
+class Mirror : public wxDataViewModelNotifier
+{
+  public:
+    explicit Mirror(const DeviceListModel &model) : model_(model) { }
+
+    virtual bool ItemAdded(const wxDataViewItem &,
+                           const wxDataViewItem &item) override
+    {
+      const unsigned int row = model_.GetRow(item);
+      rows_.insert(rows_.begin()+row, render(model_, row));
+      return true;
+    }
+
+    virtual bool ItemDeleted(const wxDataViewItem &,
+                             const wxDataViewItem &item) override
+    {
+      rows_.erase(rows_.begin()+model_.GetRow(item));
+      return true;
+    }
+
+    virtual bool ItemsDeleted(const wxDataViewItem &,
+                              const wxDataViewItemArray &items) override
+    {
+      // rows must be removed from the back, whatever the order of items
+
+      std::vector<unsigned int> rows;
+      for (size_t i = 0; i < items.size(); i++)
+      {
+        rows.push_back(model_.GetRow(items[i]));
+      }
+
+      std::sort(rows.rbegin(), rows.rend());
+
+      for (const auto row : rows)
+      {
+        rows_.erase(rows_.begin()+row);
+      }
+
+      return true;
+    }
+
+    virtual bool ItemChanged(const wxDataViewItem &item) override
+    {
+      const unsigned int row = model_.GetRow(item);
+      rows_[row] = render(model_, row);
+      return true;
+    }
+
+    virtual bool ValueChanged(const wxDataViewItem &item,
+                              unsigned int) override
+    {
+      return ItemChanged(item);
+    }
+
+    virtual bool Cleared() override
+    {
+      rows_.clear();
+      for (unsigned int row = 0; row < model_.GetCount(); row++)
+      {
+        rows_.push_back(render(model_, row));
+      }
+
+      return true;
+    }
+
+    virtual void Resort() override { }
+
+    const std::vector<std::string> &getRows() const { return rows_; }
+
+    static std::string render(const DeviceListModel &model, unsigned int row)
+    {
+      std::string ret;
+      for (unsigned int col = 0; col < DeviceListModel::COLUMN_COUNT; col++)
+      {
+        ret += model.getText(row, col).ToStdString();
+        ret += '|';
+      }
+
+      return ret;
+    }
+
+  private:
+    const DeviceListModel &model_;
+    std::vector<std::string> rows_;
+};
+
+DeviceUpdate makeUpdate(int i, std::mt19937 &rnd)
+{
+  DeviceUpdate update;
+  update.info = test::makeDevice(i);
+
+  // few different names and serial numbers for having equal sort keys
+
+  update.info.setUserName((rnd()%8 == 0) ? "" :
+                          "cam" + std::to_string(rnd()%500));
+  update.info.setSerialNumber("0290" + std::to_string(rnd()%1000));
+  update.info.setIP(0x0a000000 + static_cast<uint32_t>(rnd()%0x10000));
+
+  return update;
+}
+
+DeviceUpdate makeReachability(int i, std::mt19937 &rnd)
+{
+  DeviceUpdate update;
+  update.info.setMAC(test::makeDevice(i).getMAC());
+  update.reachable = static_cast<int>(rnd()%3)-1;
+  update.rtt_us = static_cast<int>(rnd()%5000)-1;
+  update.loss = static_cast<int>(rnd()%101)-1;
+  update.reachability_only = true;
+
+  return update;
+}
+
+/*
+  Checks that the rows that are known from the notifications are equal to
+  the current rows, and that incremental updates lead to the same order as
+  sorting all rows again.
+*/
+
+void checkRows(DeviceListModel &model, const Mirror &mirror,
+               unsigned int col, bool ascending)
+{
+  const std::vector<std::string> &rows = mirror.getRows();
+
+  CHECK(rows.size() == model.GetCount());
+
+  bool equal = true;
+  for (unsigned int row = 0; row < rows.size(); row++)
+  {
+    equal = equal && (rows[row] == Mirror::render(model, row));
+  }
+
+  CHECK(equal);
+
+  const std::vector<std::string> incremental = rows;
+  model.setSortOrder(col, ascending);
+  CHECK(mirror.getRows() == incremental);
+}
+
+void testLargeFleet()
+{
+  const int n = 20000;
+
+  std::mt19937 rnd(42);
+
+  DeviceListModel *model = new DeviceListModel();
+  Mirror *mirror = new Mirror(*model);
+  model->AddNotifier(mirror);
+
+  // discover all devices in random order
+
+  std::vector<int> order(n);
+  for (int i = 0; i < n; i++)
+  {
+    order[i] = i;
+  }
+
+  std::shuffle(order.begin(), order.end(), rnd);
+
+  for (const int i : order)
+  {
+    model->update(makeUpdate(i, rnd));
+  }
+
+  CHECK(model->getDeviceCount() == static_cast<size_t>(n));
+  checkRows(*model, *mirror, DeviceListModel::MAC, true);
+
+  bool sorted = true;
+  for (unsigned int row = 1; row < model->GetCount(); row++)
+  {
+    sorted = sorted && (model->getMAC(row-1) < model->getMAC(row));
+  }
+
+  CHECK(sorted);
+
+  // updates and reachability changes with every sort order
+
+  for (unsigned int col = 0; col < DeviceListModel::COLUMN_COUNT; col++)
+  {
+    for (int k = 0; k < 2; k++)
+    {
+      const bool ascending = (k == 0);
+      model->setSortOrder(col, ascending);
+
+      for (int j = 0; j < 2000; j++)
+      {
+        const int i = static_cast<int>(rnd()%n);
+        if (rnd()%2 == 0)
+        {
+          model->update(makeUpdate(i, rnd));
+        }
+        else
+        {
+          model->update(makeReachability(i, rnd));
+        }
+      }
+
+      checkRows(*model, *mirror, col, ascending);
+
+      if (col == DeviceListModel::NAME && ascending)
+      {
+        sorted = true;
+        for (unsigned int row = 1; row < model->GetCount(); row++)
+        {
+          sorted = sorted && (model->getText(row-1, col).ToStdString() <=
+                              model->getText(row, col).ToStdString());
+        }
+
+        CHECK(sorted);
+      }
+    }
+  }
+
+  // updates while a filter is set
+
+  model->setSortOrder(DeviceListModel::RTT, false);
+  model->setFilter("CAM1");
+  CHECK(model->GetCount() > 0);
+  CHECK(model->GetCount() < static_cast<unsigned int>(n));
+
+  for (int j = 0; j < 2000; j++)
+  {
+    model->update(makeUpdate(static_cast<int>(rnd()%n), rnd));
+  }
+
+  checkRows(*model, *mirror, DeviceListModel::RTT, false);
+
+  // removal of devices that have not been seen in the last round
+
+  model->setFilter("");
+  model->markUnseen();
+
+  size_t seen = 0;
+  for (int i = 0; i < n; i++)
+  {
+    if (rnd()%2 == 0)
+    {
+      model->update(makeUpdate(i, rnd));
+      seen++;
+    }
+    else
+    {
+      model->update(makeReachability(i, rnd));
+    }
+  }
+
+  model->removeUnseen();
+  CHECK(model->getDeviceCount() == seen);
+  checkRows(*model, *mirror, DeviceListModel::RTT, false);
+
+  model->DecRef();
+}
+
+}
+
+int main()
+{
+  wxInitializer initializer;
+  CHECK(initializer.IsOk());
+
+  testLargeFleet();
+
+  return 0;
+}
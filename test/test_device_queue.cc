@@ -0,0 +1,152 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "test_utils.h"
+
+#include "tools/rcdiscover-gui/device-queue.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+
+DeviceUpdate makeUpdate(uint64_t mac)
+{
+  DeviceUpdate update;
+  update.info.setMAC(mac);
+  return update;
+}
+
+void testNotification()
+{
+  DeviceQueue queue;
+  DeviceUpdate update;
+
+  CHECK(!queue.pop(update));
+
+  // the consumer is notified once until it acknowledges
+
+  CHECK(queue.push(makeUpdate(1)));
+  CHECK(!queue.push(makeUpdate(2)));
+
+  queue.acknowledge();
+  CHECK(queue.pop(update));
+  CHECK(update.info.getMAC() == 1);
+
+  CHECK(queue.push(makeUpdate(3)));
+
+  CHECK(queue.pop(update));
+  CHECK(update.info.getMAC() == 2);
+  CHECK(queue.pop(update));
+  CHECK(update.info.getMAC() == 3);
+  CHECK(!queue.pop(update));
+
+  // updates that are left in the queue are freed by the destructor
+
+  queue.acknowledge();
+  CHECK(queue.push(makeUpdate(4)));
+}
+
+void testConcurrent()
+{
+  // the consumer works like the GUI thread, which only drains the queue on
+  // notification, so that a lost notification leaves updates behind
+
+  const uint64_t n = 200000;
+
+  DeviceQueue queue;
+  std::mutex mtx;
+  std::condition_variable cv;
+  int events = 0;
+
+  std::thread producer([&]
+  {
+    for (uint64_t i = 1; i <= n; i++)
+    {
+      if (queue.push(makeUpdate(i)))
+      {
+        std::lock_guard<std::mutex> lock(mtx);
+        events++;
+        cv.notify_one();
+      }
+    }
+  });
+
+  uint64_t received = 0;
+  int handled = 0;
+  bool in_order = true;
+  while (received < n)
+  {
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      if (!cv.wait_for(lock, std::chrono::seconds(10),
+                       [&] { return events > 0; }))
+      {
+        break;
+      }
+
+      events--;
+    }
+
+    handled++;
+    queue.acknowledge();
+
+    DeviceUpdate update;
+    while (queue.pop(update))
+    {
+      in_order = in_order && (update.info.getMAC() == received+1);
+      received++;
+    }
+  }
+
+  producer.join();
+
+  CHECK(received == n);
+  CHECK(in_order);
+  CHECK(handled <= static_cast<int>(n));
+}
+
+}
+
+int main()
+{
+  testNotification();
+  testConcurrent();
+
+  return 0;
+}
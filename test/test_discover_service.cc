@@ -0,0 +1,225 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "test_utils.h"
+
+#include "rcdiscover/discover_service.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+
+/*
+  Discovery round that returns one device per round and blocks until it is
+  released.
+*/
+
+class BlockingScan
+{
+  public:
+    BlockingScan() : calls_(0), released_(true), fail_(false) { }
+
+    std::vector<rcdiscover::DeviceInfo> operator()()
+    {
+      std::unique_lock<std::mutex> lock(mtx_);
+      const int n = ++calls_;
+      cv_.notify_all();
+      cv_.wait(lock, [this] { return released_; });
+
+      if (fail_)
+      {
+        throw std::runtime_error("scan failed");
+      }
+
+      return std::vector<rcdiscover::DeviceInfo>(1, test::makeDevice(n));
+    }
+
+    void block()
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      released_ = false;
+    }
+
+    void release()
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      released_ = true;
+      cv_.notify_all();
+    }
+
+    void setFail(bool fail)
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      fail_ = fail;
+    }
+
+    void waitForCalls(int n)
+    {
+      std::unique_lock<std::mutex> lock(mtx_);
+      cv_.wait(lock, [this, n] { return calls_ >= n; });
+    }
+
+    int getCalls()
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      return calls_;
+    }
+
+  private:
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    int calls_;
+    bool released_;
+    bool fail_;
+};
+
+void testCoalescing()
+{
+  BlockingScan scan;
+  rcdiscover::DiscoverService service([&scan] { return scan(); });
+
+  scan.block();
+
+  const size_t n = 8;
+  std::vector<std::vector<rcdiscover::DeviceInfo>> results(n);
+  std::vector<std::thread> threads;
+
+  threads.emplace_back([&service, &results]
+                       { results[0] = service.discover(); });
+  scan.waitForCalls(1);
+
+  // all other callers join the round in progress
+
+  for (size_t i = 1; i < n; ++i)
+  {
+    threads.emplace_back([&service, &results, i]
+                         { results[i] = service.discover(); });
+  }
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  scan.release();
+
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+
+  CHECK(scan.getCalls() == 1);
+  CHECK(service.getRounds() == 1);
+
+  for (const auto &result : results)
+  {
+    CHECK(result.size() == 1);
+    CHECK(result[0].getMAC() == test::makeDevice(1).getMAC());
+  }
+}
+
+void testMaxAge()
+{
+  BlockingScan scan;
+  rcdiscover::DiscoverService service([&scan] { return scan(); });
+
+  CHECK(service.discover()[0].getMAC() == test::makeDevice(1).getMAC());
+
+  // fresh enough results are returned without new round
+
+  const std::chrono::milliseconds minute(60000);
+  CHECK(service.discover(minute)[0].getMAC() == test::makeDevice(1).getMAC());
+  CHECK(scan.getCalls() == 1);
+
+  CHECK(service.discover()[0].getMAC() == test::makeDevice(2).getMAC());
+  CHECK(scan.getCalls() == 2);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+  CHECK(service.discover(std::chrono::milliseconds(10))[0].getMAC() ==
+        test::makeDevice(3).getMAC());
+  CHECK(service.getRounds() == 3);
+}
+
+void testError()
+{
+  BlockingScan scan;
+  rcdiscover::DiscoverService service([&scan] { return scan(); });
+
+  service.discover();
+
+  // the error is passed to all callers of the round
+
+  scan.setFail(true);
+  scan.block();
+
+  std::thread thread([&service]
+  {
+    CHECK_THROWS(service.discover(), std::runtime_error);
+  });
+
+  scan.waitForCalls(2);
+
+  std::thread joining([&service]
+  {
+    CHECK_THROWS(service.discover(), std::runtime_error);
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  scan.release();
+
+  thread.join();
+  joining.join();
+
+  CHECK(scan.getCalls() == 2);
+
+  // the result of the last successful round is still available
+
+  const std::chrono::milliseconds minute(60000);
+  CHECK(service.discover(minute)[0].getMAC() == test::makeDevice(1).getMAC());
+  CHECK(scan.getCalls() == 2);
+}
+
+}
+
+int main()
+{
+  testCoalescing();
+  testMaxAge();
+  testError();
+
+  return 0;
+}
@@ -0,0 +1,226 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "test_utils.h"
+
+#include "rcdiscover/fleet.h"
+
+#ifndef WIN32
+#include "rcdiscover/daemon_protocol.h"
+#endif
+
+namespace
+{
+
+std::vector<rcdiscover::DeviceInfo> round(std::initializer_list<int> ids)
+{
+  std::vector<rcdiscover::DeviceInfo> ret;
+  for (const int i : ids)
+  {
+    ret.push_back(test::makeDevice(i));
+  }
+
+  return ret;
+}
+
+void testEvents()
+{
+  rcdiscover::Fleet fleet(2);
+
+  std::vector<rcdiscover::FleetEvent> received;
+  const int id = fleet.subscribe([&received](const rcdiscover::FleetEvent &ev)
+  {
+    received.push_back(ev);
+  });
+
+  CHECK(fleet.getLastSequence() == 0);
+
+  fleet.update(round({0, 1, 1}));
+
+  CHECK(fleet.size() == 2);
+  CHECK(received.size() == 2);
+  CHECK(received[0].seq == 1 && received[1].seq == 2);
+  CHECK(received[0].type == rcdiscover::FleetEvent::APPEARED);
+  CHECK(received[0].epoch == fleet.getEpoch());
+
+  // changed IP address
+
+  auto r = round({0, 1});
+  r[1].setIP(r[1].getIP()+100);
+  fleet.update(r);
+
+  CHECK(received.size() == 3);
+  CHECK(received[2].type == rcdiscover::FleetEvent::CHANGED);
+  CHECK(received[2].changed == rcdiscover::FleetEvent::IP);
+  CHECK(received[2].info.getIP() == r[1].getIP());
+
+  // device 0 is removed after two rounds without answer
+
+  const std::vector<rcdiscover::DeviceInfo> only1(1, r[1]);
+
+  fleet.update(only1);
+  CHECK(received.size() == 3);
+  CHECK(fleet.size() == 2);
+
+  fleet.update(only1);
+  CHECK(received.size() == 4);
+  CHECK(received[3].type == rcdiscover::FleetEvent::DISAPPEARED);
+  CHECK(received[3].info.getMAC() == test::makeDevice(0).getMAC());
+  CHECK(fleet.size() == 1);
+
+  fleet.unsubscribe(id);
+  fleet.update(round({2}));
+  CHECK(received.size() == 4);
+  CHECK(fleet.getLastSequence() == 5);
+  CHECK(fleet.getRounds() == 5);
+}
+
+void testLookup()
+{
+  rcdiscover::Fleet fleet;
+  fleet.update(round({3, 1, 2}));
+
+  const auto devices = fleet.getDevices();
+  CHECK(devices.size() == 3);
+  CHECK(devices[0].getMAC() < devices[1].getMAC() &&
+        devices[1].getMAC() < devices[2].getMAC());
+
+  rcdiscover::DeviceInfo info;
+  CHECK(fleet.findByMAC(test::makeDevice(2).getMAC(), info));
+  CHECK(test::equalDevices(info, test::makeDevice(2)));
+  CHECK(!fleet.findByMAC(test::makeDevice(4).getMAC(), info));
+
+  CHECK(fleet.findBySerial("02900003", info));
+  CHECK(info.getMAC() == test::makeDevice(3).getMAC());
+  CHECK(!fleet.findBySerial("02900004", info));
+
+  CHECK(fleet.findByName("cam1").size() == 1);
+  CHECK(fleet.findByName("cam4").empty());
+
+  // renaming a device updates the index
+
+  auto r = round({1, 2, 3});
+  r[0].setUserName("");
+  fleet.update(r);
+
+  CHECK(fleet.findByName("cam1").empty());
+  CHECK(fleet.findByName("rc_visard").size() == 1);
+}
+
+void testResume()
+{
+  rcdiscover::Fleet fleet(1, 4);
+  std::vector<rcdiscover::FleetEvent> events;
+
+  fleet.update(round({0, 1}));
+
+  CHECK(fleet.getEventsSince(0, events));
+  CHECK(events.size() == 2 && events[0].seq == 1 && events[1].seq == 2);
+
+  CHECK(fleet.getEventsSince(1, events));
+  CHECK(events.size() == 1 && events[0].seq == 2);
+
+  // nothing new is not an error
+
+  CHECK(fleet.getEventsSince(2, events));
+  CHECK(events.empty());
+
+  // sequence numbers from the future stem from another epoch
+
+  CHECK(!fleet.getEventsSince(3, events));
+  CHECK(events.empty());
+
+  // the history keeps the last 4 events, i.e. 3 to 6
+
+  fleet.update(round({2, 3}));
+  fleet.update(round({2, 3}));
+
+  CHECK(fleet.getLastSequence() == 6);
+
+  CHECK(fleet.getEventsSince(2, events));
+  CHECK(events.size() == 4 && events[0].seq == 3 && events[3].seq == 6);
+  CHECK(events[2].type == rcdiscover::FleetEvent::DISAPPEARED);
+
+  CHECK(!fleet.getEventsSince(1, events));
+  CHECK(!fleet.getEventsSince(0, events));
+
+  CHECK(fleet.getEventsSince(5, events));
+  CHECK(events.size() == 1 && events[0].seq == 6);
+}
+
+#ifndef WIN32
+
+void testEventRecord()
+{
+  rcdiscover::FleetEvent ev;
+  ev.seq = 42;
+  ev.epoch = 1760781234567ULL;
+  ev.type = rcdiscover::FleetEvent::CHANGED;
+  ev.changed = rcdiscover::FleetEvent::IP | rcdiscover::FleetEvent::USER_NAME;
+  ev.info = test::makeDevice(1);
+  ev.info.setUserName("tab\tname");
+
+  const std::string line = rcdiscover::formatEventRecord(ev);
+  CHECK(line.find('\n') == std::string::npos);
+
+  rcdiscover::FleetEvent parsed;
+  CHECK(rcdiscover::parseEventRecord(line, parsed));
+  CHECK(parsed.seq == ev.seq);
+  CHECK(parsed.epoch == ev.epoch);
+  CHECK(parsed.type == ev.type);
+  CHECK(parsed.changed == ev.changed);
+  CHECK(test::equalDevices(parsed.info, ev.info));
+
+  CHECK(!rcdiscover::parseEventRecord("42\tchanged\tip\t" +
+                                      rcdiscover::formatDeviceRecord(ev.info),
+                                      parsed));
+}
+
+#endif
+
+}
+
+int main()
+{
+  testEvents();
+  testLookup();
+  testResume();
+
+#ifndef WIN32
+  testEventRecord();
+#endif
+
+  return 0;
+}
@@ -0,0 +1,91 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "test_utils.h"
+
+#include "rcdiscover/iface_affinity.h"
+
+namespace
+{
+
+std::string lookup(int i)
+{
+  return rcdiscover::IfaceAffinity::lookup(test::makeDevice(i).getMAC());
+}
+
+void testRound()
+{
+  rcdiscover::IfaceAffinity::clear();
+
+  std::vector<rcdiscover::DeviceInfo> round;
+  round.push_back(test::makeDevice(0, "eth0"));
+  round.push_back(test::makeDevice(1, "eth1"));
+  round.push_back(test::makeDevice(2, ""));
+  round.push_back(rcdiscover::DeviceInfo("eth0"));
+
+  rcdiscover::IfaceAffinity::update(round);
+
+  CHECK(lookup(0) == "eth0");
+  CHECK(lookup(1) == "eth1");
+
+  // invalid devices and devices without interface are not recorded
+
+  CHECK(lookup(2).empty());
+  CHECK(rcdiscover::IfaceAffinity::lookup(0).empty());
+
+  // the most recent round wins, devices that did not answer are kept
+
+  round.clear();
+  round.push_back(test::makeDevice(1, "eth2"));
+  rcdiscover::IfaceAffinity::update(round);
+
+  CHECK(lookup(0) == "eth0");
+  CHECK(lookup(1) == "eth2");
+
+  rcdiscover::IfaceAffinity::update(test::makeDevice(1).getMAC(), "");
+  CHECK(lookup(1) == "eth2");
+
+  rcdiscover::IfaceAffinity::clear();
+  CHECK(lookup(0).empty());
+}
+
+}
+
+int main()
+{
+  testRound();
+
+  return 0;
+}
@@ -0,0 +1,134 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "test_utils.h"
+
+#include "rcdiscover/iface_selection.h"
+
+#include <stdexcept>
+
+namespace
+{
+
+const uint32_t IP_ETH0 = 0xc0000202;  // 192.0.2.2
+const uint32_t IP_ENP = 0x0a000201;   // 10.0.2.1
+
+void testEmpty()
+{
+  rcdiscover::InterfaceSelection s;
+
+  CHECK(s.empty());
+  CHECK(s.matches("eth0", IP_ETH0));
+  CHECK(s.matches("", 0));
+}
+
+void testGlob()
+{
+  rcdiscover::InterfaceSelection s;
+  s.include("eth*");
+  s.include("enp?s0");
+
+  CHECK(!s.empty());
+  CHECK(s.matches("eth0", IP_ETH0));
+  CHECK(s.matches("eth", IP_ETH0));
+  CHECK(s.matches("enp3s0", IP_ENP));
+  CHECK(!s.matches("enp10s0", IP_ENP));
+  CHECK(!s.matches("lo", 0x7f000001));
+
+  rcdiscover::InterfaceSelection t;
+  t.include("*0*1");
+
+  CHECK(t.matches("a0b1", 0));
+  CHECK(t.matches("0011", 0));
+  CHECK(!t.matches("a0b1c", 0));
+}
+
+void testSubnet()
+{
+  rcdiscover::InterfaceSelection s;
+  s.include("10.0.0.0/8");
+
+  CHECK(s.matches("enp3s0", IP_ENP));
+  CHECK(!s.matches("eth0", IP_ETH0));
+
+  // a single address is a subnet of one address, not a glob
+
+  rcdiscover::InterfaceSelection t;
+  t.include("192.0.2.2");
+
+  CHECK(t.matches("eth0", IP_ETH0));
+  CHECK(!t.matches("eth0", IP_ETH0+1));
+  CHECK(!t.matches("192.0.2.2", 0));
+
+  rcdiscover::InterfaceSelection invalid;
+  CHECK_THROWS(invalid.include("10.0.0.0/40"), std::invalid_argument);
+  CHECK_THROWS(invalid.exclude("eth0/24"), std::invalid_argument);
+}
+
+void testExclude()
+{
+  // without includes, everything except the excluded interfaces matches
+
+  rcdiscover::InterfaceSelection s;
+  s.exclude("docker*");
+  s.exclude("10.0.2.0/24");
+
+  CHECK(!s.empty());
+  CHECK(s.matches("eth0", IP_ETH0));
+  CHECK(!s.matches("docker0", IP_ETH0));
+  CHECK(!s.matches("enp3s0", IP_ENP));
+
+  // excludes take precedence over includes
+
+  rcdiscover::InterfaceSelection t;
+  t.include("e*");
+  t.exclude("eth1");
+
+  CHECK(t.matches("eth0", IP_ETH0));
+  CHECK(!t.matches("eth1", IP_ETH0));
+  CHECK(!t.matches("wlan0", IP_ETH0));
+}
+
+}
+
+int main()
+{
+  testEmpty();
+  testGlob();
+  testSubnet();
+  testExclude();
+
+  return 0;
+}
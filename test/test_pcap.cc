@@ -0,0 +1,135 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "test_utils.h"
+
+#include "rcdiscover/pcap.h"
+#include "rcdiscover/discover.h"
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+namespace
+{
+
+const std::string FILENAME = "test_pcap.pcap";
+
+void testRoundTrip()
+{
+  std::remove(FILENAME.c_str());
+
+  const uint8_t request[] = { 0x42, 0x11, 0x00, 0x02, 0x00, 0x00, 0x00, 0x01 };
+  const std::vector<uint8_t> ack = test::makeAck(test::makeDevice(1));
+
+  rcdiscover::PcapPacket packet;
+  packet.ts_sec = 1760781234;
+  packet.ts_usec = 567000;
+  packet.src_ip = 0x0a000229;
+  packet.src_port = 3956;
+  packet.dst_ip = 0xc0000202;
+  packet.dst_port = 51234;
+  packet.payload = ack;
+
+  {
+    rcdiscover::PcapWriter writer(FILENAME);
+    writer.write(0xc0000202, 51234, 0xffffffff, 3956, request,
+                 sizeof(request));
+    writer.write(packet);
+  }
+
+  rcdiscover::PcapReader reader(FILENAME);
+  rcdiscover::PcapPacket p;
+
+  CHECK(reader.next(p));
+  CHECK(p.src_ip == 0xc0000202 && p.src_port == 51234);
+  CHECK(p.dst_ip == 0xffffffff && p.dst_port == 3956);
+  CHECK(p.payload == std::vector<uint8_t>(request, request+sizeof(request)));
+  CHECK(p.ts_sec > 0);
+
+  CHECK(reader.next(p));
+  CHECK(p.ts_sec == packet.ts_sec && p.ts_usec == packet.ts_usec);
+  CHECK(p.src_ip == packet.src_ip && p.src_port == packet.src_port);
+  CHECK(p.dst_ip == packet.dst_ip && p.dst_port == packet.dst_port);
+  CHECK(p.payload == ack);
+
+  // replayed acknowledges are decoded like live responses
+
+  rcdiscover::DeviceInfo info;
+  CHECK(rcdiscover::Discover::decodeResponse(p.payload.data(),
+                                             p.payload.size(), info));
+  CHECK(info.getMAC() == test::makeDevice(1).getMAC());
+  CHECK(info.getUserName() == "cam1");
+
+  CHECK(!reader.next(p));
+
+  std::remove(FILENAME.c_str());
+}
+
+void testInvalid()
+{
+  {
+    std::ofstream out(FILENAME, std::ios::binary);
+    out << "this is not a pcap file, but long enough for a header";
+  }
+
+  CHECK_THROWS(rcdiscover::PcapReader reader(FILENAME), std::runtime_error);
+  CHECK_THROWS(rcdiscover::PcapReader reader("does-not-exist.pcap"),
+               std::runtime_error);
+
+  rcdiscover::PcapPacket packet;
+  packet.ts_sec = 0;
+  packet.ts_usec = 0;
+  packet.src_ip = packet.dst_ip = 0;
+  packet.src_port = packet.dst_port = 0;
+  packet.payload.resize(70000);
+
+  {
+    rcdiscover::PcapWriter writer(FILENAME);
+    CHECK_THROWS(writer.write(packet), std::invalid_argument);
+  }
+
+  std::remove(FILENAME.c_str());
+}
+
+}
+
+int main()
+{
+  testRoundTrip();
+  testInvalid();
+
+  return 0;
+}
@@ -0,0 +1,186 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "test_utils.h"
+
+#include "rcdiscover/presence_log.h"
+#include "rcdiscover/fleet.h"
+
+#include <chrono>
+#include <cstdio>
+
+namespace
+{
+
+const std::string FILENAME = "test_presence_log.bin";
+
+void removeLog()
+{
+  std::remove(FILENAME.c_str());
+  std::remove((FILENAME + ".idx").c_str());
+}
+
+rcdiscover::FleetEvent makeEvent(rcdiscover::FleetEvent::Type type, int i,
+                                 unsigned int changed=0)
+{
+  rcdiscover::FleetEvent ev;
+  ev.seq = 0;
+  ev.epoch = 0;
+  ev.type = type;
+  ev.changed = changed;
+  ev.info = test::makeDevice(i);
+
+  return ev;
+}
+
+void testRoundTrip()
+{
+  removeLog();
+
+  // the writer keeps the log sorted by time and starts with the current
+  // time, i.e. events must not be older
+
+  const uint64_t t0 = static_cast<uint64_t>(
+    std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count()) + 60000;
+
+  const uint64_t mac1 = test::makeDevice(1).getMAC();
+  const uint64_t mac2 = test::makeDevice(2).getMAC();
+
+  {
+    rcdiscover::PresenceLogWriter writer(FILENAME);
+
+    writer.append(makeEvent(rcdiscover::FleetEvent::APPEARED, 1), t0);
+    writer.append(makeEvent(rcdiscover::FleetEvent::CHANGED, 1,
+                            rcdiscover::FleetEvent::IP), t0+100);
+    writer.append(makeEvent(rcdiscover::FleetEvent::APPEARED, 2), t0+500);
+    writer.append(makeEvent(rcdiscover::FleetEvent::DISAPPEARED, 1), t0+1000);
+    writer.writeIndex();
+
+    // records after the index are found by a linear search
+
+    writer.append(makeEvent(rcdiscover::FleetEvent::APPEARED, 1), t0+2000);
+  }
+
+  {
+    rcdiscover::PresenceLog log(FILENAME);
+
+    CHECK(log.size() == 6);
+    CHECK(log.hasIndex());
+    CHECK(log.getRecord(0).type == rcdiscover::PresenceRecord::START);
+    CHECK(log.getRecord(2).type == rcdiscover::PresenceRecord::CHANGED);
+    CHECK(log.getRecord(2).changed == rcdiscover::FleetEvent::IP);
+    CHECK(log.getRecord(2).ip == test::makeDevice(1).getIP());
+    CHECK(log.getRecord(3).mac == mac2);
+
+    const std::vector<size_t> expected = {0, 1, 2, 4, 5};
+    CHECK(log.findByMAC(mac1) == expected);
+
+    size_t first, last;
+    log.findByTime(t0+100, t0+1000, first, last);
+    CHECK(first == 2 && last == 4);
+
+    CHECK(log.getUptime(mac1, t0, t0+3000) == 2000);
+    CHECK(log.getUptime(mac1, t0+500, t0+2500) == 1000);
+    CHECK(log.getUptime(mac2, t0, t0+3000) == 2500);
+  }
+
+  // a restart of the writer ends the presence of all devices
+
+  {
+    rcdiscover::PresenceLogWriter writer(FILENAME);
+  }
+
+  {
+    rcdiscover::PresenceLog log(FILENAME);
+
+    CHECK(log.size() == 7);
+    CHECK(log.getRecord(6).type == rcdiscover::PresenceRecord::START);
+    CHECK(log.getRecord(6).time >= t0+2000);
+
+    const uint64_t end = log.getRecord(6).time;
+    CHECK(log.getUptime(mac1, t0, end+1000) == 1000 + (end-t0-2000));
+    CHECK(log.getUptime(mac2, t0, end+1000) == end-t0-500);
+  }
+
+  removeLog();
+}
+
+void testTruncatedRecord()
+{
+  removeLog();
+
+  {
+    rcdiscover::PresenceLogWriter writer(FILENAME);
+  }
+
+  // a partially written record, e.g. after a crash, is ignored and
+  // overwritten by the next writer
+
+  {
+    FILE *f = std::fopen(FILENAME.c_str(), "ab");
+    CHECK(f != nullptr);
+    std::fputs("partial", f);
+    std::fclose(f);
+  }
+
+  {
+    rcdiscover::PresenceLog log(FILENAME);
+    CHECK(log.size() == 1);
+    CHECK(!log.hasIndex());
+  }
+
+  {
+    rcdiscover::PresenceLogWriter writer(FILENAME);
+  }
+
+  {
+    rcdiscover::PresenceLog log(FILENAME);
+    CHECK(log.size() == 2);
+    CHECK(log.getRecord(1).type == rcdiscover::PresenceRecord::START);
+  }
+
+  removeLog();
+}
+
+}
+
+int main()
+{
+  testRoundTrip();
+  testTruncatedRecord();
+
+  return 0;
+}
@@ -0,0 +1,158 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "test_utils.h"
+
+#include "rcdiscover/snapshot.h"
+
+#include <cstdio>
+#include <stdexcept>
+
+namespace
+{
+
+void testRoundTrip()
+{
+  std::vector<rcdiscover::DeviceInfo> devices;
+  for (const int i : {3, 1, 2, 1})
+  {
+    devices.push_back(test::makeDevice(i));
+  }
+
+  devices.push_back(rcdiscover::DeviceInfo()); // invalid, is skipped
+
+  const std::vector<uint8_t> data =
+    rcdiscover::Snapshot::serialize(devices, 1234567);
+
+  rcdiscover::Snapshot s(data.data(), data.size());
+
+  CHECK(s.size() == 3);
+  CHECK(s.getTimestamp() == 1234567);
+
+  for (size_t i = 0; i < s.size(); ++i)
+  {
+    CHECK(test::equalDevices(s.getDevice(i),
+                             test::makeDevice(static_cast<int>(i)+1)));
+  }
+
+  size_t k;
+  CHECK(s.find(test::makeDevice(2).getMAC(), k) && k == 1);
+  CHECK(!s.find(test::makeDevice(4).getMAC(), k));
+}
+
+void testFile()
+{
+  const std::string filename = "test_snapshot.snap";
+
+  std::vector<rcdiscover::DeviceInfo> devices;
+  devices.push_back(test::makeDevice(1, "enp3s0"));
+
+  rcdiscover::Snapshot::write(filename, devices, 42);
+
+  {
+    rcdiscover::Snapshot s(filename);
+
+    CHECK(s.size() == 1);
+    CHECK(s.getTimestamp() == 42);
+    CHECK(test::equalDevices(s.getDevice(0), devices[0]));
+  }
+
+  std::remove(filename.c_str());
+}
+
+void testInvalid()
+{
+  std::vector<uint8_t> data =
+    rcdiscover::Snapshot::serialize(std::vector<rcdiscover::DeviceInfo>(1,
+                                    test::makeDevice(1)), 0);
+
+  CHECK_THROWS(rcdiscover::Snapshot(data.data(), 10), std::runtime_error);
+  CHECK_THROWS(rcdiscover::Snapshot(data.data(), data.size()-1),
+               std::runtime_error);
+
+  data[0] = 'X';
+  CHECK_THROWS(rcdiscover::Snapshot(data.data(), data.size()),
+               std::runtime_error);
+}
+
+void testDiff()
+{
+  std::vector<rcdiscover::DeviceInfo> a, b;
+  a.push_back(test::makeDevice(1));
+  a.push_back(test::makeDevice(2));
+  a.push_back(test::makeDevice(3));
+
+  b.push_back(test::makeDevice(2));
+  b.push_back(test::makeDevice(3));
+  b.push_back(test::makeDevice(4));
+  b[1].setIP(b[1].getIP()+100);
+  b[1].setUserName("renamed");
+
+  const std::vector<uint8_t> da = rcdiscover::Snapshot::serialize(a, 1);
+  const std::vector<uint8_t> db = rcdiscover::Snapshot::serialize(b, 2);
+
+  rcdiscover::Snapshot sa(da.data(), da.size());
+  rcdiscover::Snapshot sb(db.data(), db.size());
+
+  const auto changes = rcdiscover::diffSnapshots(sa, sb);
+
+  CHECK(changes.size() == 3);
+
+  CHECK(changes[0].type == rcdiscover::SnapshotChange::REMOVED);
+  CHECK(changes[0].mac == test::makeDevice(1).getMAC());
+
+  CHECK(changes[1].type == rcdiscover::SnapshotChange::CHANGED);
+  CHECK(changes[1].mac == test::makeDevice(3).getMAC());
+  CHECK(changes[1].fields == (rcdiscover::SnapshotChange::IP |
+                              rcdiscover::SnapshotChange::USER_NAME));
+  CHECK(changes[1].old_index == 2 && changes[1].new_index == 1);
+
+  CHECK(changes[2].type == rcdiscover::SnapshotChange::ADDED);
+  CHECK(changes[2].mac == test::makeDevice(4).getMAC());
+
+  CHECK(rcdiscover::diffSnapshots(sa, sa).empty());
+}
+
+}
+
+int main()
+{
+  testRoundTrip();
+  testFile();
+  testInvalid();
+  testDiff();
+
+  return 0;
+}
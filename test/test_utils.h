@@ -0,0 +1,181 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RCDISCOVER_TEST_UTILS_H
+#define RCDISCOVER_TEST_UTILS_H
+
+#include "rcdiscover/deviceinfo.h"
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+
+/*
+  Like assert(), but independent of NDEBUG, since tests are usually built
+  with the default release configuration.
+*/
+
+#define CHECK(cond) \
+  do \
+  { \
+    if (!(cond)) \
+    { \
+      std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " \
+                << #cond << std::endl; \
+      std::exit(1); \
+    } \
+  } while (false)
+
+/*
+  Expects that the statement throws an exception of the given type.
+*/
+
+#define CHECK_THROWS(statement, exception) \
+  do \
+  { \
+    bool thrown = false; \
+    try \
+    { \
+      statement; \
+    } \
+    catch(const exception &) \
+    { \
+      thrown = true; \
+    } \
+    CHECK(thrown && #statement); \
+  } while (false)
+
+namespace test
+{
+
+/*
+  Creates a device with all fields set to values that are derived from i.
+*/
+
+inline rcdiscover::DeviceInfo makeDevice(int i, const std::string &iface="eth0")
+{
+  rcdiscover::DeviceInfo info(iface);
+
+  info.setVersion(1, 2);
+  info.setMAC(0x00142d2c6e00ULL + static_cast<uint64_t>(i));
+  info.setIP(0x0a000228 + static_cast<uint32_t>(i));
+  info.setSubnetMask(0xffffff00);
+  info.setGateway(0x0a000201);
+  info.setManufacturerName("Roboception");
+  info.setModelName("rc_visard");
+  info.setDeviceVersion("1.2.3");
+  info.setManufacturerInfo("info " + std::to_string(i));
+  info.setSerialNumber("0290000" + std::to_string(i));
+  info.setUserName("cam" + std::to_string(i));
+
+  return info;
+}
+
+/*
+  Compares all fields of two devices.
+*/
+
+inline bool equalDevices(const rcdiscover::DeviceInfo &a,
+                         const rcdiscover::DeviceInfo &b)
+{
+  return a.getMAC() == b.getMAC() && a.getIP() == b.getIP() &&
+         a.getSubnetMask() == b.getSubnetMask() &&
+         a.getGateway() == b.getGateway() &&
+         a.getMajorVersion() == b.getMajorVersion() &&
+         a.getMinorVersion() == b.getMinorVersion() &&
+         a.getManufacturerName() == b.getManufacturerName() &&
+         a.getModelName() == b.getModelName() &&
+         a.getDeviceVersion() == b.getDeviceVersion() &&
+         a.getManufacturerInfo() == b.getManufacturerInfo() &&
+         a.getSerialNumber() == b.getSerialNumber() &&
+         a.getUserName() == b.getUserName() &&
+         a.getIfaceName() == b.getIfaceName();
+}
+
+/*
+  Encodes a device as GigE Vision discovery acknowledge (GVCP header and
+  248 bytes of payload), as sent by the device in answer to request id 1.
+*/
+
+inline std::vector<uint8_t> makeAck(const rcdiscover::DeviceInfo &info)
+{
+  std::vector<uint8_t> p(8+248, 0);
+
+  p[3] = 0x03;
+  p[5] = 248;
+  p[7] = 1;
+
+  uint8_t *body = p.data()+8;
+
+  body[1] = static_cast<uint8_t>(info.getMajorVersion());
+  body[3] = static_cast<uint8_t>(info.getMinorVersion());
+
+  for (int i = 0; i < 6; i++)
+  {
+    body[10+i] = static_cast<uint8_t>(info.getMAC() >> (8*(5-i)));
+  }
+
+  for (int i = 0; i < 4; i++)
+  {
+    body[36+i] = static_cast<uint8_t>(info.getIP() >> (8*(3-i)));
+    body[52+i] = static_cast<uint8_t>(info.getSubnetMask() >> (8*(3-i)));
+    body[68+i] = static_cast<uint8_t>(info.getGateway() >> (8*(3-i)));
+  }
+
+  const struct { size_t offset; size_t len; const std::string &s; } fields[] =
+  {
+    { 72, 32, info.getManufacturerName() },
+    { 104, 32, info.getModelName() },
+    { 136, 32, info.getDeviceVersion() },
+    { 168, 48, info.getManufacturerInfo() },
+    { 216, 16, info.getSerialNumber() },
+    { 232, 16, info.getUserName() }
+  };
+
+  for (const auto &f : fields)
+  {
+    std::memcpy(body+f.offset, f.s.data(), std::min(f.len, f.s.size()));
+  }
+
+  return p;
+}
+
+}
+
+#endif // RCDISCOVER_TEST_UTILS_H
@@ -36,10 +36,15 @@
 #include "rcdiscover-gui/discover-frame.h"
 #include "rcdiscover-gui/resources.h"
 
+#include "rcdiscover/iface_selection.h"
+
 #include <sstream>
+#include <stdexcept>
 
 #include "wx/app.h"
 #include "wx/msgdlg.h"
+#include "wx/cmdline.h"
+#include "wx/tokenzr.h"
 
 class RcDiscoverApp : public wxApp
 {
@@ -52,6 +57,13 @@ class RcDiscoverApp : public wxApp
 
     virtual bool OnInit() override
     {
+      // parses the command line
+
+      if (!wxApp::OnInit())
+      {
+        return false;
+      }
+
       SetAppName("rcdiscover");
       SetVendorName("Roboception");
 
@@ -68,11 +80,61 @@ class RcDiscoverApp : public wxApp
 
       registerResources();
 
-      frame_ = new DiscoverFrame("rcdiscover", wxPoint(50,50));
+      frame_ = new DiscoverFrame("rcdiscover", wxPoint(50,50), ifaces_);
       frame_->Show(true);
       return true;
     }
 
+    virtual void OnInitCmdLine(wxCmdLineParser &parser) override
+    {
+      wxApp::OnInitCmdLine(parser);
+
+      parser.AddOption("", "include-iface",
+                       "comma separated list of interface names, globs or "
+                       "subnets that are used for discovery");
+      parser.AddOption("", "exclude-iface",
+                       "comma separated list of interface names, globs or "
+                       "subnets that are not used for discovery");
+    }
+
+    virtual bool OnCmdLineParsed(wxCmdLineParser &parser) override
+    {
+      if (!wxApp::OnCmdLineParsed(parser))
+      {
+        return false;
+      }
+
+      try
+      {
+        wxString patterns;
+
+        if (parser.Found("include-iface", &patterns))
+        {
+          wxStringTokenizer tokens(patterns, ",");
+          while (tokens.HasMoreTokens())
+          {
+            ifaces_.include(tokens.GetNextToken().ToStdString());
+          }
+        }
+
+        if (parser.Found("exclude-iface", &patterns))
+        {
+          wxStringTokenizer tokens(patterns, ",");
+          while (tokens.HasMoreTokens())
+          {
+            ifaces_.exclude(tokens.GetNextToken().ToStdString());
+          }
+        }
+      }
+      catch(const std::exception &ex)
+      {
+        wxMessageBox(ex.what(), "Error", wxOK | wxICON_ERROR);
+        return false;
+      }
+
+      return true;
+    }
+
     virtual int OnExit() override
     {
 #ifdef WIN32
@@ -84,6 +146,7 @@ class RcDiscoverApp : public wxApp
 
   private:
     wxWindow *frame_;
+    rcdiscover::InterfaceSelection ifaces_;
 };
 
 wxIMPLEMENT_APP(RcDiscoverApp);
\ No newline at end of file
@@ -0,0 +1,451 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "device-list-model.h"
+
+#include "device-queue.h"
+
+#include "rcdiscover/utils.h"
+
+#include <algorithm>
+#include <limits>
+#include <cstring>
+
+namespace
+{
+
+/*
+  Copies a string into a fixed size buffer, truncating it if necessary.
+*/
+
+template<size_t N> void copyString(char (&dst)[N], const std::string &src)
+{
+  const size_t n = std::min(src.size(), N-1);
+  std::copy(src.begin(), src.begin()+n, dst);
+  dst[n] = '\0';
+}
+
+template<class T> int compareValues(const T &a, const T &b)
+{
+  return (a < b) ? -1 : ((b < a) ? 1 : 0);
+}
+
+}
+
+DeviceListModel::DeviceListModel() :
+  wxDataViewVirtualListModel(0),
+  sort_col_(MAC),
+  sort_ascending_(true)
+{ }
+
+void DeviceListModel::update(const DeviceUpdate &update)
+{
+  const rcdiscover::DeviceInfo &info = update.info;
+
+  const auto it = std::lower_bound(devices_.begin(), devices_.end(),
+                                   info.getMAC(),
+                                   [](const Device &d, uint64_t mac)
+                                   { return d.mac < mac; });
+  const auto i = static_cast<uint32_t>(it - devices_.begin());
+  const bool found = (it != devices_.end() && it->mac == info.getMAC());
+
+  Device device;
+
+  if (update.reachability_only)
+  {
+    if (!found)
+    {
+      return;
+    }
+
+    device = *it;
+    device.rtt_us = update.rtt_us;
+    device.loss = static_cast<int8_t>(update.loss);
+  }
+  else
+  {
+    device.mac = info.getMAC();
+    device.ip = info.getIP();
+    device.rtt_us = found ? it->rtt_us : -1;
+    device.reachable = found ? it->reachable : -1;
+    device.loss = found ? it->loss : -1;
+    device.seen = true;
+    copyString(device.name, info.getUserName());
+    copyString(device.serial, info.getSerialNumber());
+
+    if (update.rtt_us >= 0)
+    {
+      device.rtt_us = update.rtt_us;
+    }
+
+    if (update.loss >= 0)
+    {
+      device.loss = static_cast<int8_t>(update.loss);
+    }
+  }
+
+  if (update.reachable >= 0)
+  {
+    device.reachable = static_cast<int8_t>(update.reachable);
+  }
+
+  if (!found)
+  {
+    for (auto &r : rows_)
+    {
+      if (r >= i)
+      {
+        r++;
+      }
+    }
+
+    devices_.insert(it, device);
+
+    if (isShown(device))
+    {
+      insertRow(i);
+    }
+
+    return;
+  }
+
+  if (isEqual(*it, device))
+  {
+    it->seen = device.seen;
+    return;
+  }
+
+  // the row only needs to be redrawn if it stays visible at the same place
+
+  const bool shown = isShown(*it);
+
+  if (shown && isShown(device) && compare(*it, device) == 0)
+  {
+    *it = device;
+    RowChanged(findRow(i));
+    return;
+  }
+
+  if (shown)
+  {
+    const auto row = findRow(i);
+    rows_.erase(rows_.begin()+row);
+    RowDeleted(row);
+  }
+
+  *it = device;
+
+  if (isShown(device))
+  {
+    insertRow(i);
+  }
+}
+
+void DeviceListModel::markUnseen()
+{
+  for (auto &device : devices_)
+  {
+    device.seen = false;
+  }
+}
+
+void DeviceListModel::removeUnseen()
+{
+  const uint32_t removed = std::numeric_limits<uint32_t>::max();
+
+  std::vector<uint32_t> index(devices_.size());
+  size_t n = 0;
+  for (size_t i = 0; i < devices_.size(); i++)
+  {
+    if (devices_[i].seen)
+    {
+      index[i] = static_cast<uint32_t>(n);
+      devices_[n++] = devices_[i];
+    }
+    else
+    {
+      index[i] = removed;
+    }
+  }
+
+  if (n == devices_.size())
+  {
+    return;
+  }
+
+  devices_.resize(n);
+
+  wxArrayInt removed_rows;
+  std::vector<uint32_t> rows;
+  rows.reserve(rows_.size());
+  for (size_t row = 0; row < rows_.size(); row++)
+  {
+    if (index[rows_[row]] == removed)
+    {
+      removed_rows.Add(static_cast<int>(row));
+    }
+    else
+    {
+      rows.push_back(index[rows_[row]]);
+    }
+  }
+
+  rows_.swap(rows);
+
+  if (!removed_rows.IsEmpty())
+  {
+    RowsDeleted(removed_rows);
+  }
+}
+
+void DeviceListModel::setSortOrder(unsigned int col, bool ascending)
+{
+  if (col >= COLUMN_COUNT)
+  {
+    col = MAC;
+  }
+
+  sort_col_ = col;
+  sort_ascending_ = ascending;
+
+  createRows();
+}
+
+void DeviceListModel::setFilter(const wxString &text)
+{
+  filter_ = text.Lower();
+
+  createRows();
+}
+
+wxString DeviceListModel::getText(unsigned int row, unsigned int col) const
+{
+  if (row >= rows_.size())
+  {
+    return wxString();
+  }
+
+  return getText(devices_[rows_[row]], col);
+}
+
+uint64_t DeviceListModel::getMAC(unsigned int row) const
+{
+  return devices_[rows_[row]].mac;
+}
+
+wxString DeviceListModel::getDeviceName(size_t i) const
+{
+  return getText(devices_[i], NAME);
+}
+
+unsigned int DeviceListModel::GetColumnCount() const
+{
+  return COLUMN_COUNT;
+}
+
+wxString DeviceListModel::GetColumnType(unsigned int) const
+{
+  return "string";
+}
+
+void DeviceListModel::GetValueByRow(wxVariant &variant, unsigned int row,
+                                    unsigned int col) const
+{
+  variant = getText(row, col);
+}
+
+bool DeviceListModel::SetValueByRow(const wxVariant &, unsigned int,
+                                    unsigned int)
+{
+  return false;
+}
+
+const char *DeviceListModel::getName(const Device &device)
+{
+  return device.name[0] != '\0' ? device.name : "rc_visard";
+}
+
+wxString DeviceListModel::getText(const Device &device, unsigned int col)
+{
+  switch (col)
+  {
+    case NAME:
+      return wxString(getName(device));
+
+    case SERIAL:
+      return wxString(device.serial);
+
+    case IP:
+      return wxString(ip2string(device.ip));
+
+    case MAC:
+      return wxString(mac2string(device.mac));
+
+    case REACHABLE:
+      if (device.reachable < 0)
+      {
+        return wxString();
+      }
+
+      return wxString(device.reachable ? L"\u2713" : L"\u2717");
+
+    case RTT:
+      if (device.rtt_us < 0)
+      {
+        return wxString();
+      }
+
+      return wxString::Format("%.1f ms", device.rtt_us/1000.0);
+
+    case LOSS:
+      if (device.loss < 0)
+      {
+        return wxString();
+      }
+
+      return wxString::Format("%d %%", static_cast<int>(device.loss));
+
+    default:
+      return wxString();
+  }
+}
+
+bool DeviceListModel::isEqual(const Device &a, const Device &b)
+{
+  return a.mac == b.mac && a.ip == b.ip && a.reachable == b.reachable &&
+         a.rtt_us == b.rtt_us && a.loss == b.loss &&
+         std::strcmp(a.name, b.name) == 0 &&
+         std::strcmp(a.serial, b.serial) == 0;
+}
+
+int DeviceListModel::compare(const Device &a, const Device &b) const
+{
+  int ret = 0;
+
+  switch (sort_col_)
+  {
+    case NAME:
+      ret = std::strcmp(getName(a), getName(b));
+      break;
+
+    case SERIAL:
+      ret = std::strcmp(a.serial, b.serial);
+      break;
+
+    case IP:
+      ret = compareValues(a.ip, b.ip);
+      break;
+
+    case REACHABLE:
+      ret = compareValues(a.reachable, b.reachable);
+      break;
+
+    case RTT:
+      ret = compareValues(a.rtt_us, b.rtt_us);
+      break;
+
+    case LOSS:
+      ret = compareValues(a.loss, b.loss);
+      break;
+
+    default:
+      break;
+  }
+
+  // the MAC address makes the order unique
+
+  if (ret == 0)
+  {
+    ret = compareValues(a.mac, b.mac);
+  }
+
+  return sort_ascending_ ? ret : -ret;
+}
+
+bool DeviceListModel::isShown(const Device &device) const
+{
+  if (filter_.IsEmpty())
+  {
+    return true;
+  }
+
+  for (unsigned int col = NAME; col <= MAC; col++)
+  {
+    if (getText(device, col).Lower().Contains(filter_))
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+unsigned int DeviceListModel::findRow(uint32_t i) const
+{
+  const auto it = std::lower_bound(rows_.begin(), rows_.end(), i,
+                                   [this](uint32_t a, uint32_t b)
+                                   {
+                                     return compare(devices_[a],
+                                                    devices_[b]) < 0;
+                                   });
+  return static_cast<unsigned int>(it - rows_.begin());
+}
+
+void DeviceListModel::insertRow(uint32_t i)
+{
+  const auto row = findRow(i);
+  rows_.insert(rows_.begin()+row, i);
+  RowInserted(row);
+}
+
+void DeviceListModel::createRows()
+{
+  rows_.clear();
+  for (size_t i = 0; i < devices_.size(); i++)
+  {
+    if (isShown(devices_[i]))
+    {
+      rows_.push_back(static_cast<uint32_t>(i));
+    }
+  }
+
+  std::sort(rows_.begin(), rows_.end(), [this](uint32_t a, uint32_t b)
+            {
+              return compare(devices_[a], devices_[b]) < 0;
+            });
+
+  Reset(static_cast<unsigned int>(rows_.size()));
+}
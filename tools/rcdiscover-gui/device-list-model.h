@@ -0,0 +1,232 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef DEVICELISTMODEL_H
+#define DEVICELISTMODEL_H
+
+#include <vector>
+#include <cstdint>
+
+#include <wx/dataview.h>
+
+struct DeviceUpdate;
+
+/**
+ * @brief Virtual data model of the table of discovered rc_visards.
+ *
+ * Devices are stored in a compact table with fixed size entries that is
+ * sorted by MAC address. The text of a cell is only created when the cell
+ * is rendered. Sorting and filtering is done on an index into this table,
+ * so that the control only needs to redraw the visible rows.
+ *
+ * Changes are reported to the control row by row, so that the selection
+ * and scroll position are kept while rc_visards are discovered.
+ */
+class DeviceListModel : public wxDataViewVirtualListModel
+{
+  public:
+    enum Column
+    {
+      NAME = 0,
+      SERIAL,
+      IP,
+      MAC,
+      REACHABLE,
+      RTT,
+      LOSS,
+      COLUMN_COUNT
+    };
+
+    DeviceListModel();
+
+    virtual ~DeviceListModel() = default;
+
+    /**
+     * @brief Inserts or updates the entry of an rc_visard and marks it as
+     * seen. Reachability, round trip time and loss are kept if they are
+     * unknown in the update.
+     * @param update update
+     */
+    void update(const DeviceUpdate &update);
+
+    /**
+     * @brief Marks all entries as not seen.
+     */
+    void markUnseen();
+
+    /**
+     * @brief Removes all entries that have not been seen since the last
+     * call of markUnseen().
+     */
+    void removeUnseen();
+
+    /**
+     * @brief Sets the column by which the rows are sorted.
+     * @param col column
+     * @param ascending true for ascending order
+     */
+    void setSortOrder(unsigned int col, bool ascending);
+
+    /**
+     * @brief Only shows rows of which name, serial number, IP or MAC
+     * address contain the given text, ignoring case.
+     * @param text filter text, empty for showing all rows
+     */
+    void setFilter(const wxString &text);
+
+    /**
+     * @brief Returns the text of a cell.
+     * @param row row
+     * @param col column
+     * @return text, empty if the row does not exist
+     */
+    wxString getText(unsigned int row, unsigned int col) const;
+
+    /**
+     * @brief Returns the MAC address of the rc_visard of a row.
+     * @param row row
+     * @return MAC address
+     */
+    uint64_t getMAC(unsigned int row) const;
+
+    /**
+     * @brief Returns the number of rc_visards including the ones that are
+     * hidden by the filter.
+     * @return number of rc_visards
+     */
+    size_t getDeviceCount() const { return devices_.size(); }
+
+    /**
+     * @brief Returns the name of an rc_visard.
+     * @param i index into all rc_visards, which are sorted by MAC address
+     * @return name
+     */
+    wxString getDeviceName(size_t i) const;
+
+    /**
+     * @brief Returns the MAC address of an rc_visard.
+     * @param i index into all rc_visards, which are sorted by MAC address
+     * @return MAC address
+     */
+    uint64_t getDeviceMAC(size_t i) const { return devices_[i].mac; }
+
+    /**
+     * @brief Returns the IP address of an rc_visard.
+     * @param i index into all rc_visards, which are sorted by MAC address
+     * @return IP address
+     */
+    uint32_t getDeviceIP(size_t i) const { return devices_[i].ip; }
+
+    virtual unsigned int GetColumnCount() const override;
+
+    virtual wxString GetColumnType(unsigned int col) const override;
+
+    virtual void GetValueByRow(wxVariant &variant, unsigned int row,
+                               unsigned int col) const override;
+
+    virtual bool SetValueByRow(const wxVariant &variant, unsigned int row,
+                               unsigned int col) override;
+
+  private:
+    struct Device
+    {
+      uint64_t mac;
+      uint32_t ip;
+      int32_t rtt_us;
+      int8_t reachable;
+      int8_t loss;
+      bool seen;
+      char name[17];
+      char serial[17];
+    };
+
+    /**
+     * @brief Returns the displayed name, which defaults to "rc_visard".
+     */
+    static const char *getName(const Device &device);
+
+    /**
+     * @brief Returns the text of a cell.
+     * @param device device
+     * @param col column
+     * @return text
+     */
+    static wxString getText(const Device &device, unsigned int col);
+
+    /**
+     * @brief Returns true if both devices are displayed the same way.
+     */
+    static bool isEqual(const Device &a, const Device &b);
+
+    /**
+     * @brief Compares two devices according to the current sort order.
+     * @return negative, zero or positive value, like strcmp
+     */
+    int compare(const Device &a, const Device &b) const;
+
+    /**
+     * @brief Returns true if the device is shown with the current filter.
+     */
+    bool isShown(const Device &device) const;
+
+    /**
+     * @brief Returns the row of a shown device or the row at which it
+     * has to be inserted.
+     * @param i index into devices_
+     */
+    unsigned int findRow(uint32_t i) const;
+
+    /**
+     * @brief Inserts the row of a device and notifies the control.
+     * @param i index into devices_
+     */
+    void insertRow(uint32_t i);
+
+    /**
+     * @brief Creates the sorted and filtered list of rows and resets the
+     * control.
+     */
+    void createRows();
+
+    std::vector<Device> devices_;
+    std::vector<uint32_t> rows_; // index into devices_ per row
+
+    unsigned int sort_col_;
+    bool sort_ascending_;
+    wxString filter_;
+};
+
+#endif // DEVICELISTMODEL_H
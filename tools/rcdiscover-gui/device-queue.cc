@@ -0,0 +1,95 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "device-queue.h"
+
+DeviceQueue::DeviceQueue() :
+  head_(new Node()),
+  tail_(head_),
+  notified_(false)
+{
+  head_->next.store(nullptr, std::memory_order_relaxed);
+}
+
+DeviceQueue::~DeviceQueue()
+{
+  while (head_ != nullptr)
+  {
+    Node *next = head_->next.load(std::memory_order_relaxed);
+    delete head_;
+    head_ = next;
+  }
+}
+
+bool DeviceQueue::push(const DeviceUpdate &update)
+{
+  Node *node = new Node();
+  node->update = update;
+  node->next.store(nullptr, std::memory_order_relaxed);
+
+  // publishes the content of the node to the consumer
+
+  tail_->next.store(node, std::memory_order_release);
+  tail_ = node;
+
+  return !notified_.exchange(true, std::memory_order_acq_rel);
+}
+
+void DeviceQueue::acknowledge()
+{
+  // updates that are pushed after this point lead to a new notification,
+  // all others are visible to the following pop()
+
+  notified_.exchange(false, std::memory_order_acq_rel);
+}
+
+bool DeviceQueue::pop(DeviceUpdate &update)
+{
+  Node *next = head_->next.load(std::memory_order_acquire);
+
+  if (next == nullptr)
+  {
+    return false;
+  }
+
+  // the first node with content becomes the new dummy node
+
+  update = std::move(next->update);
+  delete head_;
+  head_ = next;
+
+  return true;
+}
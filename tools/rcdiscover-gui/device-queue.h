@@ -0,0 +1,108 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef DEVICEQUEUE_H
+#define DEVICEQUEUE_H
+
+#include "rcdiscover/deviceinfo.h"
+
+#include <atomic>
+
+/**
+ * @brief Update of one row of the device table.
+ */
+struct DeviceUpdate
+{
+  rcdiscover::DeviceInfo info;
+  int reachable = -1; ///< 1 if reachable, 0 if not, -1 if not checked yet
+  int rtt_us = -1; ///< round trip time in microseconds, -1 if unknown
+  int loss = -1; ///< lost echo requests in percent, -1 if not monitored
+
+  /// true if only reachability, round trip time and loss of the rc_visard
+  /// with the MAC address of info are updated
+  bool reachability_only = false;
+};
+
+/**
+ * @brief Unbounded lock-free queue for passing device updates from the
+ * discovery thread (single producer) to the GUI thread (single consumer).
+ *
+ * Pushing never blocks. The consumer needs to be notified only once for
+ * all updates that are pushed until it acknowledges the notification, so
+ * that devices that arrive in quick succession are handled in one batch.
+ */
+class DeviceQueue
+{
+  public:
+    DeviceQueue();
+    ~DeviceQueue();
+
+    DeviceQueue(const DeviceQueue &) = delete;
+    DeviceQueue &operator=(const DeviceQueue &) = delete;
+
+    /**
+     * @brief Appends an update. Must only be called by the producer.
+     * @param update update
+     * @return true if the consumer must be notified
+     */
+    bool push(const DeviceUpdate &update);
+
+    /**
+     * @brief Acknowledges a notification. Must be called by the consumer
+     * before draining the queue with pop().
+     */
+    void acknowledge();
+
+    /**
+     * @brief Removes the oldest update. Must only be called by the consumer.
+     * @param update set to the oldest update
+     * @return false if the queue is empty
+     */
+    bool pop(DeviceUpdate &update);
+
+  private:
+    struct Node
+    {
+      DeviceUpdate update;
+      std::atomic<Node *> next;
+    };
+
+    Node *head_; // dummy node, only used by the consumer
+    Node *tail_; // only used by the producer
+    std::atomic<bool> notified_;
+};
+
+#endif // DEVICEQUEUE_H
@@ -39,20 +39,30 @@
 #include "discover-frame.h"
 
 #include "discover-thread.h"
+#include "device-queue.h"
+#include "device-list-model.h"
+#include "reachability-monitor.h"
+#include "event-target.h"
 #include "event-ids.h"
 #include "reset-dialog.h"
 #include "about-dialog.h"
 
+#include "rcdiscover/cancel_token.h"
+
+#include <iostream>
 #include <memory>
 #include <sstream>
+#include <vector>
 
 #include <wx/frame.h>
 #include <wx/dataview.h>
 #include <wx/button.h>
+#include <wx/checkbox.h>
 #include <wx/animate.h>
 #include <wx/mstream.h>
 #include <wx/menu.h>
 #include <wx/panel.h>
+#include <wx/textctrl.h>
 #include <wx/sizer.h>
 #include <wx/clipbrd.h>
 #include <wx/dc.h>
@@ -64,9 +74,18 @@
 #include "resources/logo_32_rotate.h"
 
 DiscoverFrame::DiscoverFrame(const wxString& title,
-                const wxPoint& pos) :
+                const wxPoint& pos,
+                const rcdiscover::InterfaceSelection &ifaces) :
   wxFrame(NULL, wxID_ANY, title, pos, wxSize(650,350)),
+  ifaces_(ifaces),
+  generation_(0),
+  device_model_(nullptr),
   device_list_(nullptr),
+  filter_ctrl_(nullptr),
+  rtt_column_(nullptr),
+  loss_column_(nullptr),
+  monitor_checkbox_(nullptr),
+  refresh_checkbox_(nullptr),
   discover_button_(nullptr),
   reset_button_(nullptr),
   reset_dialog_(nullptr),
@@ -112,6 +131,16 @@ DiscoverFrame::DiscoverFrame(const wxString& title,
                                               wxDefaultPosition, wxSize(h,h));
   button_box->Add(help_button, 1);
 
+  monitor_checkbox_ = new wxCheckBox(panel, ID_Monitor_Checkbox, "Monitor");
+  monitor_checkbox_->SetToolTip("Ping all rc_visards every second and "
+                                "show round trip time and loss.");
+  button_box->Add(monitor_checkbox_, 0, wxLEFT | wxALIGN_CENTER_VERTICAL, 10);
+
+  refresh_checkbox_ = new wxCheckBox(panel, ID_AutoRefresh_Checkbox,
+                                     "Auto refresh");
+  refresh_checkbox_->SetToolTip("Rerun discovery every 10 seconds.");
+  button_box->Add(refresh_checkbox_, 0, wxLEFT | wxALIGN_CENTER_VERTICAL, 10);
+
   button_box->Add(-1, 0, wxEXPAND);
 
   spinner_ctrl_ = new wxAnimationCtrl(panel, wxID_ANY, spinner_, wxPoint(-1,-1), wxSize(32,32));
@@ -119,34 +148,60 @@ DiscoverFrame::DiscoverFrame(const wxString& title,
 
   vbox->Add(button_box, 0, wxALL, 10);
 
+  // filter
+
+  filter_ctrl_ = new wxTextCtrl(panel, ID_Filter_Textbox);
+  filter_ctrl_->SetHint("Filter by name, serial number, IP or MAC address");
+  vbox->Add(filter_ctrl_, 0, wxLEFT | wxRIGHT | wxBOTTOM | wxEXPAND, 10);
+
   // rc_visard table
   auto *data_box = new wxBoxSizer(wxHORIZONTAL);
 
-  device_list_ = new wxDataViewListCtrl(panel,
-                                        ID_DataViewListCtrl,
-                                        wxPoint(-1,-1),
-                                        wxSize(-1,-1));
-  device_list_->AppendTextColumn("Name",
+  device_list_ = new wxDataViewCtrl(panel,
+                                    ID_DataViewListCtrl,
+                                    wxPoint(-1,-1),
+                                    wxSize(-1,-1));
+
+  // the control keeps a reference to the model
+
+  device_model_ = new DeviceListModel();
+  device_list_->AssociateModel(device_model_);
+  device_model_->DecRef();
+
+  device_list_->AppendTextColumn("Name", DeviceListModel::NAME,
                                  wxDATAVIEW_CELL_INERT,
                                  100, wxALIGN_LEFT,
                                  wxDATAVIEW_COL_RESIZABLE | wxDATAVIEW_COL_SORTABLE);
-  device_list_->AppendTextColumn("Serial Number",
+  device_list_->AppendTextColumn("Serial Number", DeviceListModel::SERIAL,
                                  wxDATAVIEW_CELL_INERT,
                                  150, wxALIGN_LEFT,
                                  wxDATAVIEW_COL_RESIZABLE | wxDATAVIEW_COL_SORTABLE);
-  device_list_->AppendTextColumn("IP Address",
+  device_list_->AppendTextColumn("IP Address", DeviceListModel::IP,
                                  wxDATAVIEW_CELL_INERT,
                                  100, wxALIGN_LEFT,
                                  wxDATAVIEW_COL_RESIZABLE | wxDATAVIEW_COL_SORTABLE);
-  device_list_->AppendTextColumn("MAC Address",
+  device_list_->AppendTextColumn("MAC Address", DeviceListModel::MAC,
                                  wxDATAVIEW_CELL_INERT,
                                  130, wxALIGN_LEFT,
                                  wxDATAVIEW_COL_RESIZABLE | wxDATAVIEW_COL_SORTABLE);
-  device_list_->AppendTextColumn("Reachable",
+  device_list_->AppendTextColumn("Reachable", DeviceListModel::REACHABLE,
                                  wxDATAVIEW_CELL_INERT,
                                  100, wxALIGN_CENTER,
                                  wxDATAVIEW_COL_RESIZABLE | wxDATAVIEW_COL_SORTABLE);
 
+  // round trip time and loss are only shown while monitoring
+
+  rtt_column_ = device_list_->AppendTextColumn("RTT", DeviceListModel::RTT,
+                                 wxDATAVIEW_CELL_INERT,
+                                 80, wxALIGN_RIGHT,
+                                 wxDATAVIEW_COL_RESIZABLE | wxDATAVIEW_COL_SORTABLE);
+  loss_column_ = device_list_->AppendTextColumn("Loss", DeviceListModel::LOSS,
+                                 wxDATAVIEW_CELL_INERT,
+                                 60, wxALIGN_RIGHT,
+                                 wxDATAVIEW_COL_RESIZABLE | wxDATAVIEW_COL_SORTABLE);
+  rtt_column_->SetHidden(true);
+  loss_column_->SetHidden(true);
+
   device_list_->SetToolTip("Double-click row to open WebGUI in browser.");
 
   data_box->Add(device_list_, 1, wxEXPAND);
@@ -162,6 +217,9 @@ DiscoverFrame::DiscoverFrame(const wxString& title,
   Connect(ID_DiscoverButton,
           wxEVT_COMMAND_BUTTON_CLICKED,
           wxCommandEventHandler(DiscoverFrame::onDiscoverButton));
+  Connect(wxID_ANY,
+          wxEVT_COMMAND_DISCOVERY_UPDATE,
+          wxThreadEventHandler(DiscoverFrame::onDiscoveryUpdate));
   Connect(wxID_ANY,
           wxEVT_COMMAND_DISCOVERY_COMPLETED,
           wxThreadEventHandler(DiscoverFrame::onDiscoveryCompleted));
@@ -180,6 +238,18 @@ DiscoverFrame::DiscoverFrame(const wxString& title,
   Connect(ID_DataViewListCtrl,
           wxEVT_DATAVIEW_ITEM_CONTEXT_MENU,
           wxDataViewEventHandler(DiscoverFrame::onDataViewContextMenu));
+  Connect(ID_DataViewListCtrl,
+          wxEVT_DATAVIEW_COLUMN_SORTED,
+          wxDataViewEventHandler(DiscoverFrame::onColumnSorted));
+  Connect(ID_Filter_Textbox,
+          wxEVT_TEXT,
+          wxCommandEventHandler(DiscoverFrame::onFilterChanged));
+  Connect(ID_Monitor_Checkbox,
+          wxEVT_CHECKBOX,
+          wxCommandEventHandler(DiscoverFrame::onMonitorToggled));
+  Connect(ID_AutoRefresh_Checkbox,
+          wxEVT_CHECKBOX,
+          wxCommandEventHandler(DiscoverFrame::onAutoRefreshToggled));
   Connect(ID_OpenWebGUI,
           wxEVT_MENU,
           wxMenuEventHandler(DiscoverFrame::onOpenWebGUI));
@@ -202,21 +272,31 @@ DiscoverFrame::DiscoverFrame(const wxString& title,
   reset_dialog_ = new ResetDialog(help_ctrl_, panel, wxID_ANY);
   about_dialog_ = new AboutDialog(panel, wxID_ANY);
 
+  events_ = std::make_shared<EventTarget>(GetEventHandler());
+
   // start discovery on startup
-  wxCommandEvent evt;
-  onDiscoverButton(evt);
+  startDiscovery();
+}
+
+DiscoverFrame::~DiscoverFrame()
+{
+  // a running discovery is not waited for, but must not send events to
+  // the destroyed window anymore
+
+  stopDiscovery();
+  events_->detach();
+
+  monitor_.reset();
 }
 
 void DiscoverFrame::setBusy()
 {
-  discover_button_->Disable();
   reset_button_->Disable();
   spinner_ctrl_->Play();
 }
 
 void DiscoverFrame::clearBusy()
 {
-  discover_button_->Enable();
   reset_button_->Enable();
   spinner_ctrl_->Stop();
 
@@ -229,9 +309,27 @@ void DiscoverFrame::clearBusy()
 
 void DiscoverFrame::onDiscoverButton(wxCommandEvent &)
 {
+  startDiscovery();
+}
+
+void DiscoverFrame::startDiscovery()
+{
+  stopDiscovery();
+
   setBusy();
 
-  auto *thread = new DiscoverThread(this);
+  // rows that are not updated by this discovery are removed at the end
+
+  generation_++;
+  queue_ = std::make_shared<DeviceQueue>();
+  cancel_ = std::make_shared<rcdiscover::CancelToken>();
+  device_model_->markUnseen();
+
+  const std::chrono::milliseconds interval(
+    refresh_checkbox_->IsChecked() ? 10000 : 0);
+
+  auto *thread = new DiscoverThread(events_, ifaces_, queue_, cancel_,
+                                    generation_, interval);
   if (thread->Run() != wxTHREAD_NO_ERROR)
   {
     std::cerr << "Could not spawn thread" << std::endl;
@@ -242,24 +340,140 @@ void DiscoverFrame::onDiscoverButton(wxCommandEvent &)
   }
 }
 
-void DiscoverFrame::onDiscoveryCompleted(wxThreadEvent &event)
+void DiscoverFrame::stopDiscovery()
 {
-  device_list_->DeleteAllItems();
+  if (cancel_)
+  {
+    cancel_->cancel();
+    cancel_.reset();
+  }
+}
 
-  std::vector<wxVector<wxVariant>> data =
-      event.GetPayload<std::vector<wxVector<wxVariant>>>();
-  for(const auto& d : data)
+void DiscoverFrame::onAutoRefreshToggled(wxCommandEvent &)
+{
+  startDiscovery();
+}
+
+void DiscoverFrame::onDiscoveryUpdate(wxThreadEvent &)
+{
+  drainQueue();
+}
+
+void DiscoverFrame::onDiscoveryCompleted(wxThreadEvent &event)
+{
+  if (event.GetInt() != generation_)
   {
-    device_list_->AppendItem(d);
+    return;
   }
 
-  reset_dialog_->setDiscoveredSensors(device_list_->GetStore());
+  drainQueue();
+
+  // with auto refresh, the next round starts with all rows unseen
+
+  device_model_->removeUnseen();
+  device_model_->markUnseen();
+
+  reset_dialog_->setDiscoveredSensors(device_model_);
+
+  updateMonitor();
 
   clearBusy();
 }
 
+void DiscoverFrame::drainQueue()
+{
+  DeviceUpdate update;
+
+  if (queue_)
+  {
+    queue_->acknowledge();
+
+    while (queue_->pop(update))
+    {
+      device_model_->update(update);
+    }
+  }
+
+  if (monitor_)
+  {
+    DeviceQueue &queue = monitor_->getQueue();
+    queue.acknowledge();
+
+    while (queue.pop(update))
+    {
+      device_model_->update(update);
+    }
+  }
+}
+
+void DiscoverFrame::onMonitorToggled(wxCommandEvent &)
+{
+  setMonitoring(monitor_checkbox_->IsChecked());
+}
+
+void DiscoverFrame::setMonitoring(bool monitor)
+{
+  if (monitor)
+  {
+    monitor_.reset(new ReachabilityMonitor(events_));
+    updateMonitor();
+  }
+  else
+  {
+    monitor_.reset();
+  }
+
+  monitor_checkbox_->SetValue(monitor);
+  rtt_column_->SetHidden(!monitor);
+  loss_column_->SetHidden(!monitor);
+}
+
+void DiscoverFrame::updateMonitor()
+{
+  if (!monitor_)
+  {
+    return;
+  }
+
+  std::vector<ReachabilityMonitor::Device> devices;
+  devices.reserve(device_model_->getDeviceCount());
+  for (size_t i = 0; i < device_model_->getDeviceCount(); i++)
+  {
+    ReachabilityMonitor::Device device;
+    device.mac = device_model_->getDeviceMAC(i);
+    device.ip = device_model_->getDeviceIP(i);
+    devices.push_back(device);
+  }
+
+  monitor_->setDevices(std::move(devices));
+}
+
 void DiscoverFrame::onDiscoveryError(wxThreadEvent &event)
 {
+  if (event.GetInt() == ReachabilityMonitor::GENERATION)
+  {
+    // the monitor has stopped, unless it has been switched off meanwhile
+
+    if (monitor_)
+    {
+      drainQueue();
+      setMonitoring(false);
+
+      std::ostringstream oss;
+      oss << "Reachability monitoring stopped: " << event.GetString();
+      wxMessageBox(oss.str(), "Error", wxOK | wxICON_ERROR);
+    }
+
+    return;
+  }
+
+  if (event.GetInt() != generation_)
+  {
+    return;
+  }
+
+  drainQueue();
+
   std::ostringstream oss;
   oss << "An error occurred during discovery: " << event.GetString();
   wxMessageBox(oss.str(), "Error", wxOK | wxICON_ERROR);
@@ -269,7 +483,7 @@ void DiscoverFrame::onDiscoveryError(wxThreadEvent &event)
 
 void DiscoverFrame::onResetButton(wxCommandEvent &)
 {
-  openResetDialog(device_list_->GetSelectedRow());
+  openResetDialog(getRow(device_list_->GetSelection()));
 }
 
 void DiscoverFrame::onHelpDiscovery(wxCommandEvent&)
@@ -279,23 +493,49 @@ void DiscoverFrame::onHelpDiscovery(wxCommandEvent&)
 
 void DiscoverFrame::onDeviceDoubleClick(wxDataViewEvent &event)
 {
-  const auto item = event.GetItem();
-  const auto row = device_list_->ItemToRow(item);
+  const auto row = getRow(event.GetItem());
 
   if (row == wxNOT_FOUND)
   {
     return;
   }
 
-  const auto ip_wxstring = device_list_->GetTextValue(
-                             static_cast<unsigned int>(row), 2);
+  const auto ip_wxstring = device_model_->getText(
+                             static_cast<unsigned int>(row),
+                             DeviceListModel::IP);
   wxLaunchDefaultBrowser("http://" + ip_wxstring + "/");
 }
 
+void DiscoverFrame::onColumnSorted(wxDataViewEvent &event)
+{
+  const wxDataViewColumn *col = event.GetDataViewColumn();
+
+  if (col != nullptr)
+  {
+    device_model_->setSortOrder(col->GetModelColumn(),
+                                col->IsSortOrderAscending());
+  }
+}
+
+void DiscoverFrame::onFilterChanged(wxCommandEvent &)
+{
+  device_model_->setFilter(filter_ctrl_->GetValue());
+}
+
+int DiscoverFrame::getRow(const wxDataViewItem &item) const
+{
+  if (!item.IsOk())
+  {
+    return wxNOT_FOUND;
+  }
+
+  return static_cast<int>(device_model_->GetRow(item));
+}
+
 void DiscoverFrame::onDataViewContextMenu(wxDataViewEvent &event)
 {
   menu_event_item_.reset(new std::pair<int, int>(
-                           device_list_->ItemToRow(event.GetItem()),
+                           getRow(event.GetItem()),
                            event.GetColumn()));
 
   if (menu_event_item_->first < 0)
@@ -327,7 +567,7 @@ void DiscoverFrame::onCopy(wxMenuEvent &)
   }
 
   const auto row = static_cast<unsigned int>(menu_event_item_->first);
-  const auto cell = device_list_->GetTextValue(
+  const auto cell = device_model_->getText(
                       row, static_cast<unsigned int>(menu_event_item_->second));
 
   if (wxTheClipboard->Open())
@@ -345,9 +585,9 @@ void DiscoverFrame::onOpenWebGUI(wxMenuEvent &)
     return;
   }
 
-  const auto ip_wxstring = device_list_->GetTextValue(
+  const auto ip_wxstring = device_model_->getText(
                              static_cast<unsigned int>(menu_event_item_->first),
-                             2);
+                             DeviceListModel::IP);
   wxLaunchDefaultBrowser("http://" + ip_wxstring + "/");
 }
 
@@ -379,9 +619,11 @@ void DiscoverFrame::onAbout(wxCommandEvent &)
 
 void DiscoverFrame::openResetDialog(const int row)
 {
-  if (row != wxNOT_FOUND)
+  if (row != wxNOT_FOUND &&
+      static_cast<unsigned int>(row) < device_model_->GetCount())
   {
-    reset_dialog_->setActiveSensor(static_cast<unsigned int>(row));
+    reset_dialog_->setActiveSensor(
+      device_model_->getMAC(static_cast<unsigned int>(row)));
   }
 
   reset_dialog_->Show();
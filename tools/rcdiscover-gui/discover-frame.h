@@ -36,18 +36,34 @@
 #ifndef DISCOVERFRAME_H
 #define DISCOVERFRAME_H
 
+#include "rcdiscover/iface_selection.h"
+
 #include <memory>
 
 #include <wx/frame.h>
 #include <wx/animate.h>
 
-class wxDataViewListCtrl;
+class wxDataViewCtrl;
+class wxDataViewColumn;
+class wxCheckBox;
 class wxButton;
 class wxDataViewEvent;
+class wxDataViewItem;
 class wxPanel;
+class wxTextCtrl;
 class ResetDialog;
 class AboutDialog;
 class wxHtmlHelpController;
+class DeviceQueue;
+class DeviceListModel;
+class ReachabilityMonitor;
+class EventTarget;
+
+namespace rcdiscover
+{
+class CancelToken;
+}
+struct DeviceUpdate;
 
 /**
  * @brief Main window in which the table of discovered rc_visards is displayed.
@@ -59,11 +75,14 @@ class DiscoverFrame : public wxFrame
      * @brief Constructor.
      * @param title title of the window
      * @param pos position of the window
+     * @param ifaces interfaces that are used for discovery
      */
     DiscoverFrame(const wxString& title,
-                    const wxPoint& pos);
+                    const wxPoint& pos,
+                    const rcdiscover::InterfaceSelection &ifaces =
+                      rcdiscover::InterfaceSelection());
 
-    virtual ~DiscoverFrame() = default;
+    virtual ~DiscoverFrame();
 
   private:
     /**
@@ -80,19 +99,64 @@ class DiscoverFrame : public wxFrame
      */
     void onDiscoverButton(wxCommandEvent &);
 
+    /**
+     * @brief Starts a new discovery. A running discovery is cancelled and
+     * its remaining events are ignored.
+     */
+    void startDiscovery();
+
+    /**
+     * @brief Cancels a running discovery.
+     */
+    void stopDiscovery();
+
+    /**
+     * @brief Event handler for switching periodic discovery on or off.
+     */
+    void onAutoRefreshToggled(wxCommandEvent &);
+
+    /**
+     * @brief Event handler for newly discovered or updated rc_visards.
+     */
+    void onDiscoveryUpdate(wxThreadEvent &);
+
     /**
      * @brief Event handler for completed rc_visard discovery.
      * @param event event
      */
     void onDiscoveryCompleted(wxThreadEvent &event);
 
+    /**
+     * @brief Applies all pending updates of the discovery thread and the
+     * reachability monitor to the table.
+     */
+    void drainQueue();
+
+    /**
+     * @brief Event handler for switching continuous monitoring of
+     * reachability on or off.
+     */
+    void onMonitorToggled(wxCommandEvent &);
+
+    /**
+     * @brief Starts or stops continuous monitoring of reachability.
+     * @param monitor true for starting
+     */
+    void setMonitoring(bool monitor);
+
+    /**
+     * @brief Passes the rc_visards of the table to the reachability monitor.
+     */
+    void updateMonitor();
+
     /**
      * @brief Event handler for help button.
      */
     void onHelpDiscovery(wxCommandEvent &);
 
     /**
-     * @brief Event handler for erroneous rc_visard discovery.
+     * @brief Event handler for erroneous rc_visard discovery or
+     * reachability monitoring.
      * @param event event
      */
     void onDiscoveryError(wxThreadEvent &event);
@@ -108,6 +172,24 @@ class DiscoverFrame : public wxFrame
      */
     void onDeviceDoubleClick(wxDataViewEvent &event);
 
+    /**
+     * @brief Event handler for click on a column header.
+     * @param event event
+     */
+    void onColumnSorted(wxDataViewEvent &event);
+
+    /**
+     * @brief Event handler for changed filter text.
+     */
+    void onFilterChanged(wxCommandEvent &);
+
+    /**
+     * @brief Returns the row of an item of the table.
+     * @param item item
+     * @return row or wxNOT_FOUND
+     */
+    int getRow(const wxDataViewItem &item) const;
+
     /**
      * @brief Event handler for right mouse button click on rc_visard.
      * @param event event
@@ -153,7 +235,19 @@ class DiscoverFrame : public wxFrame
     wxDECLARE_EVENT_TABLE();
 
   private:
-    wxDataViewListCtrl *device_list_;
+    rcdiscover::InterfaceSelection ifaces_;
+    std::shared_ptr<EventTarget> events_;
+    std::shared_ptr<DeviceQueue> queue_;
+    std::shared_ptr<rcdiscover::CancelToken> cancel_;
+    int generation_;
+    DeviceListModel *device_model_;
+    wxDataViewCtrl *device_list_;
+    wxTextCtrl *filter_ctrl_;
+    wxDataViewColumn *rtt_column_;
+    wxDataViewColumn *loss_column_;
+    wxCheckBox *monitor_checkbox_;
+    wxCheckBox *refresh_checkbox_;
+    std::unique_ptr<ReachabilityMonitor> monitor_;
     wxButton *discover_button_;
     wxButton *reset_button_;
     ResetDialog *reset_dialog_;
@@ -36,87 +36,173 @@
 // placed here to make sure to include winsock2.h before windows.h
 #include "rcdiscover/discover.h"
 #include "rcdiscover/ping.h"
+#include "rcdiscover/iface_affinity.h"
 
 #include "discover-thread.h"
 
+#include "rcdiscover/cancel_token.h"
+
+#include "device-queue.h"
 #include "event-ids.h"
-#include "rcdiscover/utils.h"
+#include "event-target.h"
 
 #include <vector>
+#include <map>
 #include <algorithm>
-#include <future>
-
-#include <wx/window.h>
+#include <unordered_set>
 
 wxThread::ExitCode DiscoverThread::Entry()
 {
-  std::vector<wxVector<wxVariant>> device_list;
-
   try
   {
-    rcdiscover::Discover discover;
-    discover.broadcastRequest();
-
-    std::vector<rcdiscover::DeviceInfo> infos;
+    // the sockets stay open for all rounds
 
-    while (discover.getResponse(infos, 100)) { }
+    rcdiscover::Discover discover(ifaces_);
+    discover.setCancelToken(cancel_);
 
-    std::sort(infos.begin(), infos.end());
-    const auto it = std::unique(infos.begin(), infos.end());
-    infos.erase(it, infos.end());
+    rcdiscover::Pinger pinger;
+    pinger.setCancelToken(cancel_);
 
-    std::vector<std::future<bool>> reachable;
-    for (rcdiscover::DeviceInfo &info : infos)
+    do
     {
-      if (!info.isValid())
+      if (!discoverOnce(discover, pinger))
       {
-        continue;
+        return ExitCode(0);
       }
-      reachable.push_back(std::async(std::launch::async, [&info]
-      {
-        return checkReachabilityOfSensor(info);
-      }));
-    }
 
-    size_t i = 0;
-    for (rcdiscover::DeviceInfo &info : infos)
+      wxThreadEvent event(wxEVT_COMMAND_DISCOVERY_COMPLETED);
+      send(event);
+    }
+    while (interval_.count() > 0 && waitForNextRound());
+  }
+  catch(const std::exception& ex)
+  {
+    if (!isCancelled())
     {
-      if (!info.isValid())
-      {
-        continue;
-      }
+      wxThreadEvent event(wxEVT_COMMAND_DISCOVERY_ERROR);
+      event.SetString(ex.what());
+      send(event);
+    }
 
-      std::string name=info.getUserName();
+    return ExitCode(1);
+  }
 
-      if (name.size() == 0)
+  return ExitCode(0);
+}
+
+bool DiscoverThread::discoverOnce(rcdiscover::Discover &discover,
+                                  rcdiscover::Pinger &pinger)
+{
+  discover.broadcastRequest();
+
+  std::vector<rcdiscover::DeviceInfo> infos;
+  std::vector<rcdiscover::DeviceInfo> devices;
+  std::unordered_set<uint64_t> macs;
+
+  // each device is shown as soon as it answers
+
+  size_t n = 0;
+  bool more = true;
+  while (more)
+  {
+    more = discover.getResponse(infos, 100);
+
+    for (; n < infos.size(); n++)
+    {
+      if (infos[n].isValid() && macs.insert(infos[n].getMAC()).second)
       {
-        name = "rc_visard";
+        devices.push_back(infos[n]);
+
+        DeviceUpdate update;
+        update.info = infos[n];
+        post(update);
       }
+    }
+  }
 
-      wxVector<wxVariant> data;
-      data.push_back(wxVariant(name));
-      data.push_back(wxVariant(info.getSerialNumber()));
-      data.push_back(wxVariant(ip2string(info.getIP())));
-      data.push_back(wxVariant(mac2string(info.getMAC())));
-      data.push_back(wxVariant(reachable[i].get() ? L"\u2713" : L"\u2717"));
+  rcdiscover::IfaceAffinity::update(devices);
 
-      device_list.push_back(std::move(data));
+  if (isCancelled())
+  {
+    return false;
+  }
 
-      ++i;
+  // all devices are pinged at once and each result is shown as soon as
+  // it is known
+
+  std::multimap<uint32_t, size_t> index;
+  std::vector<uint32_t> ips;
+  for (size_t i = 0; i < devices.size(); i++)
+  {
+    if (index.find(devices[i].getIP()) == index.end())
+    {
+      ips.push_back(devices[i].getIP());
     }
+    index.insert(std::make_pair(devices[i].getIP(), i));
   }
-  catch(const std::exception& ex)
+
+  pinger.ping(ips, std::chrono::seconds(1),
+              [&](const rcdiscover::PingResult &result)
+  {
+    const auto range = index.equal_range(result.ip);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+      DeviceUpdate update;
+      update.info = devices[it->second];
+      update.reachable = result.reachable ? 1 : 0;
+      update.rtt_us = result.reachable ?
+        static_cast<int>(result.rtt.count()) : -1;
+      post(update);
+    }
+  });
+
+  return !isCancelled();
+}
+
+bool DiscoverThread::waitForNextRound()
+{
+  const auto end = std::chrono::steady_clock::now() + interval_;
+
+  while (!isCancelled())
   {
-    wxThreadEvent event(wxEVT_COMMAND_DISCOVERY_ERROR);
-    event.SetString(ex.what());
-    parent_->GetEventHandler()->QueueEvent(event.Clone());
+    const auto remaining = std::chrono::duration_cast<
+      std::chrono::milliseconds>(end - std::chrono::steady_clock::now());
 
-    return ExitCode(1);
+    if (remaining.count() <= 0)
+    {
+      return true;
+    }
+
+    Sleep(static_cast<unsigned long>(std::min<int64_t>(remaining.count(),
+                                                        50)));
   }
 
-  wxThreadEvent event(wxEVT_COMMAND_DISCOVERY_COMPLETED);
-  event.SetPayload(device_list);
-  parent_->GetEventHandler()->QueueEvent(event.Clone());
+  return false;
+}
 
-  return ExitCode(0);
-}
\ No newline at end of file
+bool DiscoverThread::isCancelled()
+{
+  // wxWidgets requests termination of remaining threads on exit
+
+  if (TestDestroy())
+  {
+    cancel_->cancel();
+  }
+
+  return cancel_->isCancelled();
+}
+
+void DiscoverThread::post(const DeviceUpdate &update)
+{
+  if (queue_->push(update))
+  {
+    wxThreadEvent event(wxEVT_COMMAND_DISCOVERY_UPDATE);
+    send(event);
+  }
+}
+
+void DiscoverThread::send(wxThreadEvent &event)
+{
+  event.SetInt(generation_);
+  target_->post(event);
+}
@@ -36,18 +36,64 @@
 #ifndef DISCOVERTHREAD_H
 #define DISCOVERTHREAD_H
 
+#include "rcdiscover/iface_selection.h"
+
+#include <memory>
+#include <chrono>
+
 #include <wx/thread.h>
 
-class wxWindow;
+class wxThreadEvent;
+class DeviceQueue;
+class EventTarget;
+struct DeviceUpdate;
+
+namespace rcdiscover
+{
+class Discover;
+class Pinger;
+class CancelToken;
+}
 
 /**
  * @brief Thread in which the discovery of rc_visards is run.
+ *
+ * Each device is passed to the queue as soon as it has been discovered, and
+ * again as soon as the result of its reachability check is known. The end
+ * of each discovery round is signalled by an event, which carries the
+ * generation number of the thread.
+ *
+ * The thread stops within a few milliseconds after the cancel token has
+ * been cancelled, without sending further events. With a refresh interval,
+ * discovery is repeated with the same open sockets until cancelled.
  */
 class DiscoverThread : public wxThread
 {
   public:
-    DiscoverThread(wxWindow *parent) :
-      parent_(parent)
+    /**
+     * @brief Constructor.
+     * @param target receiver of the events of the discovery
+     * @param ifaces interfaces that are used for discovery
+     * @param queue queue for the discovered devices
+     * @param cancel token for stopping the thread
+     * @param generation number that is passed with all events, for
+     *                   identifying the events of a replaced thread
+     * @param interval interval for repeating the discovery, 0 for
+     *                 discovering only once
+     */
+    DiscoverThread(std::shared_ptr<EventTarget> target,
+                   const rcdiscover::InterfaceSelection &ifaces,
+                   std::shared_ptr<DeviceQueue> queue,
+                   std::shared_ptr<rcdiscover::CancelToken> cancel,
+                   int generation,
+                   std::chrono::milliseconds interval =
+                     std::chrono::milliseconds(0)) :
+      target_(std::move(target)),
+      ifaces_(ifaces),
+      queue_(std::move(queue)),
+      cancel_(std::move(cancel)),
+      generation_(generation),
+      interval_(interval)
     { }
 
     virtual ~DiscoverThread() = default;
@@ -56,7 +102,45 @@ class DiscoverThread : public wxThread
     virtual ExitCode Entry() override;
 
   private:
-    wxWindow *parent_;
+    /**
+     * @brief Runs one round of discovery and reachability checks.
+     * @param discover open discovery session
+     * @param pinger pinger for the reachability checks
+     * @return false if cancelled
+     */
+    bool discoverOnce(rcdiscover::Discover &discover,
+                      rcdiscover::Pinger &pinger);
+
+    /**
+     * @brief Waits for the refresh interval.
+     * @return false if cancelled
+     */
+    bool waitForNextRound();
+
+    /**
+     * @brief Returns true if the thread should stop.
+     */
+    bool isCancelled();
+
+    /**
+     * @brief Passes an update to the queue and notifies the parent if
+     * required.
+     * @param update update
+     */
+    void post(const DeviceUpdate &update);
+
+    /**
+     * @brief Sends an event with the generation number of the thread.
+     * @param event event
+     */
+    void send(wxThreadEvent &event);
+
+    std::shared_ptr<EventTarget> target_;
+    rcdiscover::InterfaceSelection ifaces_;
+    std::shared_ptr<DeviceQueue> queue_;
+    std::shared_ptr<rcdiscover::CancelToken> cancel_;
+    int generation_;
+    std::chrono::milliseconds interval_;
 };
 
-#endif // DISCOVERTHREAD_H
\ No newline at end of file
+#endif // DISCOVERTHREAD_H
@@ -35,5 +35,6 @@
 
 #include "event-ids.h"
 
+wxDEFINE_EVENT(wxEVT_COMMAND_DISCOVERY_UPDATE, wxThreadEvent);
 wxDEFINE_EVENT(wxEVT_COMMAND_DISCOVERY_COMPLETED, wxThreadEvent);
 wxDEFINE_EVENT(wxEVT_COMMAND_DISCOVERY_ERROR, wxThreadEvent);
\ No newline at end of file
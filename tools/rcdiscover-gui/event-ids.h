@@ -39,6 +39,7 @@
 #include <wx/defs.h>
 #include <wx/event.h>
 
+wxDECLARE_EVENT(wxEVT_COMMAND_DISCOVERY_UPDATE, wxThreadEvent);
 wxDECLARE_EVENT(wxEVT_COMMAND_DISCOVERY_COMPLETED, wxThreadEvent);
 wxDECLARE_EVENT(wxEVT_COMMAND_DISCOVERY_ERROR, wxThreadEvent);
 
@@ -58,6 +59,9 @@ enum
 
   ID_Sensor_Combobox,
   ID_MAC_Textbox,
+  ID_Filter_Textbox,
+  ID_Monitor_Checkbox,
+  ID_AutoRefresh_Checkbox,
   ID_IP_Textbox,
   ID_IP_Checkbox
 };
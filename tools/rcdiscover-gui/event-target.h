@@ -0,0 +1,86 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef EVENTTARGET_H
+#define EVENTTARGET_H
+
+#include <mutex>
+
+#include <wx/event.h>
+
+/**
+ * @brief Receiver of the events of background threads, which can be
+ * detached when the receiving window is destroyed while the threads are
+ * still running.
+ */
+class EventTarget
+{
+  public:
+    explicit EventTarget(wxEvtHandler *handler) :
+      handler_(handler)
+    { }
+
+    EventTarget(const EventTarget &) = delete;
+    EventTarget &operator=(const EventTarget &) = delete;
+
+    /**
+     * @brief Queues a copy of the event, unless detached.
+     * @param event event
+     */
+    void post(const wxEvent &event)
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      if (handler_ != nullptr)
+      {
+        handler_->QueueEvent(event.Clone());
+      }
+    }
+
+    /**
+     * @brief Drops all further events.
+     */
+    void detach()
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      handler_ = nullptr;
+    }
+
+  private:
+    std::mutex mtx_;
+    wxEvtHandler *handler_;
+};
+
+#endif // EVENTTARGET_H
@@ -0,0 +1,194 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+// placed here to make sure to include winsock2.h before windows.h
+#include "rcdiscover/ping.h"
+
+#include "reachability-monitor.h"
+
+#include "rcdiscover/cancel_token.h"
+
+#include "event-ids.h"
+#include "event-target.h"
+
+#include <algorithm>
+#include <map>
+
+namespace
+{
+
+/*
+  Results of the recent echo requests of one rc_visard.
+*/
+
+struct History
+{
+  uint32_t ip = 0;
+  uint16_t lost = 0; // one bit per request, the most recent one is bit 0
+  int count = 0;
+};
+
+const int history_size = 10;
+
+}
+
+ReachabilityMonitor::ReachabilityMonitor(std::shared_ptr<EventTarget> target,
+                                         std::chrono::milliseconds interval) :
+  target_(std::move(target)),
+  interval_(interval),
+  stop_(false),
+  cancel_(std::make_shared<rcdiscover::CancelToken>())
+{
+  thread_ = std::thread(&ReachabilityMonitor::run, this);
+}
+
+ReachabilityMonitor::~ReachabilityMonitor()
+{
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    stop_ = true;
+  }
+
+  cancel_->cancel();
+
+  cv_.notify_all();
+  thread_.join();
+}
+
+void ReachabilityMonitor::setDevices(std::vector<Device> devices)
+{
+  std::lock_guard<std::mutex> lock(mtx_);
+  devices_ = std::move(devices);
+}
+
+void ReachabilityMonitor::run()
+{
+  try
+  {
+    rcdiscover::Pinger pinger;
+    pinger.setCancelToken(cancel_);
+
+    std::map<uint64_t, History> history;
+
+    const auto timeout = std::min<std::chrono::milliseconds>(
+      interval_, std::chrono::seconds(1));
+
+    std::unique_lock<std::mutex> lock(mtx_);
+    while (!stop_)
+    {
+      const std::vector<Device> devices = devices_;
+      lock.unlock();
+
+      const auto start = std::chrono::steady_clock::now();
+
+      // forget rc_visards that are gone and restart the history of the
+      // ones that changed their IP address
+
+      std::map<uint64_t, History> current;
+      std::multimap<uint32_t, uint64_t> macs;
+      std::vector<uint32_t> ips;
+      for (const Device &device : devices)
+      {
+        History &h = current[device.mac];
+        const auto it = history.find(device.mac);
+        if (it != history.end() && it->second.ip == device.ip)
+        {
+          h = it->second;
+        }
+        h.ip = device.ip;
+
+        if (macs.find(device.ip) == macs.end())
+        {
+          ips.push_back(device.ip);
+        }
+        macs.insert(std::make_pair(device.ip, device.mac));
+      }
+      history.swap(current);
+
+      pinger.ping(ips, timeout, [&](const rcdiscover::PingResult &result)
+      {
+        const auto range = macs.equal_range(result.ip);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+          History &h = history[it->second];
+          h.lost = static_cast<uint16_t>((h.lost << 1) |
+                                         (result.reachable ? 0 : 1));
+          h.count = std::min(h.count + 1, history_size);
+
+          int lost = 0;
+          for (int i = 0; i < h.count; i++)
+          {
+            lost += (h.lost >> i) & 1;
+          }
+
+          DeviceUpdate update;
+          update.info.setMAC(it->second);
+          update.info.setIP(result.ip);
+          update.reachable = result.reachable ? 1 : 0;
+          update.rtt_us = result.reachable ?
+            static_cast<int>(result.rtt.count()) : -1;
+          update.loss = lost*100/h.count;
+          update.reachability_only = true;
+
+          if (queue_.push(update))
+          {
+            wxThreadEvent event(wxEVT_COMMAND_DISCOVERY_UPDATE);
+            send(event);
+          }
+        }
+      });
+
+      lock.lock();
+      cv_.wait_until(lock, start + interval_, [this] { return stop_; });
+    }
+  }
+  catch(const std::exception &ex)
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (!stop_)
+    {
+      wxThreadEvent event(wxEVT_COMMAND_DISCOVERY_ERROR);
+      event.SetString(ex.what());
+      send(event);
+    }
+  }
+}
+
+void ReachabilityMonitor::send(wxThreadEvent &event)
+{
+  event.SetInt(GENERATION);
+  target_->post(event);
+}
@@ -0,0 +1,136 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef REACHABILITYMONITOR_H
+#define REACHABILITYMONITOR_H
+
+#include "device-queue.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+class wxThreadEvent;
+class EventTarget;
+
+namespace rcdiscover
+{
+class CancelToken;
+}
+
+/**
+ * @brief Pings the discovered rc_visards periodically in a background
+ * thread.
+ *
+ * Reachability, round trip time and the loss of the recent echo requests
+ * of each rc_visard are passed to a queue. All rc_visards are pinged at once
+ * by a single rcdiscover::Pinger.
+ *
+ * All events carry GENERATION instead of the generation number of a
+ * DiscoverThread. If pinging fails, monitoring stops after sending an error
+ * event.
+ */
+class ReachabilityMonitor
+{
+  public:
+    struct Device
+    {
+      uint64_t mac;
+      uint32_t ip;
+    };
+
+    /// number that is passed with all events of the monitor
+    static const int GENERATION = -1;
+
+    /**
+     * @brief Constructor, which starts the background thread.
+     * @param target receiver of the events about updates in the queue and
+     *               errors
+     * @param interval interval between two echo requests to the same
+     *                 rc_visard
+     */
+    explicit ReachabilityMonitor(std::shared_ptr<EventTarget> target,
+                                 std::chrono::milliseconds interval =
+                                   std::chrono::seconds(1));
+
+    /**
+     * @brief Destructor, which stops the background thread without waiting
+     * for outstanding echo replies.
+     */
+    ~ReachabilityMonitor();
+
+    ReachabilityMonitor(const ReachabilityMonitor &) = delete;
+    ReachabilityMonitor &operator=(const ReachabilityMonitor &) = delete;
+
+    /**
+     * @brief Sets the rc_visards that are pinged from the next interval on.
+     * @param devices MAC and IP address of rc_visards
+     */
+    void setDevices(std::vector<Device> devices);
+
+    /**
+     * @brief Returns the queue with the updates of the rc_visards.
+     * @return queue
+     */
+    DeviceQueue &getQueue() { return queue_; }
+
+  private:
+    void run();
+
+    /**
+     * @brief Sends an event with GENERATION.
+     * @param event event
+     */
+    void send(wxThreadEvent &event);
+
+    std::shared_ptr<EventTarget> target_;
+    std::chrono::milliseconds interval_;
+    DeviceQueue queue_;
+
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    bool stop_;
+    std::shared_ptr<rcdiscover::CancelToken> cancel_;
+    std::vector<Device> devices_;
+
+    std::thread thread_;
+};
+
+#endif // REACHABILITYMONITOR_H
@@ -39,12 +39,14 @@
 #include "reset-dialog.h"
 
 #include "event-ids.h"
+#include "device-list-model.h"
 #include "rcdiscover/utils.h"
 
 #include "rcdiscover/wol_exception.h"
 #include "rcdiscover/operation_not_permitted.h"
 
 #include <thread>
+#include <algorithm>
 
 #include <wx/dialog.h>
 #include <wx/panel.h>
@@ -54,7 +56,6 @@
 #include <wx/checkbox.h>
 #include <wx/stattext.h>
 #include <wx/button.h>
-#include <wx/dataview.h>
 #include <wx/msgdlg.h>
 #include <wx/valgen.h>
 #include <wx/html/helpctrl.h>
@@ -69,6 +70,7 @@ ResetDialog::ResetDialog(wxHtmlHelpController *help_ctrl,
   sensors_(nullptr),
   mac_{{nullptr, nullptr, nullptr, nullptr, nullptr, nullptr}},
   sensor_list_(nullptr),
+  sensor_list_changed_(false),
   help_ctrl_(help_ctrl)
 {
   auto *panel = new wxPanel(this, -1);
@@ -158,37 +160,107 @@ ResetDialog::ResetDialog(wxHtmlHelpController *help_ctrl,
           wxCommandEventHandler(ResetDialog::onHelpButton));
 }
 
-void ResetDialog::setDiscoveredSensors(const wxDataViewListModel *sensor_list)
+void ResetDialog::setDiscoveredSensors(const DeviceListModel *sensor_list)
 {
   sensor_list_ = sensor_list;
+  sensor_list_changed_ = true;
 
-  if (sensor_list != nullptr)
+  if (IsShown())
   {
-    sensors_->Clear();
+    updateSensors();
+  }
+}
+
+void ResetDialog::setActiveSensor(const uint64_t mac)
+{
+  updateSensors();
 
-    sensors_->Append("<Custom>");
+  const auto it = std::lower_bound(sensor_macs_.begin(), sensor_macs_.end(),
+                                   mac);
 
-    const auto rows = sensor_list->GetCount();
-    for (typename std::decay<decltype(rows)>::type i = 0; i < rows; ++i)
-    {
-      wxVariant hostname{};
-      wxVariant mac{};
-      sensor_list->GetValueByRow(hostname, i, 0);
-      sensor_list->GetValueByRow(mac, i, 3);
-      const auto s = wxString::Format("%s - %s",
-                                      hostname.GetString(),
-                                      mac.GetString());
-      sensors_->Append(s);
-    }
+  if (it != sensor_macs_.end() && *it == mac)
+  {
+    sensors_->Select(static_cast<int>(it - sensor_macs_.begin()) + 1);
+    fillMac();
+  }
+  else
+  {
+    clear();
   }
+}
 
-  clear();
+bool ResetDialog::Show(bool show)
+{
+  if (show)
+  {
+    updateSensors();
+  }
+
+  return wxDialog::Show(show);
 }
 
-void ResetDialog::setActiveSensor(const unsigned int row)
+void ResetDialog::updateSensors()
 {
-  sensors_->Select(static_cast<int>(row + 1));
-  fillMac();
+  if (!sensor_list_changed_)
+  {
+    return;
+  }
+
+  sensor_list_changed_ = false;
+
+  // the selected rc_visard stays selected if it is still in the list, and
+  // a custom MAC address is kept, since the list is refreshed periodically
+  // while the dialog may be open
+
+  const int row = sensors_->GetSelection() - 1;
+  const bool selected = (row >= 0 &&
+                         static_cast<size_t>(row) < sensor_macs_.size());
+  const uint64_t selected_mac = selected ? sensor_macs_[row] : 0;
+  const bool custom = (row == -1);
+
+  sensor_macs_.clear();
+
+  // all entries are set at once, since appending them one by one is slow
+
+  wxArrayString items;
+  items.Add("<Custom>");
+
+  if (sensor_list_ != nullptr)
+  {
+    const size_t n = sensor_list_->getDeviceCount();
+
+    items.Alloc(n + 1);
+    sensor_macs_.reserve(n);
+
+    for (size_t i = 0; i < n; i++)
+    {
+      const uint64_t mac = sensor_list_->getDeviceMAC(i);
+      items.Add(sensor_list_->getDeviceName(i) + " - " + mac2string(mac));
+      sensor_macs_.push_back(mac);
+    }
+  }
+
+  sensors_->Set(items);
+
+  if (selected)
+  {
+    const auto it = std::lower_bound(sensor_macs_.begin(),
+                                     sensor_macs_.end(), selected_mac);
+
+    if (it != sensor_macs_.end() && *it == selected_mac)
+    {
+      sensors_->Select(static_cast<int>(it - sensor_macs_.begin()) + 1);
+      return;
+    }
+  }
+
+  if (custom)
+  {
+    sensors_->SetSelection(0);
+    return;
+  }
+
+  clear();
 }
 
 void ResetDialog::onSensorSelected(wxCommandEvent &)
@@ -330,15 +402,12 @@ void ResetDialog::fillMac()
 {
   const int row = sensors_->GetSelection() - 1;
 
-  if (row == wxNOT_FOUND)
+  if (row < 0 || static_cast<size_t>(row) >= sensor_macs_.size())
   {
     return;
   }
 
-  wxVariant mac_string{};
-  sensor_list_->GetValueByRow(mac_string, static_cast<unsigned int>(row), 3);
-
-  const auto mac = split<6>(mac_string.GetString().ToStdString(), ':');
+  const auto mac = split<6>(mac2string(sensor_macs_[row]), ':');
 
   for (uint8_t i = 0; i < 6; ++i)
   {
@@ -37,13 +37,15 @@
 #define RESETDIALOG_H
 
 #include <array>
+#include <vector>
+#include <cstdint>
 
 #include <wx/dialog.h>
 
 class wxChoice;
 class wxCheckBox;
 class wxTextCtrl;
-class wxDataViewListModel;
+class DeviceListModel;
 class wxHtmlHelpController;
 
 /**
@@ -65,17 +67,20 @@ class ResetDialog : public wxDialog
 
     /**
      * @brief Set list of discovered rc_visards to provide a drop down menu
-     * to the user.
+     * to the user. The drop down menu is only filled when the dialog is
+     * shown.
      * @param sensor_list list of rc_visards
      */
-    void setDiscoveredSensors(const wxDataViewListModel *sensor_list);
+    void setDiscoveredSensors(const DeviceListModel *sensor_list);
 
     /**
      * @brief Select a specific rc_visard of the list set by
      * setDiscoveredSensors.
-     * @param row row of rc_visard list
+     * @param mac MAC address of rc_visard
      */
-    void setActiveSensor(const unsigned int row);
+    void setActiveSensor(uint64_t mac);
+
+    virtual bool Show(bool show = true) override;
 
   private:
     /**
@@ -95,6 +100,12 @@ class ResetDialog : public wxDialog
      */
     void onHelpButton(wxCommandEvent &);
 
+    /**
+     * @brief Fills the drop down menu if the list of rc_visards has changed.
+     * The selection is kept if the selected rc_visard is still in the list.
+     */
+    void updateSensors();
+
     /**
      * @brief Reset and clear all fields.
      */
@@ -111,7 +122,9 @@ class ResetDialog : public wxDialog
     wxChoice *sensors_;
     std::array<wxTextCtrl *, 6> mac_;
 
-    const wxDataViewListModel *sensor_list_;
+    const DeviceListModel *sensor_list_;
+    bool sensor_list_changed_;
+    std::vector<uint64_t> sensor_macs_; // MAC address per drop down entry
 
     wxHtmlHelpController *help_ctrl_;
 };
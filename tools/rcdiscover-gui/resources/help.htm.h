@@ -1,8 +1,8 @@
 /* Generated by bin2c, do not edit manually */
 
 /* Contents of file help.htm */
-const long int help_htm_size = 2493;
-const unsigned char help_htm[2493] = {
+const long int help_htm_size = 2987;
+const unsigned char help_htm[2987] = {
     0x3C, 0x21, 0x44, 0x4F, 0x43, 0x54, 0x59, 0x50, 0x45, 0x20, 0x48, 0x54, 0x4D, 0x4C, 0x20, 0x50,
     0x55, 0x42, 0x4C, 0x49, 0x43, 0x20, 0x22, 0x2D, 0x2F, 0x2F, 0x49, 0x45, 0x54, 0x46, 0x2F, 0x2F,
     0x44, 0x54, 0x44, 0x20, 0x48, 0x54, 0x4D, 0x4C, 0x2F, 0x2F, 0x45, 0x4E, 0x22, 0x3E, 0x0D, 0x0A,
@@ -60,103 +60,134 @@ const unsigned char help_htm[2493] = {
     0x73, 0x63, 0x61, 0x6E, 0x20, 0x63, 0x61, 0x6E, 0x20, 0x62, 0x65, 0x20, 0x69, 0x6E, 0x69, 0x74,
     0x69, 0x61, 0x74, 0x65, 0x64, 0x20, 0x62, 0x79, 0x20, 0x63, 0x6C, 0x69, 0x63, 0x6B, 0x69, 0x6E,
     0x67, 0x20, 0x6F, 0x6E, 0x20, 0x3C, 0x65, 0x6D, 0x3E, 0x52, 0x65, 0x72, 0x75, 0x6E, 0x20, 0x44,
-    0x69, 0x73, 0x63, 0x6F, 0x76, 0x65, 0x72, 0x79, 0x3C, 0x2F, 0x65, 0x6D, 0x3E, 0x3C, 0x2F, 0x70,
-    0x3E, 0x0D, 0x0A, 0x0D, 0x0A, 0x3C, 0x70, 0x3E, 0x41, 0x66, 0x74, 0x65, 0x72, 0x20, 0x73, 0x75,
-    0x63, 0x63, 0x65, 0x73, 0x73, 0x66, 0x75, 0x6C, 0x20, 0x64, 0x69, 0x73, 0x63, 0x6F, 0x76, 0x65,
-    0x72, 0x79, 0x2C, 0x20, 0x61, 0x20, 0x64, 0x6F, 0x75, 0x62, 0x6C, 0x65, 0x20, 0x63, 0x6C, 0x69,
-    0x63, 0x6B, 0x20, 0x6F, 0x6E, 0x20, 0x74, 0x68, 0x65, 0x20, 0x64, 0x65, 0x76, 0x69, 0x63, 0x65,
-    0x20, 0x72, 0x6F, 0x77, 0x20, 0x6F, 0x70, 0x65, 0x6E, 0x73, 0x20, 0x74, 0x68, 0x65, 0x20, 0x57,
-    0x65, 0x62, 0x20, 0x47, 0x55, 0x49, 0x20, 0x6F, 0x66, 0x20, 0x74, 0x68, 0x65, 0x20, 0x64, 0x65,
-    0x76, 0x69, 0x63, 0x65, 0x20, 0x69, 0x6E, 0x0D, 0x0A, 0x74, 0x68, 0x65, 0x20, 0x64, 0x65, 0x66,
-    0x61, 0x75, 0x6C, 0x74, 0x20, 0x77, 0x65, 0x62, 0x20, 0x62, 0x72, 0x6F, 0x77, 0x73, 0x65, 0x72,
-    0x20, 0x6F, 0x66, 0x20, 0x74, 0x68, 0x65, 0x20, 0x6F, 0x70, 0x65, 0x72, 0x61, 0x74, 0x69, 0x6E,
-    0x67, 0x20, 0x73, 0x79, 0x73, 0x74, 0x65, 0x6D, 0x2E, 0x3C, 0x2F, 0x70, 0x3E, 0x0D, 0x0A, 0x0D,
-    0x0A, 0x3C, 0x48, 0x32, 0x3E, 0x3C, 0x61, 0x20, 0x6E, 0x61, 0x6D, 0x65, 0x3D, 0x22, 0x72, 0x65,
-    0x73, 0x65, 0x74, 0x22, 0x20, 0x69, 0x64, 0x3D, 0x22, 0x72, 0x65, 0x73, 0x65, 0x74, 0x22, 0x3E,
-    0x52, 0x65, 0x73, 0x65, 0x74, 0x74, 0x69, 0x6E, 0x67, 0x20, 0x63, 0x6F, 0x6E, 0x66, 0x69, 0x67,
-    0x75, 0x72, 0x61, 0x74, 0x69, 0x6F, 0x6E, 0x3C, 0x2F, 0x61, 0x3E, 0x3C, 0x2F, 0x48, 0x32, 0x3E,
-    0x0D, 0x0A, 0x0D, 0x0A, 0x3C, 0x70, 0x3E, 0x41, 0x20, 0x6D, 0x69, 0x73, 0x63, 0x6F, 0x6E, 0x66,
-    0x69, 0x67, 0x75, 0x72, 0x65, 0x64, 0x20, 0x64, 0x65, 0x76, 0x69, 0x63, 0x65, 0x20, 0x63, 0x61,
-    0x6E, 0x20, 0x62, 0x65, 0x20, 0x72, 0x65, 0x73, 0x65, 0x74, 0x20, 0x62, 0x79, 0x20, 0x75, 0x73,
-    0x69, 0x6E, 0x67, 0x20, 0x74, 0x68, 0x65, 0x20, 0x3C, 0x65, 0x6D, 0x3E, 0x52, 0x65, 0x73, 0x65,
-    0x74, 0x20, 0x72, 0x63, 0x5F, 0x76, 0x69, 0x73, 0x61, 0x72, 0x64, 0x3C, 0x2F, 0x65, 0x6D, 0x3E,
-    0x20, 0x62, 0x75, 0x74, 0x74, 0x6F, 0x6E, 0x20, 0x69, 0x6E, 0x20, 0x74, 0x68, 0x65, 0x0D, 0x0A,
-    0x64, 0x69, 0x73, 0x63, 0x6F, 0x76, 0x65, 0x72, 0x79, 0x20, 0x74, 0x6F, 0x6F, 0x6C, 0x2E, 0x20,
-    0x54, 0x68, 0x65, 0x20, 0x72, 0x65, 0x73, 0x65, 0x74, 0x20, 0x6D, 0x65, 0x63, 0x68, 0x61, 0x6E,
-    0x69, 0x73, 0x6D, 0x20, 0x69, 0x73, 0x20, 0x6F, 0x6E, 0x6C, 0x79, 0x20, 0x61, 0x76, 0x61, 0x69,
-    0x6C, 0x61, 0x62, 0x6C, 0x65, 0x20, 0x66, 0x6F, 0x72, 0x20, 0x74, 0x77, 0x6F, 0x20, 0x6D, 0x69,
-    0x6E, 0x75, 0x74, 0x65, 0x73, 0x0D, 0x0A, 0x61, 0x66, 0x74, 0x65, 0x72, 0x20, 0x64, 0x65, 0x76,
-    0x69, 0x63, 0x65, 0x20, 0x73, 0x74, 0x61, 0x72, 0x74, 0x75, 0x70, 0x2E, 0x20, 0x54, 0x68, 0x75,
-    0x73, 0x2C, 0x20, 0x61, 0x20, 0x72, 0x65, 0x62, 0x6F, 0x6F, 0x74, 0x20, 0x6F, 0x66, 0x20, 0x74,
-    0x68, 0x65, 0x20, 0x3C, 0x65, 0x6D, 0x3E, 0x72, 0x63, 0x5F, 0x76, 0x69, 0x73, 0x61, 0x72, 0x64,
-    0x3C, 0x2F, 0x65, 0x6D, 0x3E, 0x20, 0x6D, 0x61, 0x79, 0x20, 0x62, 0x65, 0x20, 0x72, 0x65, 0x71,
-    0x75, 0x69, 0x72, 0x65, 0x64, 0x20, 0x62, 0x65, 0x66, 0x6F, 0x72, 0x65, 0x0D, 0x0A, 0x62, 0x65,
-    0x69, 0x6E, 0x67, 0x20, 0x61, 0x62, 0x6C, 0x65, 0x20, 0x74, 0x6F, 0x20, 0x72, 0x65, 0x73, 0x65,
-    0x74, 0x20, 0x74, 0x68, 0x65, 0x20, 0x64, 0x65, 0x76, 0x69, 0x63, 0x65, 0x2E, 0x3C, 0x2F, 0x70,
-    0x3E, 0x0D, 0x0A, 0x0D, 0x0A, 0x3C, 0x70, 0x3E, 0x49, 0x66, 0x20, 0x74, 0x68, 0x65, 0x20, 0x6D,
-    0x69, 0x73, 0x63, 0x6F, 0x6E, 0x66, 0x69, 0x67, 0x75, 0x72, 0x65, 0x64, 0x20, 0x3C, 0x65, 0x6D,
-    0x3E, 0x72, 0x63, 0x5F, 0x76, 0x69, 0x73, 0x61, 0x72, 0x64, 0x3C, 0x2F, 0x65, 0x6D, 0x3E, 0x20,
-    0x69, 0x73, 0x20, 0x73, 0x74, 0x69, 0x6C, 0x6C, 0x20, 0x73, 0x75, 0x63, 0x63, 0x65, 0x73, 0x73,
-    0x66, 0x75, 0x6C, 0x6C, 0x79, 0x20, 0x64, 0x65, 0x74, 0x65, 0x63, 0x74, 0x65, 0x64, 0x20, 0x62,
-    0x79, 0x20, 0x74, 0x68, 0x65, 0x20, 0x64, 0x69, 0x73, 0x63, 0x6F, 0x76, 0x65, 0x72, 0x79, 0x0D,
-    0x0A, 0x74, 0x6F, 0x6F, 0x6C, 0x2C, 0x20, 0x69, 0x74, 0x20, 0x63, 0x61, 0x6E, 0x20, 0x62, 0x65,
-    0x20, 0x73, 0x65, 0x6C, 0x65, 0x63, 0x74, 0x65, 0x64, 0x20, 0x66, 0x72, 0x6F, 0x6D, 0x20, 0x74,
-    0x68, 0x65, 0x20, 0x3C, 0x65, 0x6D, 0x3E, 0x72, 0x63, 0x5F, 0x76, 0x69, 0x73, 0x61, 0x72, 0x64,
-    0x3C, 0x2F, 0x65, 0x6D, 0x3E, 0x20, 0x64, 0x72, 0x6F, 0x70, 0x20, 0x64, 0x6F, 0x77, 0x6E, 0x20,
-    0x6D, 0x65, 0x6E, 0x75, 0x2E, 0x20, 0x4F, 0x74, 0x68, 0x65, 0x72, 0x77, 0x69, 0x73, 0x65, 0x2C,
-    0x0D, 0x0A, 0x74, 0x68, 0x65, 0x20, 0x3C, 0x65, 0x6D, 0x3E, 0x72, 0x63, 0x5F, 0x76, 0x69, 0x73,
-    0x61, 0x72, 0x64, 0x3C, 0x2F, 0x65, 0x6D, 0x3E, 0x27, 0x73, 0x20, 0x4D, 0x41, 0x43, 0x20, 0x61,
-    0x64, 0x64, 0x72, 0x65, 0x73, 0x73, 0x2C, 0x20, 0x77, 0x68, 0x69, 0x63, 0x68, 0x20, 0x69, 0x73,
-    0x20, 0x70, 0x72, 0x69, 0x6E, 0x74, 0x65, 0x64, 0x20, 0x6F, 0x6E, 0x20, 0x74, 0x68, 0x65, 0x20,
-    0x64, 0x65, 0x76, 0x69, 0x63, 0x65, 0x20, 0x6C, 0x61, 0x62, 0x65, 0x6C, 0x2C, 0x20, 0x63, 0x61,
-    0x6E, 0x20, 0x62, 0x65, 0x20, 0x65, 0x6E, 0x74, 0x65, 0x72, 0x65, 0x64, 0x0D, 0x0A, 0x6D, 0x61,
-    0x6E, 0x75, 0x61, 0x6C, 0x6C, 0x79, 0x20, 0x69, 0x6E, 0x20, 0x74, 0x68, 0x65, 0x20, 0x64, 0x65,
-    0x73, 0x69, 0x67, 0x6E, 0x61, 0x74, 0x65, 0x64, 0x20, 0x66, 0x69, 0x65, 0x6C, 0x64, 0x73, 0x2E,
-    0x3C, 0x2F, 0x70, 0x3E, 0x0D, 0x0A, 0x0D, 0x0A, 0x3C, 0x70, 0x3E, 0x41, 0x66, 0x74, 0x65, 0x72,
-    0x20, 0x65, 0x6E, 0x74, 0x65, 0x72, 0x69, 0x6E, 0x67, 0x20, 0x74, 0x68, 0x65, 0x20, 0x4D, 0x41,
-    0x43, 0x20, 0x61, 0x64, 0x64, 0x72, 0x65, 0x73, 0x73, 0x20, 0x6F, 0x6E, 0x65, 0x20, 0x6F, 0x66,
-    0x20, 0x66, 0x6F, 0x75, 0x72, 0x20, 0x6F, 0x70, 0x74, 0x69, 0x6F, 0x6E, 0x73, 0x20, 0x63, 0x61,
-    0x6E, 0x20, 0x62, 0x65, 0x20, 0x63, 0x68, 0x6F, 0x73, 0x65, 0x6E, 0x3A, 0x3C, 0x2F, 0x70, 0x3E,
-    0x0D, 0x0A, 0x0D, 0x0A, 0x3C, 0x70, 0x3E, 0x0D, 0x0A, 0x3C, 0x75, 0x6C, 0x3E, 0x0D, 0x0A, 0x3C,
-    0x6C, 0x69, 0x3E, 0x3C, 0x65, 0x6D, 0x3E, 0x52, 0x65, 0x73, 0x65, 0x74, 0x20, 0x50, 0x61, 0x72,
-    0x61, 0x6D, 0x65, 0x74, 0x65, 0x72, 0x73, 0x3C, 0x2F, 0x65, 0x6D, 0x3E, 0x3A, 0x20, 0x52, 0x65,
-    0x73, 0x65, 0x74, 0x20, 0x61, 0x6C, 0x6C, 0x20, 0x3C, 0x65, 0x6D, 0x3E, 0x72, 0x63, 0x5F, 0x76,
-    0x69, 0x73, 0x61, 0x72, 0x64, 0x3C, 0x2F, 0x65, 0x6D, 0x3E, 0x20, 0x70, 0x61, 0x72, 0x61, 0x6D,
-    0x65, 0x74, 0x65, 0x72, 0x73, 0x20, 0x74, 0x68, 0x61, 0x74, 0x20, 0x61, 0x72, 0x65, 0x20, 0x63,
-    0x6F, 0x6E, 0x66, 0x69, 0x67, 0x75, 0x72, 0x61, 0x62, 0x6C, 0x65, 0x20, 0x76, 0x69, 0x61, 0x20,
-    0x74, 0x68, 0x65, 0x20, 0x57, 0x65, 0x62, 0x20, 0x47, 0x55, 0x49, 0x20, 0x28, 0x65, 0x2E, 0x67,
-    0x2E, 0x2C, 0x20, 0x66, 0x72, 0x61, 0x6D, 0x65, 0x20, 0x72, 0x61, 0x74, 0x65, 0x29, 0x2E, 0x3C,
-    0x2F, 0x6C, 0x69, 0x3E, 0x0D, 0x0A, 0x3C, 0x6C, 0x69, 0x3E, 0x3C, 0x65, 0x6D, 0x3E, 0x52, 0x65,
-    0x73, 0x65, 0x74, 0x20, 0x4E, 0x65, 0x74, 0x77, 0x6F, 0x72, 0x6B, 0x3C, 0x2F, 0x65, 0x6D, 0x3E,
-    0x3A, 0x20, 0x52, 0x65, 0x73, 0x65, 0x74, 0x20, 0x6E, 0x65, 0x74, 0x77, 0x6F, 0x72, 0x6B, 0x20,
-    0x73, 0x65, 0x74, 0x74, 0x69, 0x6E, 0x67, 0x73, 0x20, 0x61, 0x6E, 0x64, 0x20, 0x75, 0x73, 0x65,
-    0x72, 0x20, 0x64, 0x65, 0x66, 0x69, 0x6E, 0x65, 0x64, 0x20, 0x6E, 0x61, 0x6D, 0x65, 0x2E, 0x3C,
-    0x2F, 0x6C, 0x69, 0x3E, 0x0D, 0x0A, 0x3C, 0x6C, 0x69, 0x3E, 0x3C, 0x65, 0x6D, 0x3E, 0x52, 0x65,
-    0x73, 0x65, 0x74, 0x20, 0x41, 0x6C, 0x6C, 0x3C, 0x2F, 0x65, 0x6D, 0x3E, 0x3A, 0x20, 0x52, 0x65,
-    0x73, 0x65, 0x74, 0x20, 0x3C, 0x65, 0x6D, 0x3E, 0x72, 0x63, 0x5F, 0x76, 0x69, 0x73, 0x61, 0x72,
-    0x64, 0x3C, 0x2F, 0x65, 0x6D, 0x3E, 0x20, 0x70, 0x61, 0x72, 0x61, 0x6D, 0x65, 0x74, 0x65, 0x72,
-    0x73, 0x20, 0x61, 0x73, 0x20, 0x77, 0x65, 0x6C, 0x6C, 0x20, 0x61, 0x73, 0x20, 0x6E, 0x65, 0x74,
-    0x77, 0x6F, 0x72, 0x6B, 0x20, 0x73, 0x65, 0x74, 0x74, 0x69, 0x6E, 0x67, 0x73, 0x20, 0x61, 0x6E,
-    0x64, 0x20, 0x75, 0x73, 0x65, 0x72, 0x20, 0x64, 0x65, 0x66, 0x69, 0x6E, 0x65, 0x64, 0x20, 0x6E,
-    0x61, 0x6D, 0x65, 0x2E, 0x3C, 0x2F, 0x6C, 0x69, 0x3E, 0x0D, 0x0A, 0x3C, 0x6C, 0x69, 0x3E, 0x3C,
-    0x65, 0x6D, 0x3E, 0x53, 0x77, 0x69, 0x74, 0x63, 0x68, 0x20, 0x50, 0x61, 0x72, 0x74, 0x69, 0x74,
-    0x69, 0x6F, 0x6E, 0x73, 0x3C, 0x2F, 0x65, 0x6D, 0x3E, 0x3A, 0x20, 0x41, 0x6C, 0x6C, 0x6F, 0x77,
-    0x73, 0x20, 0x74, 0x6F, 0x20, 0x70, 0x65, 0x72, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x61, 0x20, 0x72,
-    0x6F, 0x6C, 0x6C, 0x62, 0x61, 0x63, 0x6B, 0x20, 0x74, 0x6F, 0x20, 0x74, 0x68, 0x65, 0x20, 0x70,
-    0x72, 0x65, 0x76, 0x69, 0x6F, 0x75, 0x73, 0x20, 0x66, 0x69, 0x72, 0x6D, 0x77, 0x61, 0x72, 0x65,
-    0x2E, 0x3C, 0x2F, 0x6C, 0x69, 0x3E, 0x0D, 0x0A, 0x3C, 0x75, 0x6C, 0x3E, 0x0D, 0x0A, 0x3C, 0x2F,
-    0x70, 0x3E, 0x0D, 0x0A, 0x0D, 0x0A, 0x3C, 0x70, 0x3E, 0x0D, 0x0A, 0x41, 0x20, 0x73, 0x75, 0x63,
-    0x63, 0x65, 0x73, 0x73, 0x66, 0x75, 0x6C, 0x20, 0x72, 0x65, 0x73, 0x65, 0x74, 0x20, 0x69, 0x73,
-    0x20, 0x69, 0x6E, 0x64, 0x69, 0x63, 0x61, 0x74, 0x65, 0x64, 0x20, 0x62, 0x79, 0x20, 0x61, 0x20,
-    0x77, 0x68, 0x69, 0x74, 0x65, 0x20, 0x73, 0x74, 0x61, 0x74, 0x75, 0x73, 0x20, 0x4C, 0x45, 0x44,
-    0x20, 0x66, 0x6F, 0x6C, 0x6C, 0x6F, 0x77, 0x65, 0x64, 0x20, 0x62, 0x79, 0x20, 0x61, 0x20, 0x64,
-    0x65, 0x76, 0x69, 0x63, 0x65, 0x20, 0x72, 0x65, 0x62, 0x6F, 0x6F, 0x74, 0x2E, 0x0D, 0x0A, 0x49,
-    0x66, 0x20, 0x6E, 0x6F, 0x20, 0x72, 0x65, 0x61, 0x63, 0x74, 0x69, 0x6F, 0x6E, 0x20, 0x69, 0x73,
-    0x20, 0x6E, 0x6F, 0x74, 0x69, 0x63, 0x61, 0x62, 0x6C, 0x65, 0x2C, 0x20, 0x74, 0x68, 0x65, 0x20,
-    0x74, 0x77, 0x6F, 0x20, 0x6D, 0x69, 0x6E, 0x75, 0x74, 0x65, 0x73, 0x20, 0x74, 0x69, 0x6D, 0x65,
-    0x20, 0x73, 0x6C, 0x6F, 0x74, 0x20, 0x6D, 0x61, 0x79, 0x20, 0x68, 0x61, 0x76, 0x65, 0x20, 0x70,
-    0x61, 0x73, 0x73, 0x65, 0x64, 0x2C, 0x20, 0x72, 0x65, 0x71, 0x75, 0x69, 0x72, 0x69, 0x6E, 0x67,
-    0x0D, 0x0A, 0x61, 0x6E, 0x6F, 0x74, 0x68, 0x65, 0x72, 0x20, 0x72, 0x65, 0x62, 0x6F, 0x6F, 0x74,
-    0x2E, 0x0D, 0x0A, 0x3C, 0x2F, 0x70, 0x3E, 0x0D, 0x0A, 0x0D, 0x0A, 0x3C, 0x2F, 0x42, 0x4F, 0x44,
-    0x59, 0x3E, 0x0D, 0x0A, 0x3C, 0x2F, 0x48, 0x54, 0x4D, 0x4C, 0x3E, 0x0D, 0x0A
+    0x69, 0x73, 0x63, 0x6F, 0x76, 0x65, 0x72, 0x79, 0x3C, 0x2F, 0x65, 0x6D, 0x3E, 0x2C, 0x20, 0x77,
+    0x68, 0x69, 0x63, 0x68, 0x20, 0x61, 0x6C, 0x73, 0x6F, 0x0D, 0x0A, 0x72, 0x65, 0x73, 0x74, 0x61,
+    0x72, 0x74, 0x73, 0x20, 0x61, 0x20, 0x73, 0x63, 0x61, 0x6E, 0x20, 0x74, 0x68, 0x61, 0x74, 0x20,
+    0x69, 0x73, 0x20, 0x73, 0x74, 0x69, 0x6C, 0x6C, 0x20, 0x72, 0x75, 0x6E, 0x6E, 0x69, 0x6E, 0x67,
+    0x2E, 0x20, 0x49, 0x66, 0x20, 0x3C, 0x65, 0x6D, 0x3E, 0x41, 0x75, 0x74, 0x6F, 0x20, 0x72, 0x65,
+    0x66, 0x72, 0x65, 0x73, 0x68, 0x3C, 0x2F, 0x65, 0x6D, 0x3E, 0x20, 0x69, 0x73, 0x20, 0x63, 0x68,
+    0x65, 0x63, 0x6B, 0x65, 0x64, 0x2C, 0x20, 0x74, 0x68, 0x65, 0x20, 0x73, 0x63, 0x61, 0x6E, 0x20,
+    0x69, 0x73, 0x0D, 0x0A, 0x72, 0x65, 0x70, 0x65, 0x61, 0x74, 0x65, 0x64, 0x20, 0x65, 0x76, 0x65,
+    0x72, 0x79, 0x20, 0x31, 0x30, 0x20, 0x73, 0x65, 0x63, 0x6F, 0x6E, 0x64, 0x73, 0x2E, 0x3C, 0x2F,
+    0x70, 0x3E, 0x0D, 0x0A, 0x0D, 0x0A, 0x3C, 0x70, 0x3E, 0x41, 0x66, 0x74, 0x65, 0x72, 0x20, 0x73,
+    0x75, 0x63, 0x63, 0x65, 0x73, 0x73, 0x66, 0x75, 0x6C, 0x20, 0x64, 0x69, 0x73, 0x63, 0x6F, 0x76,
+    0x65, 0x72, 0x79, 0x2C, 0x20, 0x61, 0x20, 0x64, 0x6F, 0x75, 0x62, 0x6C, 0x65, 0x20, 0x63, 0x6C,
+    0x69, 0x63, 0x6B, 0x20, 0x6F, 0x6E, 0x20, 0x74, 0x68, 0x65, 0x20, 0x64, 0x65, 0x76, 0x69, 0x63,
+    0x65, 0x20, 0x72, 0x6F, 0x77, 0x20, 0x6F, 0x70, 0x65, 0x6E, 0x73, 0x20, 0x74, 0x68, 0x65, 0x20,
+    0x57, 0x65, 0x62, 0x20, 0x47, 0x55, 0x49, 0x20, 0x6F, 0x66, 0x20, 0x74, 0x68, 0x65, 0x20, 0x64,
+    0x65, 0x76, 0x69, 0x63, 0x65, 0x20, 0x69, 0x6E, 0x0D, 0x0A, 0x74, 0x68, 0x65, 0x20, 0x64, 0x65,
+    0x66, 0x61, 0x75, 0x6C, 0x74, 0x20, 0x77, 0x65, 0x62, 0x20, 0x62, 0x72, 0x6F, 0x77, 0x73, 0x65,
+    0x72, 0x20, 0x6F, 0x66, 0x20, 0x74, 0x68, 0x65, 0x20, 0x6F, 0x70, 0x65, 0x72, 0x61, 0x74, 0x69,
+    0x6E, 0x67, 0x20, 0x73, 0x79, 0x73, 0x74, 0x65, 0x6D, 0x2E, 0x3C, 0x2F, 0x70, 0x3E, 0x0D, 0x0A,
+    0x0D, 0x0A, 0x3C, 0x70, 0x3E, 0x41, 0x20, 0x63, 0x6C, 0x69, 0x63, 0x6B, 0x20, 0x6F, 0x6E, 0x20,
+    0x61, 0x20, 0x63, 0x6F, 0x6C, 0x75, 0x6D, 0x6E, 0x20, 0x68, 0x65, 0x61, 0x64, 0x65, 0x72, 0x20,
+    0x73, 0x6F, 0x72, 0x74, 0x73, 0x20, 0x74, 0x68, 0x65, 0x20, 0x74, 0x61, 0x62, 0x6C, 0x65, 0x20,
+    0x62, 0x79, 0x20, 0x74, 0x68, 0x69, 0x73, 0x20, 0x63, 0x6F, 0x6C, 0x75, 0x6D, 0x6E, 0x2E, 0x20,
+    0x4F, 0x6E, 0x6C, 0x79, 0x20, 0x64, 0x65, 0x76, 0x69, 0x63, 0x65, 0x73, 0x20, 0x77, 0x68, 0x6F,
+    0x73, 0x65, 0x20, 0x6E, 0x61, 0x6D, 0x65, 0x2C, 0x20, 0x73, 0x65, 0x72, 0x69, 0x61, 0x6C, 0x0D,
+    0x0A, 0x6E, 0x75, 0x6D, 0x62, 0x65, 0x72, 0x2C, 0x20, 0x49, 0x50, 0x20, 0x6F, 0x72, 0x20, 0x4D,
+    0x41, 0x43, 0x20, 0x61, 0x64, 0x64, 0x72, 0x65, 0x73, 0x73, 0x20, 0x63, 0x6F, 0x6E, 0x74, 0x61,
+    0x69, 0x6E, 0x20, 0x74, 0x68, 0x65, 0x20, 0x74, 0x65, 0x78, 0x74, 0x20, 0x69, 0x6E, 0x20, 0x74,
+    0x68, 0x65, 0x20, 0x66, 0x69, 0x6C, 0x74, 0x65, 0x72, 0x20, 0x66, 0x69, 0x65, 0x6C, 0x64, 0x20,
+    0x61, 0x62, 0x6F, 0x76, 0x65, 0x20, 0x74, 0x68, 0x65, 0x20, 0x74, 0x61, 0x62, 0x6C, 0x65, 0x20,
+    0x61, 0x72, 0x65, 0x20, 0x6C, 0x69, 0x73, 0x74, 0x65, 0x64, 0x2E, 0x3C, 0x2F, 0x70, 0x3E, 0x0D,
+    0x0A, 0x0D, 0x0A, 0x3C, 0x70, 0x3E, 0x49, 0x66, 0x20, 0x3C, 0x65, 0x6D, 0x3E, 0x4D, 0x6F, 0x6E,
+    0x69, 0x74, 0x6F, 0x72, 0x3C, 0x2F, 0x65, 0x6D, 0x3E, 0x20, 0x69, 0x73, 0x20, 0x63, 0x68, 0x65,
+    0x63, 0x6B, 0x65, 0x64, 0x2C, 0x20, 0x61, 0x6C, 0x6C, 0x20, 0x64, 0x65, 0x76, 0x69, 0x63, 0x65,
+    0x73, 0x20, 0x61, 0x72, 0x65, 0x20, 0x70, 0x69, 0x6E, 0x67, 0x65, 0x64, 0x20, 0x65, 0x76, 0x65,
+    0x72, 0x79, 0x20, 0x73, 0x65, 0x63, 0x6F, 0x6E, 0x64, 0x20, 0x61, 0x6E, 0x64, 0x20, 0x74, 0x68,
+    0x65, 0x20, 0x72, 0x6F, 0x75, 0x6E, 0x64, 0x20, 0x74, 0x72, 0x69, 0x70, 0x20, 0x74, 0x69, 0x6D,
+    0x65, 0x0D, 0x0A, 0x61, 0x73, 0x20, 0x77, 0x65, 0x6C, 0x6C, 0x20, 0x61, 0x73, 0x20, 0x74, 0x68,
+    0x65, 0x20, 0x6C, 0x6F, 0x73, 0x73, 0x20, 0x6F, 0x66, 0x20, 0x74, 0x68, 0x65, 0x20, 0x6C, 0x61,
+    0x73, 0x74, 0x20, 0x74, 0x65, 0x6E, 0x20, 0x70, 0x69, 0x6E, 0x67, 0x73, 0x20, 0x61, 0x72, 0x65,
+    0x20, 0x73, 0x68, 0x6F, 0x77, 0x6E, 0x20, 0x66, 0x6F, 0x72, 0x20, 0x65, 0x61, 0x63, 0x68, 0x20,
+    0x64, 0x65, 0x76, 0x69, 0x63, 0x65, 0x2E, 0x3C, 0x2F, 0x70, 0x3E, 0x0D, 0x0A, 0x0D, 0x0A, 0x3C,
+    0x48, 0x32, 0x3E, 0x3C, 0x61, 0x20, 0x6E, 0x61, 0x6D, 0x65, 0x3D, 0x22, 0x72, 0x65, 0x73, 0x65,
+    0x74, 0x22, 0x20, 0x69, 0x64, 0x3D, 0x22, 0x72, 0x65, 0x73, 0x65, 0x74, 0x22, 0x3E, 0x52, 0x65,
+    0x73, 0x65, 0x74, 0x74, 0x69, 0x6E, 0x67, 0x20, 0x63, 0x6F, 0x6E, 0x66, 0x69, 0x67, 0x75, 0x72,
+    0x61, 0x74, 0x69, 0x6F, 0x6E, 0x3C, 0x2F, 0x61, 0x3E, 0x3C, 0x2F, 0x48, 0x32, 0x3E, 0x0D, 0x0A,
+    0x0D, 0x0A, 0x3C, 0x70, 0x3E, 0x41, 0x20, 0x6D, 0x69, 0x73, 0x63, 0x6F, 0x6E, 0x66, 0x69, 0x67,
+    0x75, 0x72, 0x65, 0x64, 0x20, 0x64, 0x65, 0x76, 0x69, 0x63, 0x65, 0x20, 0x63, 0x61, 0x6E, 0x20,
+    0x62, 0x65, 0x20, 0x72, 0x65, 0x73, 0x65, 0x74, 0x20, 0x62, 0x79, 0x20, 0x75, 0x73, 0x69, 0x6E,
+    0x67, 0x20, 0x74, 0x68, 0x65, 0x20, 0x3C, 0x65, 0x6D, 0x3E, 0x52, 0x65, 0x73, 0x65, 0x74, 0x20,
+    0x72, 0x63, 0x5F, 0x76, 0x69, 0x73, 0x61, 0x72, 0x64, 0x3C, 0x2F, 0x65, 0x6D, 0x3E, 0x20, 0x62,
+    0x75, 0x74, 0x74, 0x6F, 0x6E, 0x20, 0x69, 0x6E, 0x20, 0x74, 0x68, 0x65, 0x0D, 0x0A, 0x64, 0x69,
+    0x73, 0x63, 0x6F, 0x76, 0x65, 0x72, 0x79, 0x20, 0x74, 0x6F, 0x6F, 0x6C, 0x2E, 0x20, 0x54, 0x68,
+    0x65, 0x20, 0x72, 0x65, 0x73, 0x65, 0x74, 0x20, 0x6D, 0x65, 0x63, 0x68, 0x61, 0x6E, 0x69, 0x73,
+    0x6D, 0x20, 0x69, 0x73, 0x20, 0x6F, 0x6E, 0x6C, 0x79, 0x20, 0x61, 0x76, 0x61, 0x69, 0x6C, 0x61,
+    0x62, 0x6C, 0x65, 0x20, 0x66, 0x6F, 0x72, 0x20, 0x74, 0x77, 0x6F, 0x20, 0x6D, 0x69, 0x6E, 0x75,
+    0x74, 0x65, 0x73, 0x0D, 0x0A, 0x61, 0x66, 0x74, 0x65, 0x72, 0x20, 0x64, 0x65, 0x76, 0x69, 0x63,
+    0x65, 0x20, 0x73, 0x74, 0x61, 0x72, 0x74, 0x75, 0x70, 0x2E, 0x20, 0x54, 0x68, 0x75, 0x73, 0x2C,
+    0x20, 0x61, 0x20, 0x72, 0x65, 0x62, 0x6F, 0x6F, 0x74, 0x20, 0x6F, 0x66, 0x20, 0x74, 0x68, 0x65,
+    0x20, 0x3C, 0x65, 0x6D, 0x3E, 0x72, 0x63, 0x5F, 0x76, 0x69, 0x73, 0x61, 0x72, 0x64, 0x3C, 0x2F,
+    0x65, 0x6D, 0x3E, 0x20, 0x6D, 0x61, 0x79, 0x20, 0x62, 0x65, 0x20, 0x72, 0x65, 0x71, 0x75, 0x69,
+    0x72, 0x65, 0x64, 0x20, 0x62, 0x65, 0x66, 0x6F, 0x72, 0x65, 0x0D, 0x0A, 0x62, 0x65, 0x69, 0x6E,
+    0x67, 0x20, 0x61, 0x62, 0x6C, 0x65, 0x20, 0x74, 0x6F, 0x20, 0x72, 0x65, 0x73, 0x65, 0x74, 0x20,
+    0x74, 0x68, 0x65, 0x20, 0x64, 0x65, 0x76, 0x69, 0x63, 0x65, 0x2E, 0x3C, 0x2F, 0x70, 0x3E, 0x0D,
+    0x0A, 0x0D, 0x0A, 0x3C, 0x70, 0x3E, 0x49, 0x66, 0x20, 0x74, 0x68, 0x65, 0x20, 0x6D, 0x69, 0x73,
+    0x63, 0x6F, 0x6E, 0x66, 0x69, 0x67, 0x75, 0x72, 0x65, 0x64, 0x20, 0x3C, 0x65, 0x6D, 0x3E, 0x72,
+    0x63, 0x5F, 0x76, 0x69, 0x73, 0x61, 0x72, 0x64, 0x3C, 0x2F, 0x65, 0x6D, 0x3E, 0x20, 0x69, 0x73,
+    0x20, 0x73, 0x74, 0x69, 0x6C, 0x6C, 0x20, 0x73, 0x75, 0x63, 0x63, 0x65, 0x73, 0x73, 0x66, 0x75,
+    0x6C, 0x6C, 0x79, 0x20, 0x64, 0x65, 0x74, 0x65, 0x63, 0x74, 0x65, 0x64, 0x20, 0x62, 0x79, 0x20,
+    0x74, 0x68, 0x65, 0x20, 0x64, 0x69, 0x73, 0x63, 0x6F, 0x76, 0x65, 0x72, 0x79, 0x0D, 0x0A, 0x74,
+    0x6F, 0x6F, 0x6C, 0x2C, 0x20, 0x69, 0x74, 0x20, 0x63, 0x61, 0x6E, 0x20, 0x62, 0x65, 0x20, 0x73,
+    0x65, 0x6C, 0x65, 0x63, 0x74, 0x65, 0x64, 0x20, 0x66, 0x72, 0x6F, 0x6D, 0x20, 0x74, 0x68, 0x65,
+    0x20, 0x3C, 0x65, 0x6D, 0x3E, 0x72, 0x63, 0x5F, 0x76, 0x69, 0x73, 0x61, 0x72, 0x64, 0x3C, 0x2F,
+    0x65, 0x6D, 0x3E, 0x20, 0x64, 0x72, 0x6F, 0x70, 0x20, 0x64, 0x6F, 0x77, 0x6E, 0x20, 0x6D, 0x65,
+    0x6E, 0x75, 0x2E, 0x20, 0x4F, 0x74, 0x68, 0x65, 0x72, 0x77, 0x69, 0x73, 0x65, 0x2C, 0x0D, 0x0A,
+    0x74, 0x68, 0x65, 0x20, 0x3C, 0x65, 0x6D, 0x3E, 0x72, 0x63, 0x5F, 0x76, 0x69, 0x73, 0x61, 0x72,
+    0x64, 0x3C, 0x2F, 0x65, 0x6D, 0x3E, 0x27, 0x73, 0x20, 0x4D, 0x41, 0x43, 0x20, 0x61, 0x64, 0x64,
+    0x72, 0x65, 0x73, 0x73, 0x2C, 0x20, 0x77, 0x68, 0x69, 0x63, 0x68, 0x20, 0x69, 0x73, 0x20, 0x70,
+    0x72, 0x69, 0x6E, 0x74, 0x65, 0x64, 0x20, 0x6F, 0x6E, 0x20, 0x74, 0x68, 0x65, 0x20, 0x64, 0x65,
+    0x76, 0x69, 0x63, 0x65, 0x20, 0x6C, 0x61, 0x62, 0x65, 0x6C, 0x2C, 0x20, 0x63, 0x61, 0x6E, 0x20,
+    0x62, 0x65, 0x20, 0x65, 0x6E, 0x74, 0x65, 0x72, 0x65, 0x64, 0x0D, 0x0A, 0x6D, 0x61, 0x6E, 0x75,
+    0x61, 0x6C, 0x6C, 0x79, 0x20, 0x69, 0x6E, 0x20, 0x74, 0x68, 0x65, 0x20, 0x64, 0x65, 0x73, 0x69,
+    0x67, 0x6E, 0x61, 0x74, 0x65, 0x64, 0x20, 0x66, 0x69, 0x65, 0x6C, 0x64, 0x73, 0x2E, 0x3C, 0x2F,
+    0x70, 0x3E, 0x0D, 0x0A, 0x0D, 0x0A, 0x3C, 0x70, 0x3E, 0x41, 0x66, 0x74, 0x65, 0x72, 0x20, 0x65,
+    0x6E, 0x74, 0x65, 0x72, 0x69, 0x6E, 0x67, 0x20, 0x74, 0x68, 0x65, 0x20, 0x4D, 0x41, 0x43, 0x20,
+    0x61, 0x64, 0x64, 0x72, 0x65, 0x73, 0x73, 0x20, 0x6F, 0x6E, 0x65, 0x20, 0x6F, 0x66, 0x20, 0x66,
+    0x6F, 0x75, 0x72, 0x20, 0x6F, 0x70, 0x74, 0x69, 0x6F, 0x6E, 0x73, 0x20, 0x63, 0x61, 0x6E, 0x20,
+    0x62, 0x65, 0x20, 0x63, 0x68, 0x6F, 0x73, 0x65, 0x6E, 0x3A, 0x3C, 0x2F, 0x70, 0x3E, 0x0D, 0x0A,
+    0x0D, 0x0A, 0x3C, 0x70, 0x3E, 0x0D, 0x0A, 0x3C, 0x75, 0x6C, 0x3E, 0x0D, 0x0A, 0x3C, 0x6C, 0x69,
+    0x3E, 0x3C, 0x65, 0x6D, 0x3E, 0x52, 0x65, 0x73, 0x65, 0x74, 0x20, 0x50, 0x61, 0x72, 0x61, 0x6D,
+    0x65, 0x74, 0x65, 0x72, 0x73, 0x3C, 0x2F, 0x65, 0x6D, 0x3E, 0x3A, 0x20, 0x52, 0x65, 0x73, 0x65,
+    0x74, 0x20, 0x61, 0x6C, 0x6C, 0x20, 0x3C, 0x65, 0x6D, 0x3E, 0x72, 0x63, 0x5F, 0x76, 0x69, 0x73,
+    0x61, 0x72, 0x64, 0x3C, 0x2F, 0x65, 0x6D, 0x3E, 0x20, 0x70, 0x61, 0x72, 0x61, 0x6D, 0x65, 0x74,
+    0x65, 0x72, 0x73, 0x20, 0x74, 0x68, 0x61, 0x74, 0x20, 0x61, 0x72, 0x65, 0x20, 0x63, 0x6F, 0x6E,
+    0x66, 0x69, 0x67, 0x75, 0x72, 0x61, 0x62, 0x6C, 0x65, 0x20, 0x76, 0x69, 0x61, 0x20, 0x74, 0x68,
+    0x65, 0x20, 0x57, 0x65, 0x62, 0x20, 0x47, 0x55, 0x49, 0x20, 0x28, 0x65, 0x2E, 0x67, 0x2E, 0x2C,
+    0x20, 0x66, 0x72, 0x61, 0x6D, 0x65, 0x20, 0x72, 0x61, 0x74, 0x65, 0x29, 0x2E, 0x3C, 0x2F, 0x6C,
+    0x69, 0x3E, 0x0D, 0x0A, 0x3C, 0x6C, 0x69, 0x3E, 0x3C, 0x65, 0x6D, 0x3E, 0x52, 0x65, 0x73, 0x65,
+    0x74, 0x20, 0x4E, 0x65, 0x74, 0x77, 0x6F, 0x72, 0x6B, 0x3C, 0x2F, 0x65, 0x6D, 0x3E, 0x3A, 0x20,
+    0x52, 0x65, 0x73, 0x65, 0x74, 0x20, 0x6E, 0x65, 0x74, 0x77, 0x6F, 0x72, 0x6B, 0x20, 0x73, 0x65,
+    0x74, 0x74, 0x69, 0x6E, 0x67, 0x73, 0x20, 0x61, 0x6E, 0x64, 0x20, 0x75, 0x73, 0x65, 0x72, 0x20,
+    0x64, 0x65, 0x66, 0x69, 0x6E, 0x65, 0x64, 0x20, 0x6E, 0x61, 0x6D, 0x65, 0x2E, 0x3C, 0x2F, 0x6C,
+    0x69, 0x3E, 0x0D, 0x0A, 0x3C, 0x6C, 0x69, 0x3E, 0x3C, 0x65, 0x6D, 0x3E, 0x52, 0x65, 0x73, 0x65,
+    0x74, 0x20, 0x41, 0x6C, 0x6C, 0x3C, 0x2F, 0x65, 0x6D, 0x3E, 0x3A, 0x20, 0x52, 0x65, 0x73, 0x65,
+    0x74, 0x20, 0x3C, 0x65, 0x6D, 0x3E, 0x72, 0x63, 0x5F, 0x76, 0x69, 0x73, 0x61, 0x72, 0x64, 0x3C,
+    0x2F, 0x65, 0x6D, 0x3E, 0x20, 0x70, 0x61, 0x72, 0x61, 0x6D, 0x65, 0x74, 0x65, 0x72, 0x73, 0x20,
+    0x61, 0x73, 0x20, 0x77, 0x65, 0x6C, 0x6C, 0x20, 0x61, 0x73, 0x20, 0x6E, 0x65, 0x74, 0x77, 0x6F,
+    0x72, 0x6B, 0x20, 0x73, 0x65, 0x74, 0x74, 0x69, 0x6E, 0x67, 0x73, 0x20, 0x61, 0x6E, 0x64, 0x20,
+    0x75, 0x73, 0x65, 0x72, 0x20, 0x64, 0x65, 0x66, 0x69, 0x6E, 0x65, 0x64, 0x20, 0x6E, 0x61, 0x6D,
+    0x65, 0x2E, 0x3C, 0x2F, 0x6C, 0x69, 0x3E, 0x0D, 0x0A, 0x3C, 0x6C, 0x69, 0x3E, 0x3C, 0x65, 0x6D,
+    0x3E, 0x53, 0x77, 0x69, 0x74, 0x63, 0x68, 0x20, 0x50, 0x61, 0x72, 0x74, 0x69, 0x74, 0x69, 0x6F,
+    0x6E, 0x73, 0x3C, 0x2F, 0x65, 0x6D, 0x3E, 0x3A, 0x20, 0x41, 0x6C, 0x6C, 0x6F, 0x77, 0x73, 0x20,
+    0x74, 0x6F, 0x20, 0x70, 0x65, 0x72, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x61, 0x20, 0x72, 0x6F, 0x6C,
+    0x6C, 0x62, 0x61, 0x63, 0x6B, 0x20, 0x74, 0x6F, 0x20, 0x74, 0x68, 0x65, 0x20, 0x70, 0x72, 0x65,
+    0x76, 0x69, 0x6F, 0x75, 0x73, 0x20, 0x66, 0x69, 0x72, 0x6D, 0x77, 0x61, 0x72, 0x65, 0x2E, 0x3C,
+    0x2F, 0x6C, 0x69, 0x3E, 0x0D, 0x0A, 0x3C, 0x75, 0x6C, 0x3E, 0x0D, 0x0A, 0x3C, 0x2F, 0x70, 0x3E,
+    0x0D, 0x0A, 0x0D, 0x0A, 0x3C, 0x70, 0x3E, 0x0D, 0x0A, 0x41, 0x20, 0x73, 0x75, 0x63, 0x63, 0x65,
+    0x73, 0x73, 0x66, 0x75, 0x6C, 0x20, 0x72, 0x65, 0x73, 0x65, 0x74, 0x20, 0x69, 0x73, 0x20, 0x69,
+    0x6E, 0x64, 0x69, 0x63, 0x61, 0x74, 0x65, 0x64, 0x20, 0x62, 0x79, 0x20, 0x61, 0x20, 0x77, 0x68,
+    0x69, 0x74, 0x65, 0x20, 0x73, 0x74, 0x61, 0x74, 0x75, 0x73, 0x20, 0x4C, 0x45, 0x44, 0x20, 0x66,
+    0x6F, 0x6C, 0x6C, 0x6F, 0x77, 0x65, 0x64, 0x20, 0x62, 0x79, 0x20, 0x61, 0x20, 0x64, 0x65, 0x76,
+    0x69, 0x63, 0x65, 0x20, 0x72, 0x65, 0x62, 0x6F, 0x6F, 0x74, 0x2E, 0x0D, 0x0A, 0x49, 0x66, 0x20,
+    0x6E, 0x6F, 0x20, 0x72, 0x65, 0x61, 0x63, 0x74, 0x69, 0x6F, 0x6E, 0x20, 0x69, 0x73, 0x20, 0x6E,
+    0x6F, 0x74, 0x69, 0x63, 0x61, 0x62, 0x6C, 0x65, 0x2C, 0x20, 0x74, 0x68, 0x65, 0x20, 0x74, 0x77,
+    0x6F, 0x20, 0x6D, 0x69, 0x6E, 0x75, 0x74, 0x65, 0x73, 0x20, 0x74, 0x69, 0x6D, 0x65, 0x20, 0x73,
+    0x6C, 0x6F, 0x74, 0x20, 0x6D, 0x61, 0x79, 0x20, 0x68, 0x61, 0x76, 0x65, 0x20, 0x70, 0x61, 0x73,
+    0x73, 0x65, 0x64, 0x2C, 0x20, 0x72, 0x65, 0x71, 0x75, 0x69, 0x72, 0x69, 0x6E, 0x67, 0x0D, 0x0A,
+    0x61, 0x6E, 0x6F, 0x74, 0x68, 0x65, 0x72, 0x20, 0x72, 0x65, 0x62, 0x6F, 0x6F, 0x74, 0x2E, 0x0D,
+    0x0A, 0x3C, 0x2F, 0x70, 0x3E, 0x0D, 0x0A, 0x0D, 0x0A, 0x3C, 0x2F, 0x42, 0x4F, 0x44, 0x59, 0x3E,
+    0x0D, 0x0A, 0x3C, 0x2F, 0x48, 0x54, 0x4D, 0x4C, 0x3E, 0x0D, 0x0A
 };
@@ -35,96 +35,1242 @@
 
 #include "rcdiscover/discover.h"
 #include "rcdiscover/deviceinfo.h"
+#include "rcdiscover/device_filter.h"
 #include "rcdiscover/utils.h"
+#include "rcdiscover/wol_batch.h"
+#include "rcdiscover/reset_verifier.h"
+#include "rcdiscover/iface_affinity.h"
+#include "rcdiscover/snapshot.h"
+#include "rcdiscover/presence_log.h"
+#include "rcdiscover/continuous_discover.h"
+#include "rcdiscover/fleet.h"
+#include "rcdiscover/metrics.h"
+#include "rcdiscover/profile.h"
+#include "rcdiscover/trace.h"
+
+#include "rcdiscover/device-writer.h"
+#include "rcdiscover/discovery.h"
+#include "rcdiscover/watch.h"
+#include "rcdiscover/profile-stats.h"
+#include "rcdiscover/duration.h"
+#include "rcdiscover/operation_not_permitted.h"
+
+#ifdef HAVE_PCAP
+#include "rcdiscover/pcap.h"
+#endif
+
+#ifndef WIN32
+#include "rcdiscover/daemon_protocol.h"
+#include "rcdiscover/fleet_shm.h"
+#endif
 
 #include <string>
 #include <sstream>
+#include <fstream>
 #include <iostream>
 #include <iomanip>
 #include <cstring>
+#include <cstdlib>
+#include <memory>
+#include <chrono>
+#include <utility>
 
 #ifdef WIN32
 #include <winsock2.h>
 #endif
 
+namespace
+{
+
+void printHelp(const char *prog)
+{
+  std::cout << prog << " [-iponly | --format <format>]";
+#ifndef WIN32
+  std::cout << " [--from-daemon <socket> | --from-shm <name>]";
+#endif
+#ifdef HAVE_PCAP
+  std::cout << " [--record <file.pcap> | --replay <file.pcap> [--realtime]]";
+#endif
+  std::cout << " [--snapshot <file>] [--known <snapshot>] [--stats]";
+  std::cout << " [--metrics-file <file>] [--profile]";
+  std::cout << " [--serial <s>] [--mac-prefix <p>] [--model <m>] [--name <n>]";
+  std::cout << " [--subnet <net>] [--first | --count <n>]";
+  std::cout << " [--include-iface <p>] [--exclude-iface <p>]";
+#ifdef HAVE_TRACING
+  std::cout << " [--trace <file.json>]";
+#endif
+  std::cout << std::endl;
+  std::cout << prog << " --wait-for <serial>[,<serial>...] [--deadline <t>] [-iponly | --format <format>]" << std::endl;
+  std::cout << prog << " --watch [<interval>] [--expire <n>]" << std::endl;
+  std::cout << prog << " --diff <old snapshot> <new snapshot>" << std::endl;
+  std::cout << prog << " --history <file> [--mac <mac>] [--since <t>] [--until <t>] [--ip-changes]" << std::endl;
+  std::cout << prog << " --reset <file> [--batch-size <n>] [--pacing <us>] [--verify <s>]" << std::endl;
+  std::cout << "            [--metrics-file <file>]" << std::endl;
+  std::cout << std::endl;
+  std::cout << "-iponly             Only print the IP addresses of the discovered devices" << std::endl;
+  std::cout << "--format <format>   Output format: table (default), json, ndjson or csv. With" << std::endl;
+  std::cout << "                    json, ndjson and csv, devices are written with all fields" << std::endl;
+  std::cout << "                    as soon as they are discovered" << std::endl;
+#ifndef WIN32
+  std::cout << "--from-daemon <socket>" << std::endl;
+  std::cout << "                    Get the devices from rcdiscoverd instead of discovering" << std::endl;
+  std::cout << "--from-shm <name>   Get the devices from the shared memory of rcdiscoverd" << std::endl;
+#endif
+#ifdef HAVE_PCAP
+  std::cout << "--record <file>     Store all sent and received packages in a pcap file" << std::endl;
+  std::cout << "--replay <file>     Discover devices from a pcap file instead of the network" << std::endl;
+  std::cout << "--realtime          Replay with the timing of the capture instead of full speed" << std::endl;
+#endif
+  std::cout << "--snapshot <file>   Additionally store the devices in a binary snapshot file" << std::endl;
+  std::cout << "--known <snapshot>  Send unicast requests to devices of the snapshot that did not" << std::endl;
+  std::cout << "                    answer the broadcast" << std::endl;
+  std::cout << "--stats             Print the counters of each interface to stderr" << std::endl;
+  std::cout << "--metrics-file <file>" << std::endl;
+  std::cout << "                    Write metrics of discovery or reset in Prometheus text format" << std::endl;
+  std::cout << "--profile           Print the wall-clock time of each phase to stderr" << std::endl;
+  std::cout << "--serial <s>        Only devices with the given serial number" << std::endl;
+  std::cout << "--mac-prefix <p>    Only devices whose MAC address starts with the given bytes," << std::endl;
+  std::cout << "                    e.g. 00:14:2d" << std::endl;
+  std::cout << "--model <m>         Only devices with the given model name, e.g. rc_visard" << std::endl;
+  std::cout << "--name <n>          Only devices with the given user name" << std::endl;
+  std::cout << "--subnet <net>      Only devices with an IP address in the subnet, e.g. 10.0.2.0/24" << std::endl;
+  std::cout << "                    Each of these options can be given several times. A device" << std::endl;
+  std::cout << "                    must match one value of each given option" << std::endl;
+  std::cout << "--include-iface <p> Only discover on interfaces whose name matches the pattern," << std::endl;
+  std::cout << "                    which may contain * and ?, or whose address is in the" << std::endl;
+  std::cout << "                    subnet, e.g. eth* or 10.0.2.0/24. Can be given several times" << std::endl;
+  std::cout << "--exclude-iface <p> Do not discover on matching interfaces, e.g. docker*" << std::endl;
+  std::cout << "--first             Stop as soon as the first matching device is discovered" << std::endl;
+  std::cout << "--count <n>         Stop as soon as n matching devices are discovered. With" << std::endl;
+  std::cout << "                    --first and --count, the exit status is 1 if fewer devices" << std::endl;
+  std::cout << "                    are found" << std::endl;
+#ifdef HAVE_TRACING
+  std::cout << "--trace <file>      Write all trace events in Chrome trace format to the file" << std::endl;
+#endif
+  std::cout << "--wait-for <serials>" << std::endl;
+  std::cout << "                    Discover until all devices of the comma separated list of" << std::endl;
+  std::cout << "                    serial numbers have answered, printing each one as it" << std::endl;
+  std::cout << "                    appears. The exit status is 1 if the deadline has passed" << std::endl;
+  std::cout << "--deadline <t>      Maximum time for --wait-for, e.g. 60s or 5m (default: 60s)" << std::endl;
+  std::cout << "--watch [<t>]       Discover repeatedly with the given interval, e.g. 2s or" << std::endl;
+  std::cout << "                    500ms (default: 1s), and only print new, disappeared and" << std::endl;
+  std::cout << "                    changed devices" << std::endl;
+  std::cout << "--expire <n>        Number of rounds without answer after which a device is" << std::endl;
+  std::cout << "                    reported as disappeared in --watch mode (default: 3)" << std::endl;
+  std::cout << "--diff <old> <new>  Print the differences between two snapshot files" << std::endl;
+  std::cout << "--history <file>    Print the state transitions of a presence log of rcdiscoverd" << std::endl;
+  std::cout << "--mac <mac>         Only print the transitions of the device and its uptime" << std::endl;
+  std::cout << "--since <t>         Start of time interval, e.g. 7d, 24h, 30m or 60s ago (default: all)" << std::endl;
+  std::cout << "--until <t>         End of time interval, e.g. 24h ago (default: now)" << std::endl;
+  std::cout << "--ip-changes        Only print changes of the IP address" << std::endl;
+  std::cout << "--reset <file>      Reset all devices listed in the file ('-' for stdin). Each" << std::endl;
+  std::cout << "                    line contains a MAC address and a function, which is one" << std::endl;
+  std::cout << "                    of params, gige, partition, all or the function id," << std::endl;
+  std::cout << "                    and optionally the interface on which the device lives." << std::endl;
+  std::cout << "                    Otherwise, the interface is taken from a discovery round" << std::endl;
+  std::cout << "                    before the reset or, if the device does not answer, the" << std::endl;
+  std::cout << "                    packet is sent on all interfaces" << std::endl;
+  std::cout << "--batch-size <n>    Number of magic packets per interface and batch (default: 64)" << std::endl;
+  std::cout << "--pacing <us>       Pause between two batches in microseconds (default: 0)" << std::endl;
+  std::cout << "--verify <s>        After reset, watch the devices for at most the given number" << std::endl;
+  std::cout << "                    of seconds until they disappear and reappear. Devices" << std::endl;
+  std::cout << "                    that never answer are reported as 'never seen'" << std::endl;
+}
+
+/*
+  Converts the name or hex id of a reset function into the function id.
+*/
+
+uint8_t parseResetFunction(const std::string &s)
+{
+  if (s == "params" || s == "parameters") return 0xAA;
+  if (s == "gige" || s == "network") return 0xBB;
+  if (s == "partition") return 0xCC;
+  if (s == "all") return 0xFF;
+
+  size_t pos = 0;
+  unsigned long id = 0;
+
+  try
+  {
+    id = std::stoul(s, &pos, 16);
+  }
+  catch(const std::exception &)
+  {
+    pos = 0;
+  }
+
+  if (pos == 0 || pos != s.size() || id > 0xff ||
+      !rcdiscover::WOLBatch::isResetFunction(static_cast<uint8_t>(id)))
+  {
+    throw std::invalid_argument("Unknown reset function: " + s);
+  }
+
+  return static_cast<uint8_t>(id);
+}
+
+/*
+  Converts a MAC address of the form xx:xx:xx:xx:xx:xx into bytes.
+*/
+
+std::array<uint8_t, 6> parseMac(const std::string &s)
+{
+  try
+  {
+    for (const std::string &b : split<6>(s, ':'))
+    {
+      if (b.empty() || b.size() > 2 ||
+          b.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos)
+      {
+        throw std::invalid_argument(s);
+      }
+    }
+
+    return string2mac(s);
+  }
+  catch(const std::exception &)
+  {
+    throw std::invalid_argument("Invalid MAC address: " + s);
+  }
+}
+
+/*
+  Reads a list of MAC addresses and reset functions and resets all devices in
+  one pass.
+*/
+
+int resetDevices(const std::string &filename, size_t batch_size,
+                 long pacing_us, int verify_s)
+{
+  std::ifstream file;
+  if (filename != "-")
+  {
+    file.open(filename.c_str());
+    if (!file)
+    {
+      std::cerr << "Cannot open reset list: " << filename << std::endl;
+      return 1;
+    }
+  }
+
+  std::istream &in = (filename == "-") ? std::cin : file;
+
+  rcdiscover::WOLBatch batch(9);
+  batch.setBatchSize(batch_size);
+  batch.setPacing(std::chrono::microseconds(pacing_us));
+
+  std::vector<uint64_t> macs;
+  bool all_ifaces = true;
+
+  std::string line;
+  int line_no = 0;
+  while (std::getline(in, line))
+  {
+    line_no++;
+
+    std::istringstream iss(line);
+    std::string mac, func, iface;
+    if (!(iss >> mac) || mac[0] == '#')
+    {
+      continue;
+    }
+
+    try
+    {
+      if (!(iss >> func))
+      {
+        throw std::invalid_argument("missing reset function");
+      }
+
+      iss >> iface;
+      all_ifaces = all_ifaces && !iface.empty();
+
+      const auto m = parseMac(mac);
+      batch.add(m, parseResetFunction(func), iface);
+
+      uint64_t v = 0;
+      for (const uint8_t b : m)
+      {
+        v = (v << 8) | b;
+      }
+      macs.push_back(v);
+    }
+    catch(const std::exception &ex)
+    {
+      std::cerr << "Invalid entry in line " << line_no << ": " << line
+                << " (" << ex.what() << ")" << std::endl;
+      return 1;
+    }
+  }
+
+  if (batch.size() == 0)
+  {
+    std::cerr << "No devices to reset" << std::endl;
+    return 1;
+  }
+
+  std::vector<rcdiscover::ResetStatus> status;
+
+  try
+  {
+    // a discovery round before the reset records the interface on which
+    // each device answers, so that its magic packet is only sent there (see
+    // IfaceAffinity). With verification, the baseline round serves this
+    // purpose. Devices that do not answer before the reset cannot be verified.
+
+    std::unique_ptr<rcdiscover::ResetVerifier> verifier;
+    if (verify_s > 0)
+    {
+      verifier.reset(new rcdiscover::ResetVerifier(macs));
+      const size_t answered = verifier->takeBaseline();
+
+      if (answered < macs.size())
+      {
+        std::cerr << (macs.size()-answered) << " of " << macs.size()
+                  << " devices did not answer before the reset" << std::endl;
+      }
+    }
+    else if (!all_ifaces)
+    {
+      rcdiscover::Discover discover;
+      discover.broadcastRequest();
+
+      std::vector<rcdiscover::DeviceInfo> infos;
+      while (discover.getResponse(infos, 100)) { }
+
+      rcdiscover::IfaceAffinity::update(infos);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    const size_t failed=batch.send([](size_t sent, size_t total)
+    {
+      std::cerr << "\rSent " << sent << " / " << total << " magic packets"
+                << std::flush;
+    });
+
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                      std::chrono::steady_clock::now() - start).count();
+
+    std::cerr << std::endl;
+
+    if (failed > 0)
+    {
+      std::cerr << "Warning: " << failed << " magic packets could not be sent"
+                << std::endl;
+    }
+
+    std::cout << "Reset " << batch.size() << " devices in " << ms << " ms"
+              << std::endl;
+
+    if (verifier)
+    {
+      status = verifier->run(start, std::chrono::seconds(verify_s),
+                             [](const rcdiscover::ResetStatus &s)
+      {
+        std::cerr << mac2string(s.mac)
+                  << (s.state == rcdiscover::ResetStatus::DISAPPEARED ?
+                      " disappeared" : " reappeared") << std::endl;
+      });
+    }
+  }
+  catch(const rcdiscover::OperationNotPermitted &)
+  {
+    std::cerr << std::endl << "Error: rcdiscover probably requires root/admin "
+              << "privileges for this operation." << std::endl;
+    return 1;
+  }
+  catch(const std::exception &ex)
+  {
+    std::cerr << std::endl << "Error: " << ex.what() << std::endl;
+    return 1;
+  }
+
+  if (verify_s <= 0)
+  {
+    return 0;
+  }
+
+  int ret = 0;
+
+  std::cout << "MAC\t\t\tResult\t\tDown [ms]\tUp [ms]\tIP\t\tSubnet"
+            << std::endl;
+
+  for (const auto &s : status)
+  {
+    std::cout << mac2string(s.mac) << "\t";
+
+    switch (s.state)
+    {
+      case rcdiscover::ResetStatus::NOT_SEEN:
+        std::cout << "never seen\t-\t\t-";
+        ret = 1;
+        break;
+
+      case rcdiscover::ResetStatus::ANSWERING:
+        std::cout << "not reset\t-\t\t-";
+        ret = 1;
+        break;
+
+      case rcdiscover::ResetStatus::DISAPPEARED:
+        std::cout << "not back\t" << s.time_to_disappear.count() << "\t\t-";
+        ret = 1;
+        break;
+
+      case rcdiscover::ResetStatus::REAPPEARED:
+        std::cout << "ok\t\t" << s.time_to_disappear.count() << "\t\t"
+                  << s.time_to_reappear.count();
+        break;
+    }
+
+    if (s.info.isValid())
+    {
+      std::cout << "\t" << ip2string(s.info.getIP()) << "\t"
+                << ip2string(s.info.getSubnetMask());
+    }
+
+    std::cout << std::endl;
+  }
+
+  return ret;
+}
+
+/*
+  Prints all differences between two snapshot files.
+*/
+
+int diffSnapshotFiles(const std::string &old_file, const std::string &new_file)
+{
+  try
+  {
+    rcdiscover::Snapshot a(old_file);
+    rcdiscover::Snapshot b(new_file);
+
+    for (const auto &change : rcdiscover::diffSnapshots(a, b))
+    {
+      switch (change.type)
+      {
+        case rcdiscover::SnapshotChange::ADDED:
+          {
+            const rcdiscover::SnapshotRecord &r = b.getRecord(change.new_index);
+            std::cout << "+ " << mac2string(r.mac) << "\t" << ip2string(r.ip)
+                      << "\t" << b.getString(r.serial_number) << "\t"
+                      << b.getString(r.user_name) << std::endl;
+          }
+          break;
+
+        case rcdiscover::SnapshotChange::REMOVED:
+          {
+            const rcdiscover::SnapshotRecord &r = a.getRecord(change.old_index);
+            std::cout << "- " << mac2string(r.mac) << "\t" << ip2string(r.ip)
+                      << "\t" << a.getString(r.serial_number) << "\t"
+                      << a.getString(r.user_name) << std::endl;
+          }
+          break;
+
+        case rcdiscover::SnapshotChange::CHANGED:
+          {
+            const rcdiscover::DeviceInfo da = a.getDevice(change.old_index);
+            const rcdiscover::DeviceInfo db = b.getDevice(change.new_index);
+
+            std::cout << "~ " << mac2string(change.mac);
+
+            const char *sep = "\t";
+            auto print = [&](unsigned int field, const char *name,
+                             const std::string &va, const std::string &vb)
+            {
+              if (change.fields & field)
+              {
+                std::cout << sep << name << ": " << va << " -> " << vb;
+                sep = ", ";
+              }
+            };
+
+            using rcdiscover::SnapshotChange;
+
+            print(SnapshotChange::IP, "ip", ip2string(da.getIP()),
+                  ip2string(db.getIP()));
+            print(SnapshotChange::SUBNET, "subnet",
+                  ip2string(da.getSubnetMask()), ip2string(db.getSubnetMask()));
+            print(SnapshotChange::GATEWAY, "gateway",
+                  ip2string(da.getGateway()), ip2string(db.getGateway()));
+            print(SnapshotChange::VERSION, "version",
+                  std::to_string(da.getMajorVersion()) + "." +
+                  std::to_string(da.getMinorVersion()),
+                  std::to_string(db.getMajorVersion()) + "." +
+                  std::to_string(db.getMinorVersion()));
+            print(SnapshotChange::MANUFACTURER_NAME, "manufacturer",
+                  da.getManufacturerName(), db.getManufacturerName());
+            print(SnapshotChange::MODEL_NAME, "model", da.getModelName(),
+                  db.getModelName());
+            print(SnapshotChange::DEVICE_VERSION, "device version",
+                  da.getDeviceVersion(), db.getDeviceVersion());
+            print(SnapshotChange::MANUFACTURER_INFO, "manufacturer info",
+                  da.getManufacturerInfo(), db.getManufacturerInfo());
+            print(SnapshotChange::SERIAL_NUMBER, "serial",
+                  da.getSerialNumber(), db.getSerialNumber());
+            print(SnapshotChange::USER_NAME, "name", da.getUserName(),
+                  db.getUserName());
+            print(SnapshotChange::IFACE_NAME, "interface", da.getIfaceName(),
+                  db.getIfaceName());
+
+            std::cout << std::endl;
+          }
+          break;
+      }
+    }
+  }
+  catch(const std::exception &ex)
+  {
+    std::cerr << "Error: " << ex.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+/*
+  Prints the state transitions of a presence log in a time interval and,
+  for a single device, its uptime.
+*/
+
+int printHistory(const std::string &filename, const std::string &mac_string,
+                 const std::string &since, const std::string &until,
+                 bool ip_changes)
+{
+  try
+  {
+    rcdiscover::PresenceLog log(filename);
+
+    const uint64_t now = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+
+    uint64_t from = 0;
+    if (since.size() > 0)
+    {
+      from = now - std::min(now, parseDuration(since));
+    }
+
+    uint64_t to = now;
+    if (until.size() > 0)
+    {
+      to = now - std::min(now, parseDuration(until));
+    }
+
+    std::vector<size_t> records;
+
+    uint64_t mac = 0;
+    if (mac_string.size() > 0)
+    {
+      for (const uint8_t b : parseMac(mac_string))
+      {
+        mac = (mac << 8) | b;
+      }
+
+      for (const size_t i : log.findByMAC(mac))
+      {
+        const uint64_t t = log.getRecord(i).time;
+        if (t >= from && t < to)
+        {
+          records.push_back(i);
+        }
+      }
+    }
+    else
+    {
+      size_t first, last;
+      log.findByTime(from, to, first, last);
+
+      for (size_t i = first; i < last; ++i)
+      {
+        records.push_back(i);
+      }
+    }
+
+    for (const size_t i : records)
+    {
+      const rcdiscover::PresenceRecord &r = log.getRecord(i);
+
+      if (ip_changes && (r.type != rcdiscover::PresenceRecord::CHANGED ||
+                         (r.changed & rcdiscover::FleetEvent::IP) == 0))
+      {
+        continue;
+      }
+
+      std::cout << formatTime(r.time) << "\t";
+
+      switch (r.type)
+      {
+        case rcdiscover::PresenceRecord::APPEARED:
+          std::cout << "appeared\t";
+          break;
+
+        case rcdiscover::PresenceRecord::DISAPPEARED:
+          std::cout << "disappeared\t";
+          break;
+
+        case rcdiscover::PresenceRecord::CHANGED:
+          std::cout << "changed\t\t";
+          break;
+
+        default:
+          std::cout << "started" << std::endl;
+          continue;
+      }
+
+      std::cout << mac2string(r.mac) << "\t" << ip2string(r.ip) << "\t"
+                << ip2string(r.subnet) << "\t" << ip2string(r.gateway)
+                << std::endl;
+    }
+
+    if (mac != 0)
+    {
+      if (from == 0 && log.size() > 0)
+      {
+        from = log.getRecord(0).time;
+      }
+
+      const uint64_t total = (to > from) ? to - from : 0;
+      const uint64_t up = log.getUptime(mac, from, to);
+
+      std::cout << "Uptime: " << up/1000 << " s of " << total/1000 << " s";
+      if (total > 0)
+      {
+        std::cout << " (" << std::fixed << std::setprecision(2)
+                  << 100.0*static_cast<double>(up)/static_cast<double>(total)
+                  << " %)";
+      }
+      std::cout << std::endl;
+    }
+  }
+  catch(const std::exception &ex)
+  {
+    std::cerr << "Error: " << ex.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+/*
+  Writes the metrics file and reports errors.
+*/
+
+bool writeMetrics(const std::string &filename)
+{
+  try
+  {
+    rcdiscover::Metrics::writeTextfile(filename);
+  }
+  catch(const std::exception &ex)
+  {
+    std::cerr << "Error: " << ex.what() << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+/*
+  Creates a filter from the criteria given on the command line.
+*/
+
+std::shared_ptr<rcdiscover::DeviceFilter> createFilter(
+  const std::vector<std::pair<std::string, std::string>> &criteria)
+{
+  auto filter=std::make_shared<rcdiscover::DeviceFilter>();
+
+  for (const auto &c : criteria)
+  {
+    if (c.first == "--serial")
+    {
+      filter->addSerialNumber(c.second);
+    }
+    else if (c.first == "--mac-prefix")
+    {
+      filter->addMACPrefix(c.second);
+    }
+    else if (c.first == "--model")
+    {
+      filter->addModelName(c.second);
+    }
+    else if (c.first == "--name")
+    {
+      filter->addUserName(c.second);
+    }
+    else if (c.first == "--subnet")
+    {
+      filter->addSubnet(c.second);
+    }
+  }
+
+  return filter;
+}
+
+/*
+  Creates the selection of interfaces from the patterns given on the command
+  line.
+*/
+
+rcdiscover::InterfaceSelection createInterfaceSelection(
+  const std::vector<std::pair<std::string, std::string>> &patterns)
+{
+  rcdiscover::InterfaceSelection selection;
+
+  for (const auto &p : patterns)
+  {
+    if (p.first == "--include-iface")
+    {
+      selection.include(p.second);
+    }
+    else
+    {
+      selection.exclude(p.second);
+    }
+  }
+
+  return selection;
+}
+
+}
+
 int main(int argc, char *argv[])
 {
 #ifdef WIN32
-	WSADATA wsaData;
-	WSAStartup(MAKEWORD(2, 2), &wsaData);
+  WSADATA wsaData;
+  WSAStartup(MAKEWORD(2, 2), &wsaData);
 #endif
 
   bool iponly=false;
+  std::string format;
+#ifdef HAVE_PCAP
+  std::string record;
+  std::string replay;
+  bool realtime=false;
+#endif
+  std::string reset;
+  std::string daemon_socket;
+  std::string shm_name;
+  std::string snapshot;
+  std::string known;
+  std::string diff_old, diff_new;
+  std::string history, history_mac, since, until;
+  bool ip_changes=false;
+  bool stats=false;
+  std::string metrics_file;
+  bool profile=false;
+  std::string trace;
+  std::vector<std::pair<std::string, std::string>> criteria;
+  std::vector<std::pair<std::string, std::string>> iface_patterns;
+  size_t count=0;
+  std::vector<std::string> wait_for;
+  std::string deadline="60s";
+  bool watch=false;
+  std::string watch_interval="1s";
+  int expire=3;
+  size_t batch_size=64;
+  long pacing_us=0;
+  int verify_s=0;
 
-  if (argc > 1 && std::strcmp(argv[1], "-iponly") == 0)
+  for (int i=1; i<argc; i++)
   {
-    iponly=true;
+    if (std::strcmp(argv[i], "-iponly") == 0)
+    {
+      iponly=true;
+    }
+    else if (std::strcmp(argv[i], "--format") == 0 && i+1 < argc)
+    {
+      format=argv[++i];
+    }
+    else if (std::strncmp(argv[i], "--format=", 9) == 0)
+    {
+      format=argv[i]+9;
+    }
+#ifdef HAVE_PCAP
+    else if (std::strcmp(argv[i], "--record") == 0 && i+1 < argc)
+    {
+      record=argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--replay") == 0 && i+1 < argc)
+    {
+      replay=argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--realtime") == 0)
+    {
+      realtime=true;
+    }
+#else
+    else if (std::strcmp(argv[i], "--record") == 0 ||
+             std::strcmp(argv[i], "--replay") == 0 ||
+             std::strcmp(argv[i], "--realtime") == 0)
+    {
+      std::cerr << argv[i] << " is not supported, since rcdiscover has been "
+                << "built without pcap support (WITH_PCAP)" << std::endl;
+
+#ifdef WIN32
+      ::WSACleanup();
+#endif
+
+      return 1;
+    }
+#endif
+#ifndef WIN32
+    else if (std::strcmp(argv[i], "--from-daemon") == 0 && i+1 < argc)
+    {
+      daemon_socket=argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--from-shm") == 0 && i+1 < argc)
+    {
+      shm_name=argv[++i];
+    }
+#endif
+    else if (std::strcmp(argv[i], "--snapshot") == 0 && i+1 < argc)
+    {
+      snapshot=argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--known") == 0 && i+1 < argc)
+    {
+      known=argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--stats") == 0)
+    {
+      stats=true;
+    }
+    else if (std::strcmp(argv[i], "--metrics-file") == 0 && i+1 < argc)
+    {
+      metrics_file=argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--profile") == 0)
+    {
+      profile=true;
+    }
+    else if ((std::strcmp(argv[i], "--serial") == 0 ||
+              std::strcmp(argv[i], "--mac-prefix") == 0 ||
+              std::strcmp(argv[i], "--model") == 0 ||
+              std::strcmp(argv[i], "--name") == 0 ||
+              std::strcmp(argv[i], "--subnet") == 0) && i+1 < argc)
+    {
+      criteria.push_back(std::make_pair(argv[i], argv[i+1]));
+      i++;
+    }
+    else if ((std::strcmp(argv[i], "--include-iface") == 0 ||
+              std::strcmp(argv[i], "--exclude-iface") == 0) && i+1 < argc)
+    {
+      iface_patterns.push_back(std::make_pair(argv[i], argv[i+1]));
+      i++;
+    }
+    else if (std::strcmp(argv[i], "--first") == 0)
+    {
+      count=1;
+    }
+    else if (std::strcmp(argv[i], "--count") == 0 && i+1 < argc)
+    {
+      count=static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+    }
+    else if (std::strcmp(argv[i], "--wait-for") == 0 && i+1 < argc)
+    {
+      std::istringstream in(argv[++i]);
+      std::string serial;
+      while (std::getline(in, serial, ','))
+      {
+        if (serial.size() > 0)
+        {
+          wait_for.push_back(serial);
+          criteria.push_back(std::make_pair("--serial", serial));
+        }
+      }
+    }
+    else if (std::strcmp(argv[i], "--deadline") == 0 && i+1 < argc)
+    {
+      deadline=argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--watch") == 0)
+    {
+      watch=true;
+
+      // the interval is optional
+
+      if (i+1 < argc && argv[i+1][0] != '-')
+      {
+        watch_interval=argv[++i];
+      }
+    }
+    else if (std::strcmp(argv[i], "--expire") == 0 && i+1 < argc)
+    {
+      expire=std::max(1, std::atoi(argv[++i]));
+    }
+#ifdef HAVE_TRACING
+    else if (std::strcmp(argv[i], "--trace") == 0 && i+1 < argc)
+    {
+      trace=argv[++i];
+    }
+#endif
+    else if (std::strcmp(argv[i], "--diff") == 0 && i+2 < argc)
+    {
+      diff_old=argv[++i];
+      diff_new=argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--history") == 0 && i+1 < argc)
+    {
+      history=argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--mac") == 0 && i+1 < argc)
+    {
+      history_mac=argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--since") == 0 && i+1 < argc)
+    {
+      since=argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--until") == 0 && i+1 < argc)
+    {
+      until=argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--ip-changes") == 0)
+    {
+      ip_changes=true;
+    }
+    else if (std::strcmp(argv[i], "--reset") == 0 && i+1 < argc)
+    {
+      reset=argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--batch-size") == 0 && i+1 < argc)
+    {
+      batch_size=static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+    }
+    else if (std::strcmp(argv[i], "--pacing") == 0 && i+1 < argc)
+    {
+      pacing_us=std::max(0L, std::atol(argv[++i]));
+    }
+    else if (std::strcmp(argv[i], "--verify") == 0 && i+1 < argc)
+    {
+      verify_s=std::atoi(argv[++i]);
+    }
+    else if (std::strcmp(argv[i], "-h") == 0 ||
+             std::strcmp(argv[i], "--help") == 0)
+    {
+      printHelp(argv[0]);
+
+#ifdef WIN32
+      ::WSACleanup();
+#endif
+
+      return 0;
+    }
+    else
+    {
+      std::cerr << "Invalid argument: " << argv[i] << std::endl;
+      printHelp(argv[0]);
+
+#ifdef WIN32
+      ::WSACleanup();
+#endif
+
+      return 1;
+    }
   }
 
-  rcdiscover::Discover discover;
-  discover.broadcastRequest();
+  const auto profile_start=std::chrono::steady_clock::now();
+  rcdiscover::Profile::setEnabled(profile);
 
-  std::vector<rcdiscover::DeviceInfo> infos;
+  if (diff_old.size() > 0)
+  {
+    const int ret=diffSnapshotFiles(diff_old, diff_new);
+
+#ifdef WIN32
+    ::WSACleanup();
+#endif
+
+    return ret;
+  }
 
-  if (!iponly)
+  if (history.size() > 0)
   {
-    std::cout << "User name\tSerial number\tIP\t\tMAC" << std::endl;
+    const int ret=printHistory(history, history_mac, since, until, ip_changes);
+
+#ifdef WIN32
+    ::WSACleanup();
+#endif
 
-    while (discover.getResponse(infos, 100)) { }
+    return ret;
+  }
 
-    std::sort(infos.begin(), infos.end());
-    const auto it = std::unique(infos.begin(), infos.end());
-    infos.erase(it, infos.end());
+  if (reset.size() > 0)
+  {
+    int ret=resetDevices(reset, batch_size, pacing_us, verify_s);
 
-		for (rcdiscover::DeviceInfo &info : infos)
+    if (metrics_file.size() > 0 && !writeMetrics(metrics_file))
     {
-			if (!info.isValid())
-			{
-			  continue;
-			}
+      ret=1;
+    }
+
+#ifdef WIN32
+    ::WSACleanup();
+#endif
+
+    return ret;
+  }
+
+  if (format.size() == 0)
+  {
+    format=iponly ? "ip" : "table";
+  }
 
-      std::string name=info.getUserName();
+  std::unique_ptr<DeviceWriter> writer;
+  std::shared_ptr<rcdiscover::DeviceFilter> filter;
+  rcdiscover::InterfaceSelection ifaces;
+  std::chrono::milliseconds deadline_ms, interval_ms;
+
+  try
+  {
+    writer=DeviceWriter::create(format, std::cout);
+    filter=createFilter(criteria);
+    ifaces=createInterfaceSelection(iface_patterns);
+    deadline_ms=std::chrono::milliseconds(parseDuration(deadline));
+    interval_ms=std::chrono::milliseconds(parseDuration(watch_interval));
+  }
+  catch(const std::exception &ex)
+  {
+    std::cerr << "Error: " << ex.what() << std::endl;
+    printHelp(argv[0]);
+
+#ifdef WIN32
+    ::WSACleanup();
+#endif
+
+    return 1;
+  }
+
+  if (watch)
+  {
+    const int ret=watchDevices(interval_ms, expire, ifaces, filter);
+
+#ifdef WIN32
+    ::WSACleanup();
+#endif
+
+    return ret;
+  }
+
+  if (wait_for.size() > 0)
+  {
+    const int ret=waitForDevices(wait_for, deadline_ms, ifaces, filter,
+                                 *writer);
+
+#ifdef WIN32
+    ::WSACleanup();
+#endif
+
+    return ret;
+  }
+
+  std::vector<rcdiscover::DeviceInfo> infos;
+  std::vector<rcdiscover::IfaceStats> iface_stats;
+  size_t found=0;
+
+  const auto start=std::chrono::steady_clock::now();
+
+  try
+  {
+#ifndef WIN32
+    if (daemon_socket.size() > 0)
+    {
+      rcdiscover::DaemonClient client(daemon_socket);
+      infos = client.query("list");
+    }
+    else if (shm_name.size() > 0)
+    {
+      rcdiscover::FleetShmReader reader(shm_name);
+      infos = reader.getDevices();
+    }
+    else
+#endif
+#ifdef HAVE_PCAP
+    if (replay.size() > 0)
+    {
+      replayCapture(replay, realtime, infos);
+    }
+    else
+#endif
+    {
+      std::unique_ptr<rcdiscover::Discover> discover;
 
-      if (name.size() == 0)
       {
-        name=info.getModelName();
+        rcdiscover::ScopedTimer timer("open sockets");
+        discover.reset(new rcdiscover::Discover(ifaces));
       }
 
-      std::cout << name << "\t";
-      std::cout << info.getSerialNumber() << "\t";
-      std::cout << ip2string(info.getIP()) << "\t";
-      std::cout << mac2string(info.getMAC());
+#ifdef HAVE_PCAP
+      if (record.size() > 0)
+      {
+        discover->setRecorder(std::make_shared<rcdiscover::PcapWriter>(record));
+      }
+#endif
 
-      if (info.getModelName() != "rc_visard")
+      if (!filter->empty())
       {
-        std::cout << "\t[other GEV device]";
+        discover->setFilter(filter);
       }
 
-      std::cout << std::endl;
+      std::vector<rcdiscover::DeviceInfo> expected;
+      if (known.size() > 0)
+      {
+        rcdiscover::Snapshot s(known);
+
+        for (size_t i=0; i<s.size(); i++)
+        {
+          if (filter->matches(s.getDevice(i)))
+          {
+            expected.push_back(s.getDevice(i));
+          }
+        }
+      }
+
+      if (stats)
+      {
+        // errors are reported per interface
+
+        discover->tryBroadcastRequest();
+      }
+      else
+      {
+        discover->broadcastRequest();
+      }
+
+      {
+        std::chrono::steady_clock::time_point wait_start;
+
+        {
+          rcdiscover::ScopedTimer timer("wait for responses");
+          wait_start=std::chrono::steady_clock::now();
+
+          if (expected.empty())
+          {
+            found=receiveResponses(*discover, infos, *writer, count);
+          }
+          else
+          {
+            // devices of the snapshot that are missing after the burst of
+            // broadcast responses are re-probed, and all responses are
+            // received within the same timeout
+
+            const int timeout=100;
+            const int burst_timeout=timeout/4;
+
+            found=receiveResponses(*discover, infos, *writer, count,
+                                   burst_timeout);
+
+            if (count == 0 || found < count)
+            {
+              discover->reprobeMissing(expected, infos);
+              found+=receiveResponses(*discover, infos, *writer,
+                                      count > 0 ? count-found : 0,
+                                      timeout-burst_timeout);
+            }
+          }
+        }
+
+        if (profile)
+        {
+          recordResponsePhases(discover->getStatistics(), wait_start);
+        }
+      }
+
+      iface_stats=discover->getStatistics();
+
+      rcdiscover::Metrics::recordScan(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now()-start), true);
+      rcdiscover::Metrics::recordInterfaces(iface_stats, infos);
+    }
+
+    // devices of other sources are filtered now, live devices have already
+    // been filtered before decoding
+
+    found=selectDevices(infos, *filter, count);
+
+    if (snapshot.size() > 0)
+    {
+      rcdiscover::Snapshot::write(snapshot, infos,
+        static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::seconds>(
+          std::chrono::system_clock::now().time_since_epoch()).count()));
+    }
+  }
+  catch(const std::exception &ex)
+  {
+    writer->abort();
+
+    std::cerr << "Error: " << ex.what() << std::endl;
+
+    if (metrics_file.size() > 0)
+    {
+      rcdiscover::Metrics::recordScan(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now()-start), false);
+      writeMetrics(metrics_file);
     }
+
+#ifdef WIN32
+    ::WSACleanup();
+#endif
+
+    return 1;
+  }
+
+  if (metrics_file.size() > 0 && !writeMetrics(metrics_file))
+  {
+#ifdef WIN32
+    ::WSACleanup();
+#endif
+
+    return 1;
   }
-  else
+
+  rcdiscover::ScopedTimer output_timer("output");
+
+  // devices from other sources than live discovery are written now, live
+  // devices have already been written and are ignored
+
+  writer->write(infos);
+  writer->finish();
+
+  if (stats)
   {
-    while (discover.getResponse(infos, 100)) {}
+    printStats(iface_stats);
+  }
 
-    std::sort(infos.begin(), infos.end());
-    const auto it = std::unique(infos.begin(), infos.end());
-    infos.erase(it, infos.end());
+  std::cout.flush();
 
-		for (rcdiscover::DeviceInfo &info : infos)
+  if (profile)
+  {
+    output_timer.stop();
+    printProfile(std::chrono::steady_clock::now()-profile_start);
+  }
+
+#ifdef HAVE_TRACING
+  if (trace.size() > 0)
+  {
+    try
     {
-			if (!info.isValid())
-			{
-			  continue;
-			}
+      rcdiscover::Trace::writeChromeJson(trace);
+    }
+    catch(const std::exception &ex)
+    {
+      std::cerr << "Error: " << ex.what() << std::endl;
 
-      std::cout << ip2string(info.getIP()) << std::endl;
+#ifdef WIN32
+      ::WSACleanup();
+#endif
+
+      return 1;
     }
   }
+#endif
 
 #ifdef WIN32
   ::WSACleanup();
 #endif
 
-  return 0;
-}
\ No newline at end of file
+  return (count > 0 && found < count) ? 1 : 0;
+}
@@ -0,0 +1,331 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "device-writer.h"
+
+#include "rcdiscover/utils.h"
+#include "rcdiscover/profile.h"
+#include "rcdiscover/trace.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <cstdio>
+
+namespace
+{
+
+/*
+  Writes a string as JSON string.
+*/
+
+void writeJsonString(std::ostream &out, const std::string &s)
+{
+  out << '"';
+  for (const char c : s)
+  {
+    switch (c)
+    {
+      case '"': out << "\\\""; break;
+      case '\\': out << "\\\\"; break;
+      case '\n': out << "\\n"; break;
+      case '\r': out << "\\r"; break;
+      case '\t': out << "\\t"; break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20)
+        {
+          char buf[8];
+          std::snprintf(buf, sizeof(buf), "\\u%04x",
+                        static_cast<unsigned int>(c));
+          out << buf;
+        }
+        else
+        {
+          out << c;
+        }
+    }
+  }
+  out << '"';
+}
+
+void writeJsonObject(std::ostream &out, const rcdiscover::DeviceInfo &info)
+{
+  out << "{\"serial_number\":";
+  writeJsonString(out, info.getSerialNumber());
+  out << ",\"user_name\":";
+  writeJsonString(out, info.getUserName());
+  out << ",\"model_name\":";
+  writeJsonString(out, info.getModelName());
+  out << ",\"manufacturer_name\":";
+  writeJsonString(out, info.getManufacturerName());
+  out << ",\"manufacturer_info\":";
+  writeJsonString(out, info.getManufacturerInfo());
+  out << ",\"device_version\":";
+  writeJsonString(out, info.getDeviceVersion());
+  out << ",\"major_version\":" << info.getMajorVersion();
+  out << ",\"minor_version\":" << info.getMinorVersion();
+  out << ",\"mac\":\"" << mac2string(info.getMAC()) << '"';
+  out << ",\"ip\":\"" << ip2string(info.getIP()) << '"';
+  out << ",\"subnet_mask\":\"" << ip2string(info.getSubnetMask())
+      << '"';
+  out << ",\"gateway\":\"" << ip2string(info.getGateway()) << '"';
+  out << ",\"interface\":";
+  writeJsonString(out, info.getIfaceName());
+  out << '}';
+}
+
+/*
+  Writes a CSV field, quoted only if necessary (RFC 4180).
+*/
+
+void writeCsvField(std::ostream &out, const std::string &s)
+{
+  if (s.find_first_of(",\"\r\n") == std::string::npos)
+  {
+    out << s;
+    return;
+  }
+
+  out << '"';
+  for (const char c : s)
+  {
+    if (c == '"')
+    {
+      out << '"';
+    }
+    out << c;
+  }
+  out << '"';
+}
+
+class TableWriter : public DeviceWriter
+{
+  public:
+    TableWriter(std::ostream &out, bool iponly) :
+      DeviceWriter(out), iponly_(iponly)
+    { }
+
+    void finish() override
+    {
+      {
+        rcdiscover::ScopedTimer timer("dedup and sort");
+        RCDISCOVER_TRACE_SCOPE("dedup", infos_.size());
+        std::sort(infos_.begin(), infos_.end());
+      }
+
+      if (!iponly_)
+      {
+        out_ << "User name\tSerial number\tIP\t\tMAC\n";
+      }
+
+      for (const auto &info : infos_)
+      {
+        if (iponly_)
+        {
+          out_ << ip2string(info.getIP()) << '\n';
+          continue;
+        }
+
+        std::string name=info.getUserName();
+
+        if (name.size() == 0)
+        {
+          name=info.getModelName();
+        }
+
+        out_ << name << "\t";
+        out_ << info.getSerialNumber() << "\t";
+        out_ << ip2string(info.getIP()) << "\t";
+        out_ << mac2string(info.getMAC());
+
+        if (info.getModelName() != "rc_visard")
+        {
+          out_ << "\t[other GEV device]";
+        }
+
+        out_ << '\n';
+      }
+
+      out_.flush();
+    }
+
+  protected:
+    void writeDevice(const rcdiscover::DeviceInfo &info) override
+    {
+      infos_.push_back(info);
+    }
+
+  private:
+    bool iponly_;
+    std::vector<rcdiscover::DeviceInfo> infos_;
+};
+
+class JsonWriter : public DeviceWriter
+{
+  public:
+    explicit JsonWriter(std::ostream &out) : DeviceWriter(out), count_(0)
+    {
+      out_ << '[';
+    }
+
+    void finish() override
+    {
+      out_ << (count_ > 0 ? "\n]\n" : "]\n");
+      out_.flush();
+    }
+
+    void abort() override
+    {
+      finish();
+    }
+
+  protected:
+    void writeDevice(const rcdiscover::DeviceInfo &info) override
+    {
+      out_ << (count_ > 0 ? ",\n" : "\n");
+      writeJsonObject(out_, info);
+      out_.flush();
+      count_++;
+    }
+
+  private:
+    size_t count_;
+};
+
+class NdjsonWriter : public DeviceWriter
+{
+  public:
+    explicit NdjsonWriter(std::ostream &out) : DeviceWriter(out) { }
+
+    void finish() override
+    {
+      out_.flush();
+    }
+
+  protected:
+    void writeDevice(const rcdiscover::DeviceInfo &info) override
+    {
+      writeJsonObject(out_, info);
+      out_ << '\n';
+      out_.flush();
+    }
+};
+
+class CsvWriter : public DeviceWriter
+{
+  public:
+    explicit CsvWriter(std::ostream &out) : DeviceWriter(out)
+    {
+      out_ << "serial_number,user_name,model_name,manufacturer_name,"
+              "manufacturer_info,device_version,major_version,"
+              "minor_version,mac,ip,subnet_mask,gateway,interface\n";
+    }
+
+    void finish() override
+    {
+      out_.flush();
+    }
+
+  protected:
+    void writeDevice(const rcdiscover::DeviceInfo &info) override
+    {
+      writeCsvField(out_, info.getSerialNumber());
+      out_ << ',';
+      writeCsvField(out_, info.getUserName());
+      out_ << ',';
+      writeCsvField(out_, info.getModelName());
+      out_ << ',';
+      writeCsvField(out_, info.getManufacturerName());
+      out_ << ',';
+      writeCsvField(out_, info.getManufacturerInfo());
+      out_ << ',';
+      writeCsvField(out_, info.getDeviceVersion());
+      out_ << ',' << info.getMajorVersion() << ',' << info.getMinorVersion()
+           << ',' << mac2string(info.getMAC())
+           << ',' << ip2string(info.getIP())
+           << ',' << ip2string(info.getSubnetMask())
+           << ',' << ip2string(info.getGateway()) << ',';
+      writeCsvField(out_, info.getIfaceName());
+      out_ << '\n';
+      out_.flush();
+    }
+};
+
+}
+
+std::unique_ptr<DeviceWriter> DeviceWriter::create(const std::string &format,
+                                                   std::ostream &out)
+{
+  if (format == "table")
+  {
+    return std::unique_ptr<DeviceWriter>(new TableWriter(out, false));
+  }
+  else if (format == "ip")
+  {
+    return std::unique_ptr<DeviceWriter>(new TableWriter(out, true));
+  }
+  else if (format == "json")
+  {
+    return std::unique_ptr<DeviceWriter>(new JsonWriter(out));
+  }
+  else if (format == "ndjson")
+  {
+    return std::unique_ptr<DeviceWriter>(new NdjsonWriter(out));
+  }
+  else if (format == "csv")
+  {
+    return std::unique_ptr<DeviceWriter>(new CsvWriter(out));
+  }
+
+  throw std::invalid_argument("Unknown output format: " + format);
+}
+
+bool DeviceWriter::write(const rcdiscover::DeviceInfo &info)
+{
+  if (!info.isValid() || !written_.insert(info.getMAC()).second)
+  {
+    return false;
+  }
+
+  writeDevice(info);
+  return true;
+}
+
+void DeviceWriter::write(const std::vector<rcdiscover::DeviceInfo> &infos)
+{
+  for (const auto &info : infos)
+  {
+    write(info);
+  }
+}
@@ -0,0 +1,111 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DEVICEWRITER_H
+#define DEVICEWRITER_H
+
+#include "rcdiscover/deviceinfo.h"
+
+#include <ostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_set>
+
+/**
+ * @brief Writes discovered devices in one of the output formats of
+ * rcdiscover.
+ *
+ * Machine-readable formats (json, ndjson, csv) write each device as soon as
+ * it is passed and flush the stream once per device, so that consumers can
+ * act on the first device immediately. The table formats (table, ip) are
+ * written sorted by MAC address by finish().
+ */
+class DeviceWriter
+{
+  public:
+    /**
+     * @brief Creates a writer.
+     * @param format one of table, ip, json, ndjson or csv
+     * @param out output stream
+     * @return writer
+     * @throws std::invalid_argument if the format is unknown
+     */
+    static std::unique_ptr<DeviceWriter> create(const std::string &format,
+                                                std::ostream &out);
+
+    virtual ~DeviceWriter() = default;
+
+    /**
+     * @brief Writes a device. Invalid devices and devices with a MAC address
+     * that has already been written are ignored.
+     * @param info device
+     * @return true if the device has been written
+     */
+    bool write(const rcdiscover::DeviceInfo &info);
+
+    /**
+     * @brief Writes all given devices.
+     * @param infos devices
+     */
+    void write(const std::vector<rcdiscover::DeviceInfo> &infos);
+
+    /**
+     * @brief Completes the output. Must be called once after all devices.
+     */
+    virtual void finish() = 0;
+
+    /**
+     * @brief Completes the output after an error. Table formats write
+     * nothing, streaming formats are kept well-formed.
+     */
+    virtual void abort() { out_.flush(); }
+
+  protected:
+    explicit DeviceWriter(std::ostream &out) : out_(out) { }
+
+    /**
+     * @brief Writes a device that has not been written before.
+     * @param info valid device
+     */
+    virtual void writeDevice(const rcdiscover::DeviceInfo &info) = 0;
+
+    std::ostream &out_;
+
+  private:
+    std::unordered_set<uint64_t> written_;
+};
+
+#endif // DEVICEWRITER_H
@@ -0,0 +1,252 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "discovery.h"
+
+#include "rcdiscover/iface_affinity.h"
+
+#ifdef HAVE_PCAP
+#include "rcdiscover/pcap.h"
+#endif
+
+#include <algorithm>
+#include <iostream>
+#include <thread>
+#include <unordered_set>
+
+/*
+  Removes all devices that are invalid or do not match the filter and keeps
+  at most count different devices, if count is not 0. Returns the number of
+  different devices.
+*/
+
+size_t selectDevices(std::vector<rcdiscover::DeviceInfo> &infos,
+                   const rcdiscover::DeviceFilter &filter, size_t count)
+{
+  std::unordered_set<uint64_t> macs;
+  std::vector<rcdiscover::DeviceInfo> selected;
+
+  for (const auto &info : infos)
+  {
+    if (!info.isValid() || !filter.matches(info))
+    {
+      continue;
+    }
+
+    if (macs.find(info.getMAC()) == macs.end())
+    {
+      if (count > 0 && macs.size() >= count)
+      {
+        continue;
+      }
+
+      macs.insert(info.getMAC());
+    }
+
+    selected.push_back(info);
+  }
+
+  infos.swap(selected);
+
+  return macs.size();
+}
+
+/*
+  Receives responses until there are no more within the given timeout or
+  until count devices have been found, if count is not 0. Each device is
+  passed to the writer as soon as it arrives. Returns the number of devices
+  that have been written.
+*/
+
+size_t receiveResponses(rcdiscover::Discover &discover,
+                        std::vector<rcdiscover::DeviceInfo> &infos,
+                        DeviceWriter &writer, size_t count, int timeout)
+{
+  size_t n=infos.size();
+  size_t found=0;
+
+  bool more=true;
+  while (more && (count == 0 || found < count))
+  {
+    more=discover.getResponse(infos, timeout);
+
+    for (; n<infos.size() && (count == 0 || found < count); n++)
+    {
+      if (writer.write(infos[n]))
+      {
+        found++;
+      }
+    }
+  }
+
+  rcdiscover::IfaceAffinity::update(infos);
+
+  return found;
+}
+
+/*
+  Discovers devices in one session until all given serial numbers have been
+  found or the deadline has passed. The request is broadcast again after an
+  interval that starts short and is doubled whenever no expected device has
+  answered, since devices that are booting tend to appear close together.
+  Returns 0 if all devices have been found and 1 otherwise.
+*/
+
+int waitForDevices(const std::vector<std::string> &serials,
+                   std::chrono::milliseconds deadline,
+                   const rcdiscover::InterfaceSelection &ifaces,
+                   const std::shared_ptr<rcdiscover::DeviceFilter> &filter,
+                   DeviceWriter &writer)
+{
+  const std::chrono::milliseconds min_interval(200);
+  const std::chrono::milliseconds max_interval(5000);
+
+  std::unordered_set<std::string> missing(serials.begin(), serials.end());
+
+  try
+  {
+    const auto end=std::chrono::steady_clock::now()+deadline;
+
+    rcdiscover::Discover discover(ifaces);
+    discover.setFilter(filter);
+
+    std::vector<rcdiscover::DeviceInfo> infos;
+    auto interval=min_interval;
+
+    while (missing.size() > 0 && std::chrono::steady_clock::now() < end)
+    {
+      // interfaces that are not up yet are retried with the next broadcast
+
+      discover.tryBroadcastRequest();
+
+      const auto next=std::min(end, std::chrono::steady_clock::now()+interval);
+      bool progress=false;
+
+      std::chrono::steady_clock::time_point now;
+      while (missing.size() > 0 && (now=std::chrono::steady_clock::now()) < next)
+      {
+        const int timeout=static_cast<int>(std::min<long long>(100,
+          std::chrono::duration_cast<std::chrono::milliseconds>(
+            next-now).count()+1));
+
+        infos.clear();
+        discover.getResponse(infos, timeout);
+
+        for (const auto &info : infos)
+        {
+          if (writer.write(info) && missing.erase(info.getSerialNumber()) > 0)
+          {
+            progress=true;
+          }
+        }
+      }
+
+      interval=progress ? min_interval : std::min(2*interval, max_interval);
+    }
+  }
+  catch(const std::exception &ex)
+  {
+    writer.abort();
+    std::cerr << "Error: " << ex.what() << std::endl;
+    return 1;
+  }
+
+  writer.finish();
+
+  if (missing.size() > 0)
+  {
+    std::cerr << "Missing after deadline:";
+    for (const auto &serial : serials)
+    {
+      if (missing.find(serial) != missing.end())
+      {
+        std::cerr << " " << serial;
+      }
+    }
+    std::cerr << std::endl;
+
+    return 1;
+  }
+
+  return 0;
+}
+
+#ifdef HAVE_PCAP
+
+/*
+  Feeds all discovery acknowledges of a pcap file through the same decoding as
+  live responses.
+*/
+
+void replayCapture(const std::string &filename, bool realtime,
+                   std::vector<rcdiscover::DeviceInfo> &infos)
+{
+  rcdiscover::PcapReader reader(filename);
+  rcdiscover::PcapPacket packet;
+
+  bool first = true;
+  uint64_t t0 = 0;
+  const auto start = std::chrono::steady_clock::now();
+
+  while (reader.next(packet))
+  {
+    if (realtime)
+    {
+      const uint64_t t = static_cast<uint64_t>(packet.ts_sec)*1000000 +
+                         packet.ts_usec;
+
+      if (first)
+      {
+        t0 = t;
+        first = false;
+      }
+
+      if (t > t0)
+      {
+        std::this_thread::sleep_until(start +
+                                      std::chrono::microseconds(t-t0));
+      }
+    }
+
+    rcdiscover::DeviceInfo info;
+    if (rcdiscover::Discover::decodeResponse(packet.payload.data(),
+                                             packet.payload.size(), info))
+    {
+      infos.push_back(info);
+    }
+  }
+}
+
+#endif
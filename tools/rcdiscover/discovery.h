@@ -0,0 +1,112 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DISCOVERY_H
+#define DISCOVERY_H
+
+#include "device-writer.h"
+
+#include "rcdiscover/discover.h"
+#include "rcdiscover/deviceinfo.h"
+#include "rcdiscover/device_filter.h"
+#include "rcdiscover/iface_selection.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Removes all devices that are invalid or do not match the filter and
+ * keeps at most count different devices.
+ * @param infos devices
+ * @param filter filter
+ * @param count maximum number of different devices, 0 for no limit
+ * @return number of different devices
+ */
+size_t selectDevices(std::vector<rcdiscover::DeviceInfo> &infos,
+                     const rcdiscover::DeviceFilter &filter, size_t count);
+
+/**
+ * @brief Receives responses until there are no more within the timeout or
+ * until count devices have been found. Each device is passed to the writer
+ * as soon as it arrives.
+ * @param discover discover object on which a request has been sent
+ * @param infos all received responses are appended
+ * @param writer writer
+ * @param count number of devices after which receiving stops, 0 for no limit
+ * @param timeout timeout per socket in milliseconds
+ * @return number of devices that have been written
+ */
+size_t receiveResponses(rcdiscover::Discover &discover,
+                        std::vector<rcdiscover::DeviceInfo> &infos,
+                        DeviceWriter &writer, size_t count, int timeout=100);
+
+/**
+ * @brief Discovers devices in one session until all given serial numbers
+ * have been found or the deadline has passed.
+ *
+ * The request is broadcast again after an interval that starts short and is
+ * doubled whenever no expected device has answered, since devices that are
+ * booting tend to appear close together.
+ * @param serials serial numbers of the expected devices
+ * @param deadline maximum time for waiting
+ * @param ifaces interfaces on which devices are discovered
+ * @param filter filter for responses
+ * @param writer writer for all matching devices
+ * @return 0 if all devices have been found and 1 otherwise
+ */
+int waitForDevices(const std::vector<std::string> &serials,
+                   std::chrono::milliseconds deadline,
+                   const rcdiscover::InterfaceSelection &ifaces,
+                   const std::shared_ptr<rcdiscover::DeviceFilter> &filter,
+                   DeviceWriter &writer);
+
+#ifdef HAVE_PCAP
+
+/**
+ * @brief Feeds all discovery acknowledges of a pcap file through the same
+ * decoding as live responses.
+ * @param filename pcap file
+ * @param realtime true for replaying with the timing of the capture
+ * @param infos decoded devices are appended
+ * @throws std::runtime_error if the file cannot be read
+ */
+void replayCapture(const std::string &filename, bool realtime,
+                   std::vector<rcdiscover::DeviceInfo> &infos);
+
+#endif
+
+#endif // DISCOVERY_H
@@ -0,0 +1,83 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "duration.h"
+
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+#include <ctime>
+
+/*
+  Converts a duration like 7d, 24h, 30m or 60s into milliseconds.
+*/
+
+uint64_t parseDuration(const std::string &s)
+{
+  size_t pos = 0;
+  unsigned long long v = 0;
+
+  try
+  {
+    v = std::stoull(s, &pos);
+  }
+  catch(const std::exception &)
+  {
+    throw std::invalid_argument("Invalid duration: " + s);
+  }
+
+  const std::string unit = s.substr(pos);
+
+  if (unit == "d") return v*24*3600*1000;
+  if (unit == "h") return v*3600*1000;
+  if (unit == "m") return v*60*1000;
+  if (unit == "ms") return v;
+  if (unit == "s" || unit.empty()) return v*1000;
+
+  throw std::invalid_argument("Invalid duration: " + s);
+}
+
+std::string formatTime(uint64_t ms)
+{
+  const std::time_t t = static_cast<std::time_t>(ms/1000);
+
+  char buf[32];
+  std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", std::localtime(&t));
+
+  std::ostringstream out;
+  out << buf << '.' << std::setw(3) << std::setfill('0') << ms%1000;
+
+  return out.str();
+}
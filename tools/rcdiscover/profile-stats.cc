@@ -0,0 +1,189 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "profile-stats.h"
+
+#include "rcdiscover/profile.h"
+
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+namespace
+{
+
+/*
+  Formats a latency in milliseconds, or '-' if there was no response.
+*/
+
+std::string formatLatency(std::chrono::microseconds latency)
+{
+  if (latency.count() < 0)
+  {
+    return "-";
+  }
+
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(1)
+      << static_cast<double>(latency.count())/1000.0;
+  return out.str();
+}
+
+}
+
+/*
+  Splits the waiting for responses into the time to the first acknowledge,
+  the time in which further acknowledges arrived and the final timeout, as
+  measured by the statistics of the interfaces.
+*/
+
+void recordResponsePhases(const std::vector<rcdiscover::IfaceStats> &stats,
+                          std::chrono::steady_clock::time_point wait_start)
+{
+  const auto wait_end=std::chrono::steady_clock::now();
+
+  std::chrono::microseconds first(-1), last(-1);
+  for (const auto &st : stats)
+  {
+    if (st.first_response.count() >= 0 &&
+        (first.count() < 0 || st.first_response < first))
+    {
+      first=st.first_response;
+    }
+
+    last=std::max(last, st.last_response);
+  }
+
+  if (first.count() < 0)
+  {
+    rcdiscover::Profile::record("tail wait", wait_start, wait_end-wait_start, 1);
+    return;
+  }
+
+  // latencies are measured from the broadcast, which ended shortly before
+  // waiting started
+
+  const auto first_end=std::min(wait_end, wait_start+first);
+  const auto last_end=std::min(wait_end, wait_start+last);
+
+  rcdiscover::Profile::record("time to first ACK", wait_start,
+                              first_end-wait_start, 1);
+  rcdiscover::Profile::record("drain", first_end, last_end-first_end, 1);
+  rcdiscover::Profile::record("tail wait", last_end, wait_end-last_end, 1);
+}
+
+/*
+  Prints all phases with nested phases indented, followed by the total time.
+*/
+
+void printProfile(std::chrono::nanoseconds total)
+{
+  std::cerr << std::endl;
+  std::cerr << std::left << std::setw(30) << "Phase" << std::right
+            << std::setw(11) << "ms" << std::setw(10) << "calls" << std::endl;
+
+  std::chrono::nanoseconds sum(0);
+  for (const auto &entry : rcdiscover::Profile::getEntries())
+  {
+    if (entry.depth == 0)
+    {
+      sum+=entry.total;
+    }
+
+    std::string name=std::string(2*static_cast<size_t>(entry.depth), ' ')+
+                     entry.phase;
+
+    std::cerr << std::left << std::setw(30) << name << std::right
+              << std::fixed << std::setprecision(3) << std::setw(11)
+              << static_cast<double>(entry.total.count())/1e6
+              << std::setw(10) << entry.calls << std::endl;
+  }
+
+  std::cerr << std::left << std::setw(30) << "other" << std::right
+            << std::setw(11)
+            << static_cast<double>((total-sum).count())/1e6 << std::endl;
+  std::cerr << std::left << std::setw(30) << "total" << std::right
+            << std::setw(11)
+            << static_cast<double>(total.count())/1e6 << std::endl;
+}
+
+/*
+  Prints the counters of each interface and a short assessment to stderr, so
+  that the device list on stdout can still be processed by scripts.
+*/
+
+void printStats(const std::vector<rcdiscover::IfaceStats> &stats)
+{
+  std::cerr << std::endl;
+  std::cerr << "Interface\tSent\tErrors\tACKs\tValid\tInvalid\tFilter"
+               "\tDup\tDrops\tFirst ms\tLast ms\tState" << std::endl;
+
+  for (const auto &st : stats)
+  {
+    std::string state="ok";
+    if (st.broadcasts_sent == 0 &&
+        st.last_error == std::errc::network_unreachable)
+    {
+      state="down";
+    }
+    else if (st.broadcasts_sent == 0 && st.send_errors > 0)
+    {
+      state="send error: "+st.last_error.message();
+    }
+    else if (st.kernel_drops > 0)
+    {
+      state="packages dropped by host";
+    }
+    else if (st.acks_valid == 0 && st.acks_filtered > 0)
+    {
+      state="no matching response";
+    }
+    else if (st.acks_valid == 0)
+    {
+      state="no response";
+    }
+
+    std::cerr << st.iface_name << "\t" << st.broadcasts_sent << "\t"
+              << st.send_errors << "\t" << st.acks_received << "\t"
+              << st.acks_valid << "\t" << st.acks_invalid << "\t"
+              << st.acks_filtered << "\t"
+              << st.duplicates << "\t" << st.kernel_drops << "\t"
+              << formatLatency(st.first_response) << "\t\t"
+              << formatLatency(st.last_response) << "\t"
+              << state << std::endl;
+  }
+}
@@ -0,0 +1,70 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PROFILESTATS_H
+#define PROFILESTATS_H
+
+#include "rcdiscover/iface_stats.h"
+
+#include <chrono>
+#include <vector>
+
+/**
+ * @brief Splits the waiting for responses into the time to the first
+ * acknowledge, the time in which further acknowledges arrived and the final
+ * timeout, as measured by the statistics of the interfaces, and records them
+ * as profile phases.
+ * @param stats statistics of all interfaces
+ * @param wait_start time at which waiting for responses started
+ */
+void recordResponsePhases(const std::vector<rcdiscover::IfaceStats> &stats,
+                          std::chrono::steady_clock::time_point wait_start);
+
+/**
+ * @brief Prints all profile phases to stderr with nested phases indented,
+ * followed by the total time.
+ * @param total total run time
+ */
+void printProfile(std::chrono::nanoseconds total);
+
+/**
+ * @brief Prints the counters of each interface and a short assessment to
+ * stderr, so that the device list on stdout can still be processed by
+ * scripts.
+ * @param stats statistics of all interfaces
+ */
+void printStats(const std::vector<rcdiscover::IfaceStats> &stats);
+
+#endif // PROFILESTATS_H
@@ -0,0 +1,177 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "watch.h"
+#include "duration.h"
+
+#include "rcdiscover/continuous_discover.h"
+#include "rcdiscover/fleet.h"
+#include "rcdiscover/utils.h"
+
+#include <iostream>
+#include <map>
+#include <thread>
+
+namespace
+{
+
+/*
+  Prints a change of the device table as one line with time stamp, type,
+  name, serial number, IP and MAC address. For changed devices, the old and
+  new values of the changed fields are appended.
+*/
+
+void printWatchEvent(const rcdiscover::FleetEvent &ev,
+                     std::map<uint64_t, rcdiscover::DeviceInfo> &last)
+{
+  const rcdiscover::DeviceInfo &info=ev.info;
+
+  std::string name=info.getUserName();
+  if (name.size() == 0)
+  {
+    name=info.getModelName();
+  }
+
+  const uint64_t now=static_cast<uint64_t>(
+    std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count());
+
+  std::cout << formatTime(now) << "\t";
+
+  switch (ev.type)
+  {
+    case rcdiscover::FleetEvent::APPEARED: std::cout << "new"; break;
+    case rcdiscover::FleetEvent::DISAPPEARED: std::cout << "gone"; break;
+    case rcdiscover::FleetEvent::CHANGED: std::cout << "changed"; break;
+  }
+
+  std::cout << "\t" << name << "\t" << info.getSerialNumber() << "\t"
+            << ip2string(info.getIP()) << "\t" << mac2string(info.getMAC());
+
+  if (ev.type == rcdiscover::FleetEvent::CHANGED)
+  {
+    const rcdiscover::DeviceInfo &old=last[info.getMAC()];
+
+    if (ev.changed & rcdiscover::FleetEvent::IP)
+    {
+      std::cout << "\tip " << ip2string(old.getIP()) << " -> "
+                << ip2string(info.getIP());
+    }
+
+    if (ev.changed & rcdiscover::FleetEvent::SUBNET)
+    {
+      std::cout << "\tsubnet " << ip2string(old.getSubnetMask()) << " -> "
+                << ip2string(info.getSubnetMask());
+    }
+
+    if (ev.changed & rcdiscover::FleetEvent::GATEWAY)
+    {
+      std::cout << "\tgateway " << ip2string(old.getGateway()) << " -> "
+                << ip2string(info.getGateway());
+    }
+
+    if (ev.changed & rcdiscover::FleetEvent::USER_NAME)
+    {
+      std::cout << "\tname '" << old.getUserName() << "' -> '"
+                << info.getUserName() << "'";
+    }
+  }
+
+  std::cout << std::endl;
+
+  if (ev.type == rcdiscover::FleetEvent::DISAPPEARED)
+  {
+    last.erase(info.getMAC());
+  }
+  else
+  {
+    last[info.getMAC()]=info;
+  }
+}
+
+}
+
+/*
+  Discovers devices repeatedly with the same sockets and prints the changes
+  between rounds. Runs until the process is terminated.
+*/
+
+int watchDevices(std::chrono::milliseconds interval, int expire,
+                 const rcdiscover::InterfaceSelection &ifaces,
+                 const std::shared_ptr<rcdiscover::DeviceFilter> &filter)
+{
+  try
+  {
+    rcdiscover::ContinuousDiscover discover(ifaces);
+
+    if (!filter->empty())
+    {
+      discover.setFilter(filter);
+    }
+
+    rcdiscover::Fleet fleet(expire);
+    std::map<uint64_t, rcdiscover::DeviceInfo> last;
+
+    fleet.subscribe([&last](const rcdiscover::FleetEvent &ev)
+    {
+      printWatchEvent(ev, last);
+    });
+
+    while (true)
+    {
+      const auto start=std::chrono::steady_clock::now();
+
+      // temporary errors, e.g. of interfaces that are down, do not end
+      // watching
+
+      try
+      {
+        fleet.update(discover.scan());
+      }
+      catch(const std::exception &ex)
+      {
+        std::cerr << "Error: " << ex.what() << std::endl;
+      }
+
+      std::this_thread::sleep_until(start+interval);
+    }
+  }
+  catch(const std::exception &ex)
+  {
+    std::cerr << "Error: " << ex.what() << std::endl;
+  }
+
+  return 1;
+}
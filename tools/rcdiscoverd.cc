@@ -0,0 +1,419 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "rcdiscoverd/query-server.h"
+#include "rcdiscoverd/metrics-server.h"
+
+#include "rcdiscover/discover_service.h"
+#include "rcdiscover/fleet.h"
+#include "rcdiscover/daemon_protocol.h"
+#include "rcdiscover/fleet_shm.h"
+#include "rcdiscover/presence_log.h"
+#include "rcdiscover/metrics.h"
+#include "rcdiscover/trace.h"
+
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+
+#include <signal.h>
+#include <sys/stat.h>
+#include <errno.h>
+
+namespace
+{
+
+volatile sig_atomic_t running = 1;
+
+void onSignal(int)
+{
+  running = 0;
+}
+
+void printHelp(const char *prog)
+{
+  std::cout << prog << " [--socket <path>] [--socket-mode <mode>] [--interval <ms>]" << std::endl;
+  std::cout << "            [--expire <n>] [--shm <name>] [--history <file>] [--metrics-file <file>]" << std::endl;
+  std::cout << "            [--include-iface <pattern>] [--exclude-iface <pattern>]" << std::endl;
+  std::cout << "            [--metrics-port <port> [--metrics-address <ip>]]" << std::endl;
+#ifdef HAVE_TRACING
+  std::cout << "            [--trace <file.json>]" << std::endl;
+#endif
+  std::cout << std::endl;
+  std::cout << "Discovers devices continuously, answers queries and publishes change events" << std::endl;
+  std::cout << "on a UNIX domain socket." << std::endl;
+  std::cout << std::endl;
+  std::cout << "--socket <path>     Path of query socket (default: " << rcdiscover::getDaemonDefaultSocket() << ")" << std::endl;
+  std::cout << "--socket-mode <mode>" << std::endl;
+  std::cout << "                    Octal permissions of the query socket, e.g. 666 for allowing" << std::endl;
+  std::cout << "                    all local users to query (default: according to umask)" << std::endl;
+  std::cout << "--interval <ms>     Time between two discovery rounds (default: 1000)" << std::endl;
+  std::cout << "--expire <n>        Number of rounds without answer after which a device is" << std::endl;
+  std::cout << "                    removed (default: 3)" << std::endl;
+  std::cout << "--shm <name>        Additionally publish the devices in the POSIX shared memory" << std::endl;
+  std::cout << "                    segment with the given name, e.g. " << rcdiscover::FLEET_SHM_DEFAULT_NAME << std::endl;
+  std::cout << "--history <file>    Append all appearing, disappearing and changing devices to" << std::endl;
+  std::cout << "                    the given presence log (see rcdiscover --history)" << std::endl;
+  std::cout << "--include-iface <pattern>" << std::endl;
+  std::cout << "                    Only discover on interfaces whose name matches the pattern," << std::endl;
+  std::cout << "                    which may contain * and ?, or whose address is in the" << std::endl;
+  std::cout << "                    subnet, e.g. eth* or 10.0.2.0/24. Can be given several times" << std::endl;
+  std::cout << "--exclude-iface <pattern>" << std::endl;
+  std::cout << "                    Do not discover on matching interfaces, e.g. docker*" << std::endl;
+  std::cout << "--metrics-file <file>" << std::endl;
+  std::cout << "                    Write metrics in Prometheus text format to the file after" << std::endl;
+  std::cout << "                    each round, e.g. for the textfile collector of node_exporter" << std::endl;
+  std::cout << "--metrics-port <port>" << std::endl;
+  std::cout << "                    Serve metrics in Prometheus text format via HTTP on the port" << std::endl;
+  std::cout << "--metrics-address <ip>" << std::endl;
+  std::cout << "                    Address on which metrics are served (default: 127.0.0.1)" << std::endl;
+#ifdef HAVE_TRACING
+  std::cout << "--trace <file>      Write the most recent trace events in Chrome trace format to" << std::endl;
+  std::cout << "                    the file on exit" << std::endl;
+#endif
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+  std::string socket_path;
+  int socket_mode=-1;
+  int interval=1000;
+  int expire=3;
+  std::string shm_name;
+  std::string history;
+  std::string metrics_file;
+  int metrics_port=0;
+  std::string metrics_address="127.0.0.1";
+  std::string trace;
+  std::vector<std::string> iface_includes, iface_excludes;
+
+  for (int i=1; i<argc; i++)
+  {
+    if (std::strcmp(argv[i], "--socket") == 0 && i+1 < argc)
+    {
+      socket_path=argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--socket-mode") == 0 && i+1 < argc)
+    {
+      char *end;
+      const long mode=std::strtol(argv[++i], &end, 8);
+
+      if (argv[i][0] == '\0' || *end != '\0' || mode < 0 || mode > 0777)
+      {
+        std::cerr << "Invalid socket mode: " << argv[i] << std::endl;
+        return 1;
+      }
+
+      socket_mode=static_cast<int>(mode);
+    }
+    else if (std::strcmp(argv[i], "--interval") == 0 && i+1 < argc)
+    {
+      interval=std::max(10, std::atoi(argv[++i]));
+    }
+    else if (std::strcmp(argv[i], "--expire") == 0 && i+1 < argc)
+    {
+      expire=std::max(1, std::atoi(argv[++i]));
+    }
+    else if (std::strcmp(argv[i], "--shm") == 0 && i+1 < argc)
+    {
+      shm_name=argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--history") == 0 && i+1 < argc)
+    {
+      history=argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--include-iface") == 0 && i+1 < argc)
+    {
+      iface_includes.push_back(argv[++i]);
+    }
+    else if (std::strcmp(argv[i], "--exclude-iface") == 0 && i+1 < argc)
+    {
+      iface_excludes.push_back(argv[++i]);
+    }
+    else if (std::strcmp(argv[i], "--metrics-file") == 0 && i+1 < argc)
+    {
+      metrics_file=argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--metrics-port") == 0 && i+1 < argc)
+    {
+      metrics_port=std::atoi(argv[++i]);
+    }
+    else if (std::strcmp(argv[i], "--metrics-address") == 0 && i+1 < argc)
+    {
+      metrics_address=argv[++i];
+    }
+#ifdef HAVE_TRACING
+    else if (std::strcmp(argv[i], "--trace") == 0 && i+1 < argc)
+    {
+      trace=argv[++i];
+    }
+#endif
+    else if (std::strcmp(argv[i], "-h") == 0 ||
+             std::strcmp(argv[i], "--help") == 0)
+    {
+      printHelp(argv[0]);
+      return 0;
+    }
+    else
+    {
+      std::cerr << "Invalid argument: " << argv[i] << std::endl;
+      printHelp(argv[0]);
+      return 1;
+    }
+  }
+
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+  signal(SIGPIPE, SIG_IGN);
+
+  // the directory of the system wide socket is created on demand, e.g. after
+  // a reboot
+
+  if (socket_path.empty())
+  {
+    socket_path=rcdiscover::getDaemonDefaultSocket();
+
+    if (socket_path == rcdiscover::DAEMON_SYSTEM_SOCKET)
+    {
+      const std::string dir=socket_path.substr(0, socket_path.rfind('/'));
+      if (::mkdir(dir.c_str(), 0755) == -1 && errno != EEXIST)
+      {
+        std::cerr << "Error: Cannot create " << dir << ": "
+                  << std::strerror(errno) << std::endl;
+        return 1;
+      }
+    }
+  }
+
+  rcdiscover::Fleet fleet(expire);
+
+  try
+  {
+    rcdiscover::InterfaceSelection ifaces;
+    for (const auto &p : iface_includes)
+    {
+      ifaces.include(p);
+    }
+
+    for (const auto &p : iface_excludes)
+    {
+      ifaces.exclude(p);
+    }
+
+    // periodic rounds and scan requests of clients share the sockets and
+    // rounds that overlap
+
+    rcdiscover::DiscoverService service(ifaces);
+
+    QueryServer server(socket_path, fleet, socket_mode);
+    server.setDiscoverService(&service);
+
+    std::unique_ptr<rcdiscover::FleetShmWriter> shm;
+    if (shm_name.size() > 0)
+    {
+      shm.reset(new rcdiscover::FleetShmWriter(shm_name));
+    }
+
+    std::unique_ptr<rcdiscover::PresenceLogWriter> log;
+    if (history.size() > 0)
+    {
+      log.reset(new rcdiscover::PresenceLogWriter(history));
+    }
+
+    std::unique_ptr<MetricsServer> metrics_server;
+    if (metrics_port > 0 && metrics_port < 65536)
+    {
+      metrics_server.reset(new MetricsServer(metrics_address,
+                                             static_cast<uint16_t>(metrics_port)));
+    }
+
+
+    // errors of the presence log must not keep events from subscribers and
+    // are only reported once until appending succeeds again
+
+    bool log_failed=false;
+
+    const int subscription = fleet.subscribe(
+      [&server, &log, &log_failed](const rcdiscover::FleetEvent &event)
+    {
+      if (log)
+      {
+        try
+        {
+          log->append(event, static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+              std::chrono::system_clock::now().time_since_epoch()).count()));
+
+          log_failed=false;
+        }
+        catch(const std::exception &ex)
+        {
+          if (!log_failed)
+          {
+            std::cerr << "Error while writing presence log: " << ex.what()
+                      << std::endl;
+          }
+
+          log_failed=true;
+        }
+      }
+
+      server.notify();
+    });
+
+    std::atomic<bool> scanning(true);
+    std::mutex scan_mtx;
+    std::condition_variable scan_cv;
+
+    std::thread scanner([&]
+    {
+      while (scanning)
+      {
+        const auto start=std::chrono::steady_clock::now();
+        auto next=start+std::chrono::milliseconds(interval);
+
+        try
+        {
+          // the round of a client that asked shortly before is used instead
+          // of starting another one
+
+          const auto r=service.discover(std::chrono::milliseconds(interval/2));
+
+          fleet.update(r);
+
+          if (shm)
+          {
+            shm->publish(fleet.getDevices());
+          }
+
+          if (metrics_file.size() > 0)
+          {
+            try
+            {
+              rcdiscover::Metrics::writeTextfile(metrics_file);
+            }
+            catch(const std::exception &ex)
+            {
+              std::cerr << "Error: " << ex.what() << std::endl;
+            }
+          }
+        }
+        catch(const std::exception &ex)
+        {
+          std::cerr << "Error during discovery: " << ex.what() << std::endl;
+          next=std::max(next, start+std::chrono::milliseconds(1000));
+        }
+
+        std::unique_lock<std::mutex> lock(scan_mtx);
+        scan_cv.wait_until(lock, next, [&scanning] { return !scanning; });
+      }
+    });
+
+    // scrapes are answered independently of queries and discovery
+
+    std::thread metrics_thread([&]
+    {
+      while (metrics_server && scanning)
+      {
+        metrics_server->process(200);
+      }
+    });
+
+    // the index of the presence log is updated regularly, so that only
+    // few records must be searched linearly by readers
+
+    auto index_time = std::chrono::steady_clock::now();
+
+    while (running)
+    {
+      server.process(200);
+
+      if (log && std::chrono::steady_clock::now() - index_time >
+          std::chrono::hours(1))
+      {
+        try
+        {
+          log->writeIndex();
+        }
+        catch(const std::exception &ex)
+        {
+          std::cerr << "Error: " << ex.what() << std::endl;
+        }
+
+        index_time = std::chrono::steady_clock::now();
+      }
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(scan_mtx);
+      scanning = false;
+    }
+
+    scan_cv.notify_all();
+    scanner.join();
+    metrics_thread.join();
+
+    fleet.unsubscribe(subscription);
+
+    if (log)
+    {
+      log->writeIndex();
+    }
+
+#ifdef HAVE_TRACING
+    if (trace.size() > 0)
+    {
+      rcdiscover::Trace::writeChromeJson(trace);
+    }
+#endif
+  }
+  catch(const std::exception &ex)
+  {
+    std::cerr << "Error: " << ex.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
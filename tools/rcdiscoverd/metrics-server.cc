@@ -0,0 +1,205 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "metrics-server.h"
+
+#include "rcdiscover/metrics.h"
+#include "rcdiscover/socket_exception.h"
+
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <errno.h>
+#include <string.h>
+
+#include <stdexcept>
+
+namespace
+{
+
+const size_t MAX_REQUEST_LENGTH = 4096;
+
+/*
+  Sends all data, returns false on error or timeout.
+*/
+
+bool sendAll(int fd, const std::string &data)
+{
+  size_t pos = 0;
+  while (pos < data.size())
+  {
+    const ssize_t n = ::send(fd, data.data()+pos, data.size()-pos,
+                             MSG_NOSIGNAL);
+
+    if (n <= 0)
+    {
+      return false;
+    }
+
+    pos += static_cast<size_t>(n);
+  }
+
+  return true;
+}
+
+std::string response(const char *status, const std::string &body)
+{
+  return std::string("HTTP/1.0 ") + status + "\r\n"
+         "Content-Type: text/plain; version=0.0.4\r\n"
+         "Content-Length: " + std::to_string(body.size()) + "\r\n"
+         "Connection: close\r\n\r\n" + body;
+}
+
+}
+
+MetricsServer::MetricsServer(const std::string &address, uint16_t port) :
+  fd_(-1)
+{
+  sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+
+  if (inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1)
+  {
+    throw std::invalid_argument("Invalid address: " + address);
+  }
+
+  fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+  if (fd_ == -1)
+  {
+    throw rcdiscover::SocketException("Error while creating socket", errno);
+  }
+
+  const int yes = 1;
+  ::setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+  if (::bind(fd_, reinterpret_cast<const sockaddr *>(&addr),
+             sizeof(addr)) == -1 || ::listen(fd_, 16) == -1)
+  {
+    const int err = errno;
+    ::close(fd_);
+    throw rcdiscover::SocketException("Error while binding to port " +
+                                      std::to_string(port), err);
+  }
+
+  ::fcntl(fd_, F_SETFL, ::fcntl(fd_, F_GETFL, 0) | O_NONBLOCK);
+}
+
+MetricsServer::~MetricsServer()
+{
+  ::close(fd_);
+}
+
+void MetricsServer::process(int timeout_ms)
+{
+  pollfd pfd;
+  pfd.fd = fd_;
+  pfd.events = POLLIN;
+  pfd.revents = 0;
+
+  if (::poll(&pfd, 1, timeout_ms) <= 0)
+  {
+    return;
+  }
+
+  const int fd = ::accept(fd_, nullptr, nullptr);
+  if (fd == -1)
+  {
+    return;
+  }
+
+  // a slow or stalled client must not block further scrapes for long
+
+  timeval tv;
+  tv.tv_sec = 1;
+  tv.tv_usec = 0;
+  ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+  serve(fd);
+
+  ::close(fd);
+}
+
+void MetricsServer::serve(int fd)
+{
+  // read the request header, the body of GET requests is empty
+
+  std::string request;
+  while (request.find("\r\n\r\n") == std::string::npos &&
+         request.find("\n\n") == std::string::npos)
+  {
+    char buf[1024];
+    const ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+
+    if (n <= 0 || request.size() + static_cast<size_t>(n) > MAX_REQUEST_LENGTH)
+    {
+      return;
+    }
+
+    request.append(buf, static_cast<size_t>(n));
+  }
+
+  const std::string line = request.substr(0, request.find_first_of("\r\n"));
+
+  if (line.compare(0, 4, "GET ") != 0 && line.compare(0, 5, "HEAD ") != 0)
+  {
+    sendAll(fd, response("405 Method Not Allowed", ""));
+    return;
+  }
+
+  const size_t start = line.find(' ') + 1;
+  const std::string path = line.substr(start, line.find(' ', start) - start);
+
+  if (path != "/metrics" && path != "/")
+  {
+    sendAll(fd, response("404 Not Found", ""));
+    return;
+  }
+
+  std::string answer = response("200 OK", rcdiscover::Metrics::format());
+
+  if (line[0] == 'H')
+  {
+    answer.erase(answer.find("\r\n\r\n") + 4);
+  }
+
+  sendAll(fd, answer);
+}
@@ -0,0 +1,627 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "query-server.h"
+
+#include "rcdiscover/fleet.h"
+#include "rcdiscover/discover_service.h"
+#include "rcdiscover/daemon_protocol.h"
+#include "rcdiscover/socket_exception.h"
+#include "rcdiscover/utils.h"
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <errno.h>
+#include <string.h>
+
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+
+const size_t MAX_REQUEST_LENGTH = 1024;
+const size_t MAX_PENDING_OUTPUT = 1024*1024;
+
+/*
+  Formats the answer of a request that results in the given devices.
+*/
+
+std::string formatDevices(const std::vector<rcdiscover::DeviceInfo> &devices)
+{
+  std::string ret;
+  for (const auto &info : devices)
+  {
+    ret += rcdiscover::formatDeviceRecord(info);
+    ret += '\n';
+  }
+  ret += '\n';
+
+  return ret;
+}
+
+}
+
+QueryServer::QueryServer(const std::string &path,
+                         const rcdiscover::Fleet &fleet, int mode) :
+  path_(path),
+  fd_(-1),
+  fleet_(fleet),
+  service_(nullptr),
+  next_id_(0)
+{
+  sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+
+  if (path.size() >= sizeof(addr.sun_path))
+  {
+    throw std::invalid_argument("Socket path too long: " + path);
+  }
+
+  strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path)-1);
+
+  fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd_ == -1)
+  {
+    throw rcdiscover::SocketException("Error while creating socket", errno);
+  }
+
+  // remove stale socket of a previous daemon, but not of a running one
+
+  if (::connect(fd_, reinterpret_cast<const sockaddr *>(&addr),
+                sizeof(addr)) == 0)
+  {
+    ::close(fd_);
+    throw rcdiscover::SocketException("Another daemon is listening on " +
+                                      path, EADDRINUSE);
+  }
+
+  ::unlink(path.c_str());
+
+  if (::bind(fd_, reinterpret_cast<const sockaddr *>(&addr),
+             sizeof(addr)) == -1 || ::listen(fd_, 64) == -1)
+  {
+    const int err = errno;
+    ::close(fd_);
+    throw rcdiscover::SocketException("Error while binding to " + path, err);
+  }
+
+  if (mode >= 0 && ::chmod(path.c_str(), static_cast<mode_t>(mode)) == -1)
+  {
+    const int err = errno;
+    ::close(fd_);
+    ::unlink(path.c_str());
+    throw rcdiscover::SocketException("Error while setting permissions of " +
+                                      path, err);
+  }
+
+  ::fcntl(fd_, F_SETFL, ::fcntl(fd_, F_GETFL, 0) | O_NONBLOCK);
+
+  // pipe for waking up process() if there are new events
+
+  if (::pipe(wakeup_) == -1)
+  {
+    const int err = errno;
+    ::close(fd_);
+    ::unlink(path.c_str());
+    throw rcdiscover::SocketException("Error while creating pipe", err);
+  }
+
+  for (const int fd : wakeup_)
+  {
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+  }
+}
+
+QueryServer::~QueryServer()
+{
+  // scan threads end with the discovery round
+
+  for (auto &scan : scans_)
+  {
+    scan.thread.join();
+  }
+
+  for (auto &client : clients_)
+  {
+    ::close(client.fd);
+  }
+
+  ::close(wakeup_[0]);
+  ::close(wakeup_[1]);
+  ::close(fd_);
+  ::unlink(path_.c_str());
+}
+
+void QueryServer::setDiscoverService(rcdiscover::DiscoverService *service)
+{
+  service_ = service;
+}
+
+void QueryServer::process(int timeout_ms)
+{
+  finishScans();
+
+  const size_t n = 2;
+  std::vector<pollfd> fds(clients_.size()+n);
+
+  fds[0].fd = fd_;
+  fds[0].events = POLLIN;
+  fds[0].revents = 0;
+
+  fds[1].fd = wakeup_[0];
+  fds[1].events = POLLIN;
+  fds[1].revents = 0;
+
+  for (size_t i = 0; i < clients_.size(); ++i)
+  {
+    // requests after a scan are not read before it is answered
+
+    fds[i+n].fd = clients_[i].fd;
+    fds[i+n].events = clients_[i].scanning ? 0 : POLLIN;
+    if (!clients_[i].out.empty())
+    {
+      fds[i+n].events |= POLLOUT;
+    }
+    fds[i+n].revents = 0;
+  }
+
+  if (::poll(fds.data(), fds.size(), timeout_ms) <= 0)
+  {
+    return;
+  }
+
+  const bool events = (fds[1].revents & POLLIN) != 0;
+  if (events)
+  {
+    char p[64];
+    while (::read(wakeup_[0], p, sizeof(p)) > 0)
+    { }
+  }
+
+  std::vector<bool> keep(clients_.size(), true);
+
+  for (size_t i = 0; i < clients_.size(); ++i)
+  {
+    const short ev = fds[i+n].revents;
+
+    if (ev & POLLIN)
+    {
+      keep[i] = readClient(clients_[i]);
+    }
+    else if (ev & (POLLHUP | POLLERR | POLLNVAL))
+    {
+      keep[i] = false;
+    }
+
+    if (keep[i] && events && clients_[i].subscribed)
+    {
+      keep[i] = sendEvents(clients_[i]);
+    }
+
+    if (keep[i] && !clients_[i].out.empty())
+    {
+      keep[i] = writeClient(clients_[i]);
+    }
+  }
+
+  for (size_t i = clients_.size(); i > 0; --i)
+  {
+    if (!keep[i-1])
+    {
+      ::close(clients_[i-1].fd);
+      clients_.erase(clients_.begin() + static_cast<std::ptrdiff_t>(i-1));
+    }
+  }
+
+  if (fds[0].revents & POLLIN)
+  {
+    acceptClient();
+  }
+}
+
+void QueryServer::acceptClient()
+{
+  while (true)
+  {
+    const int fd = ::accept(fd_, nullptr, nullptr);
+    if (fd == -1)
+    {
+      return;
+    }
+
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+
+    Client client;
+    client.id = next_id_++;
+    client.fd = fd;
+    client.subscribed = false;
+    client.scanning = false;
+    client.seq = 0;
+    clients_.push_back(client);
+  }
+}
+
+bool QueryServer::readClient(Client &client)
+{
+  char p[4096];
+  const ssize_t n = ::recv(client.fd, p, sizeof(p), 0);
+
+  if (n == 0)
+  {
+    return false;
+  }
+
+  if (n < 0)
+  {
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+  }
+
+  client.in.append(p, static_cast<size_t>(n));
+
+  return handleRequests(client);
+}
+
+bool QueryServer::handleRequests(Client &client)
+{
+  size_t pos;
+  while (!client.scanning && (pos = client.in.find('\n')) != std::string::npos)
+  {
+    std::string request = client.in.substr(0, pos);
+    client.in.erase(0, pos+1);
+
+    if (!request.empty() && request.back() == '\r')
+    {
+      request.pop_back();
+    }
+
+    // subscribers only receive events
+
+    if (client.subscribed)
+    {
+      continue;
+    }
+
+    if (request.compare(0, 9, "subscribe") == 0 &&
+        (request.size() == 9 || request[9] == ' '))
+    {
+      subscribe(client, request.size() > 10 ? request.substr(10) : "");
+
+      if (client.subscribed && !sendEvents(client))
+      {
+        return false;
+      }
+    }
+    else if (service_ && request.compare(0, 4, "scan") == 0 &&
+             (request.size() == 4 || request[4] == ' '))
+    {
+      startScan(client, request.size() > 5 ? request.substr(5) : "");
+    }
+    else
+    {
+      const std::string a = answer(request);
+
+      // drop clients that send requests without reading the answers, but
+      // accept one answer of any size
+
+      if (!client.out.empty() &&
+          client.out.size() + a.size() > MAX_PENDING_OUTPUT)
+      {
+        return false;
+      }
+
+      client.out += a;
+    }
+  }
+
+  if (!client.scanning && client.in.size() > MAX_REQUEST_LENGTH)
+  {
+    return false;
+  }
+
+  return true;
+}
+
+void QueryServer::notify()
+{
+  const char c = 0;
+  if (::write(wakeup_[1], &c, 1) < 0)
+  {
+    // pipe is full, i.e. process() will wake up anyway
+  }
+}
+
+void QueryServer::subscribe(Client &client, const std::string &arg)
+{
+  if (arg.empty())
+  {
+    client.seq = fleet_.getLastSequence();
+  }
+  else
+  {
+    const size_t sp = arg.find(' ');
+    const std::string seq = arg.substr(0, sp);
+    const std::string epoch = (sp == std::string::npos) ? "" : arg.substr(sp+1);
+
+    try
+    {
+      size_t pos;
+      client.seq = std::stoull(seq, &pos);
+
+      if (pos != seq.size())
+      {
+        throw std::invalid_argument(seq);
+      }
+    }
+    catch(const std::exception &)
+    {
+      client.out += "ERROR invalid sequence number\n\n";
+      return;
+    }
+
+    // events of a previous daemon cannot be resumed
+
+    if (sp != std::string::npos)
+    {
+      uint64_t e = 0;
+
+      try
+      {
+        size_t pos;
+        e = std::stoull(epoch, &pos);
+
+        if (pos != epoch.size())
+        {
+          throw std::invalid_argument(epoch);
+        }
+      }
+      catch(const std::exception &)
+      {
+        client.out += "ERROR invalid epoch\n\n";
+        return;
+      }
+
+      if (e != fleet_.getEpoch())
+      {
+        client.out += "ERROR events lost\n\n";
+        return;
+      }
+    }
+  }
+
+  client.subscribed = true;
+}
+
+void QueryServer::startScan(Client &client, const std::string &arg)
+{
+  uint64_t max_age = 0;
+
+  if (!arg.empty())
+  {
+    try
+    {
+      size_t pos;
+      max_age = std::stoull(arg, &pos);
+
+      if (pos != arg.size())
+      {
+        throw std::invalid_argument(arg);
+      }
+    }
+    catch(const std::exception &)
+    {
+      client.out += "ERROR invalid age\n\n";
+      return;
+    }
+  }
+
+  client.scanning = true;
+
+  std::lock_guard<std::mutex> lock(scan_mtx_);
+
+  scans_.emplace_back();
+  Scan &scan = scans_.back();
+  scan.client = client.id;
+  scan.done = false;
+
+  rcdiscover::DiscoverService *service = service_;
+  scan.thread = std::thread([this, &scan, service, max_age]
+  {
+    std::string answer;
+
+    try
+    {
+      answer = formatDevices(service->discover(
+        std::chrono::milliseconds(max_age)));
+    }
+    catch(const std::exception &ex)
+    {
+      answer = std::string("ERROR ") + ex.what() + "\n\n";
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(scan_mtx_);
+      scan.answer = answer;
+      scan.done = true;
+    }
+
+    notify();
+  });
+}
+
+void QueryServer::finishScans()
+{
+  std::vector<std::pair<uint64_t, std::string>> answers;
+
+  {
+    std::lock_guard<std::mutex> lock(scan_mtx_);
+
+    for (auto it = scans_.begin(); it != scans_.end();)
+    {
+      if (it->done)
+      {
+        it->thread.join();
+        answers.push_back(std::make_pair(it->client, it->answer));
+        it = scans_.erase(it);
+      }
+      else
+      {
+        ++it;
+      }
+    }
+  }
+
+  // clients may have disconnected in the meantime
+
+  for (const auto &answer : answers)
+  {
+    for (size_t i = 0; i < clients_.size(); ++i)
+    {
+      Client &client = clients_[i];
+      if (client.id != answer.first)
+      {
+        continue;
+      }
+
+      client.out += answer.second;
+      client.scanning = false;
+
+      if (!handleRequests(client))
+      {
+        ::close(client.fd);
+        clients_.erase(clients_.begin() + static_cast<std::ptrdiff_t>(i));
+      }
+
+      break;
+    }
+  }
+}
+
+bool QueryServer::sendEvents(Client &client)
+{
+  std::vector<rcdiscover::FleetEvent> events;
+
+  if (!fleet_.getEventsSince(client.seq, events))
+  {
+    client.out += "ERROR events lost\n\n";
+    client.subscribed = false;
+    return true;
+  }
+
+  for (const auto &event : events)
+  {
+    client.out += rcdiscover::formatEventRecord(event);
+    client.out += '\n';
+    client.seq = event.seq;
+  }
+
+  // drop subscribers that do not read their events
+
+  return client.out.size() <= MAX_PENDING_OUTPUT;
+}
+
+bool QueryServer::writeClient(Client &client)
+{
+  const ssize_t n = ::send(client.fd, client.out.data(), client.out.size(),
+                           MSG_NOSIGNAL);
+
+  if (n < 0)
+  {
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+  }
+
+  client.out.erase(0, static_cast<size_t>(n));
+  return true;
+}
+
+std::string QueryServer::answer(const std::string &request) const
+{
+  const size_t space = request.find(' ');
+  const std::string cmd = request.substr(0, space);
+  const std::string arg = (space == std::string::npos) ?
+                          std::string() : request.substr(space+1);
+
+  std::vector<rcdiscover::DeviceInfo> devices;
+
+  if (cmd == "list")
+  {
+    devices = fleet_.getDevices();
+  }
+  else if (cmd == "serial")
+  {
+    rcdiscover::DeviceInfo info;
+    if (fleet_.findBySerial(arg, info))
+    {
+      devices.push_back(info);
+    }
+  }
+  else if (cmd == "mac")
+  {
+    uint64_t mac = 0;
+
+    try
+    {
+      for (const uint8_t b : string2mac(arg))
+      {
+        mac = (mac << 8) | b;
+      }
+    }
+    catch(const std::exception &)
+    {
+      return "ERROR invalid MAC address\n\n";
+    }
+
+    rcdiscover::DeviceInfo info;
+    if (fleet_.findByMAC(mac, info))
+    {
+      devices.push_back(info);
+    }
+  }
+  else if (cmd == "name")
+  {
+    devices = fleet_.findByName(arg);
+  }
+  else
+  {
+    return "ERROR unknown request\n\n";
+  }
+
+  return formatDevices(devices);
+}
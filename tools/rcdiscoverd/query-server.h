@@ -0,0 +1,195 @@
+/*
+ * rcdiscover - the network discovery tool for rc_visard
+ *
+ * Copyright (c) 2017 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Raphael Schaller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef QUERYSERVER_H
+#define QUERYSERVER_H
+
+#include <string>
+#include <vector>
+#include <list>
+#include <thread>
+#include <mutex>
+#include <cstdint>
+
+namespace rcdiscover
+{
+class Fleet;
+class DiscoverService;
+}
+
+/**
+ * @brief Answers requests on a UNIX domain socket from the fleet table.
+ *
+ * The protocol is described at rcdiscover::DaemonClient.
+ */
+class QueryServer
+{
+  public:
+    /**
+     * @brief Constructor. Creates the socket and listens for clients.
+     * @param path path of the UNIX domain socket
+     * @param fleet fleet table from which requests are answered
+     * @param mode permissions of the socket, e.g. 0666 for allowing all
+     * local users to connect. If negative, the permissions are given by the
+     * umask.
+     * @throws SocketException if the socket cannot be created or another
+     * daemon is already listening on it
+     */
+    QueryServer(const std::string &path, const rcdiscover::Fleet &fleet,
+                int mode = -1);
+    ~QueryServer();
+
+    QueryServer(const QueryServer &) = delete;
+    QueryServer &operator=(const QueryServer &) = delete;
+
+    /**
+     * @brief Enables the request "scan [<max age in ms>]", which is answered
+     * like "list", but with the result of a discovery round that started at
+     * most the given time ago. By default, this is the round in progress or
+     * a new one. Clients that ask at the same time share one round, which
+     * is performed in a separate thread.
+     * @param service service that performs the rounds. It must exist until
+     * the destruction of the server.
+     */
+    void setDiscoverService(rcdiscover::DiscoverService *service);
+
+    /**
+     * @brief Waits for requests and answers them.
+     * @param timeout_ms maximum time to wait in milliseconds
+     */
+    void process(int timeout_ms);
+
+    /**
+     * @brief Wakes up process() for sending new events to subscribers. May
+     * be called from any thread.
+     */
+    void notify();
+
+  private:
+    struct Client
+    {
+      uint64_t id;
+      int fd;
+      std::string in;
+      std::string out;
+      bool subscribed;
+      bool scanning;
+      uint64_t seq;
+    };
+
+    struct Scan
+    {
+      uint64_t client;
+      std::thread thread;
+      bool done;
+      std::string answer;
+    };
+
+    /**
+     * @brief Accepts a new client.
+     */
+    void acceptClient();
+
+    /**
+     * @brief Reads available data and answers all complete requests.
+     * @param client client
+     * @return false if the client is to be disconnected
+     */
+    bool readClient(Client &client);
+
+    /**
+     * @brief Answers all complete requests that have been received. Stops
+     * at a scan request until its round is finished.
+     * @param client client
+     * @return false if the client is to be disconnected
+     */
+    bool handleRequests(Client &client);
+
+    /**
+     * @brief Writes as much pending data as possible.
+     * @param client client
+     * @return false if the client is to be disconnected
+     */
+    bool writeClient(Client &client);
+
+    /**
+     * @brief Computes the answer to a request.
+     * @param request request line
+     * @return answer including terminating empty line
+     */
+    std::string answer(const std::string &request) const;
+
+    /**
+     * @brief Handles a subscribe request.
+     * @param client client
+     * @param arg argument of the request
+     */
+    void subscribe(Client &client, const std::string &arg);
+
+    /**
+     * @brief Handles a scan request by starting a thread that waits for the
+     * result of the discovery service.
+     * @param client client
+     * @param arg argument of the request
+     */
+    void startScan(Client &client, const std::string &arg);
+
+    /**
+     * @brief Passes the answers of finished scan requests to their clients
+     * and continues with their next requests.
+     */
+    void finishScans();
+
+    /**
+     * @brief Queues all events that the subscriber has not seen yet.
+     * @param client subscribed client
+     * @return false if the client is to be disconnected
+     */
+    bool sendEvents(Client &client);
+
+  private:
+    std::string path_;
+    int fd_;
+    int wakeup_[2];
+    const rcdiscover::Fleet &fleet_;
+    rcdiscover::DiscoverService *service_;
+    uint64_t next_id_;
+    std::vector<Client> clients_;
+
+    std::mutex scan_mtx_;
+    std::list<Scan> scans_;
+};
+
+#endif // QUERYSERVER_H